@@ -97,7 +97,7 @@ typedef NS_ENUM(NSUInteger, Section) {
 #pragma mark - Table view data source
 
 - (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
-    return [[self mapper] dynamicSectionForStaticSection:SectionCount];
+    return [[self mapper] numberOfSectionsOfTotal:SectionCount];
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
@@ -22,6 +22,8 @@
 @property (nonatomic, strong, readwrite) NSArray *tree;
 @property (nonatomic, strong, readwrite) HRSIndexPathMapper *mapper;
 @property (nonatomic, strong, readwrite) NSIndexPath *baseIndexPath;
+/// the static indexes of all visible rows, in the order of the rows
+@property (nonatomic, strong, readwrite) NSArray *visibleIndexes;
 
 @end
 
@@ -61,14 +63,24 @@
 
 #pragma mark - Table view data source
 
+- (NSArray *)visibleIndexes {
+	if (_visibleIndexes == nil) {
+		// maps all rows in one pass instead of one lookup per row
+		NSMutableArray *visibleIndexes = [NSMutableArray arrayWithCapacity:self.tree.count];
+		[self.mapper enumerateVisibleIndexesAtIndexPath:(self.baseIndexPath ?: [NSIndexPath new]) total:self.tree.count usingBlock:^(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop) {
+			[visibleIndexes addObject:@(staticIndex)];
+		}];
+		_visibleIndexes = [visibleIndexes copy];
+	}
+	return _visibleIndexes;
+}
+
 - (NSIndexPath *)dataIndexPathForRow:(NSUInteger)row {
-	NSIndexPath *newIndexPath;
+	NSUInteger index = [self.visibleIndexes[row] unsignedIntegerValue];
 	if (self.baseIndexPath) {
-		newIndexPath = [[self.mapper dynamicIndexPathForStaticIndexPath:self.baseIndexPath] indexPathByAddingIndex:row];
-	} else {
-		newIndexPath = [NSIndexPath indexPathWithIndex:row];
+		return [self.baseIndexPath indexPathByAddingIndex:index];
 	}
-	return [self.mapper staticIndexPathForDynamicIndexPath:newIndexPath];
+	return [NSIndexPath indexPathWithIndex:index];
 }
 
 - (NSURL *)urlForRow:(NSUInteger)row {
@@ -87,8 +99,7 @@
 }
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
-	NSIndexPath *countIndexPath = (self.baseIndexPath ? [self.baseIndexPath indexPathByAddingIndex:self.tree.count] : [NSIndexPath indexPathWithIndex:self.tree.count]);
-    return [[self.mapper dynamicIndexPathForStaticIndexPath:countIndexPath] indexAtPosition:self.baseIndexPath.length];
+	return self.visibleIndexes.count;
 }
 
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
@@ -131,6 +142,7 @@
 			[[self mapper] setConditionForIndexPath:dataIndexPath condition:^BOOL{
 				return NO;
 			}];
+			self.visibleIndexes = nil;
 			[tableView deleteRowsAtIndexPaths:@[ indexPath ] withRowAnimation:UITableViewRowAnimationAutomatic];
 		}];
 		[actions addObject:delete];
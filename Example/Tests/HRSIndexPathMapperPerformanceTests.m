@@ -0,0 +1,313 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+
+#import <HRSAdvancedTableViews/HRSIndexPathMapping.h>
+
+#import "HRSPerformanceTestCase.h"
+
+
+static NSUInteger const HRSIndexPathMapperPerformanceQueryCount = 1000;
+static uint32_t const HRSIndexPathMapperPerformanceSeed = 42;
+
+
+@interface HRSIndexPathMapperPerformanceTests : HRSPerformanceTestCase
+
+@end
+
+
+@implementation HRSIndexPathMapperPerformanceTests
+
+#pragma mark - fixtures
+
+/// The shapes of the trees, as pairs of width and depth. The number of leaves
+/// grows with width^depth, so wide trees are only measured with a low depth.
+- (NSArray *)treeShapes {
+	return @[ @[ @10, @1 ], @[ @100, @1 ], @[ @1000, @1 ], @[ @10, @2 ], @[ @100, @2 ], @[ @10, @3 ], @[ @30, @3 ] ];
+}
+
+- (NSArray *)conditionDensities {
+	return @[ @0.1, @0.5, @1.0 ];
+}
+
+/// Creates the index paths of every node in a tree of the given shape that
+/// carries a condition, sorted ascending.
+- (NSArray *)conditionIndexPathsForWidth:(NSUInteger)width depth:(NSUInteger)depth density:(double)density {
+	uint32_t state = HRSIndexPathMapperPerformanceSeed;
+	uint32_t threshold = (uint32_t)(density * (1 << 24));
+	
+	NSMutableArray *indexPaths = [NSMutableArray array];
+	NSMutableArray *parents = [NSMutableArray arrayWithObject:[NSNull null]];
+	for (NSUInteger level = 0; level < depth; level++) {
+		NSMutableArray *children = [NSMutableArray arrayWithCapacity:parents.count * width];
+		for (id parent in parents) {
+			for (NSUInteger index = 0; index < width; index++) {
+				NSIndexPath *indexPath = (parent == [NSNull null] ? [NSIndexPath indexPathWithIndex:index] : [parent indexPathByAddingIndex:index]);
+				[children addObject:indexPath];
+				if (HRSPerformanceRandom(&state) < threshold) {
+					[indexPaths addObject:indexPath];
+				}
+			}
+		}
+		parents = children;
+	}
+	return indexPaths;
+}
+
+- (HRSIndexPathMapper *)mapperWithConditionsAtIndexPaths:(NSArray *)indexPaths {
+	HRSIndexPathMapper *mapper = [HRSIndexPathMapper new];
+	uint32_t state = HRSIndexPathMapperPerformanceSeed;
+	for (NSIndexPath *indexPath in indexPaths) {
+		// roughly every third condition hides its index path
+		BOOL visible = (HRSPerformanceRandom(&state) % 3 != 0);
+		[mapper setConditionForIndexPath:indexPath condition:^BOOL{
+			return visible;
+		}];
+	}
+	return mapper;
+}
+
+- (NSArray *)queryIndexPathsForWidth:(NSUInteger)width depth:(NSUInteger)depth {
+	uint32_t state = HRSIndexPathMapperPerformanceSeed + 1;
+	NSMutableArray *indexPaths = [NSMutableArray arrayWithCapacity:HRSIndexPathMapperPerformanceQueryCount];
+	NSUInteger indexes[depth];
+	for (NSUInteger query = 0; query < HRSIndexPathMapperPerformanceQueryCount; query++) {
+		for (NSUInteger level = 0; level < depth; level++) {
+			indexes[level] = HRSPerformanceRandom(&state) % width;
+		}
+		[indexPaths addObject:[NSIndexPath indexPathWithIndexes:indexes length:depth]];
+	}
+	return indexPaths;
+}
+
+- (NSDictionary *)parametersForWidth:(NSUInteger)width depth:(NSUInteger)depth density:(double)density snapshot:(BOOL)snapshot {
+	return @{ @"width": @(width), @"depth": @(depth), @"density": @(density), @"snapshot": @(snapshot) };
+}
+
+
+
+#pragma mark - mapping
+
+- (void)testMappingAcrossTreeShapes {
+	for (NSArray *shape in [self treeShapes]) {
+		NSUInteger width = [shape[0] unsignedIntegerValue];
+		NSUInteger depth = [shape[1] unsignedIntegerValue];
+		NSArray *queries = [self queryIndexPathsForWidth:width depth:depth];
+		
+		for (NSNumber *density in [self conditionDensities]) {
+			NSArray *conditionIndexPaths = [self conditionIndexPathsForWidth:width depth:depth density:density.doubleValue];
+			HRSIndexPathMapper *mapper = [self mapperWithConditionsAtIndexPaths:conditionIndexPaths];
+			
+			for (NSNumber *snapshot in @[ @NO, @YES ]) {
+				mapper.snapshotEnabled = snapshot.boolValue;
+				NSDictionary *parameters = [self parametersForWidth:width depth:depth density:density.doubleValue snapshot:snapshot.boolValue];
+				
+				[self benchmark:@"dynamicIndexPathForStaticIndexPath" parameters:parameters operations:queries.count block:^{
+					for (NSIndexPath *indexPath in queries) {
+						[mapper dynamicIndexPathForStaticIndexPath:indexPath];
+					}
+				}];
+				
+				[self benchmark:@"staticIndexPathForDynamicIndexPath" parameters:parameters operations:queries.count block:^{
+					for (NSIndexPath *indexPath in queries) {
+						[mapper staticIndexPathForDynamicIndexPath:indexPath];
+					}
+				}];
+				
+				[self benchmark:@"dynamicIndexPathsForStaticIndexPaths" parameters:parameters operations:queries.count block:^{
+					[mapper dynamicIndexPathsForStaticIndexPaths:queries];
+				}];
+			}
+			
+			// immutable snapshots are always evaluated up front
+			HRSIndexPathMapperSnapshot *snapshot = [mapper snapshot];
+			NSDictionary *parameters = [self parametersForWidth:width depth:depth density:density.doubleValue snapshot:YES];
+			[self benchmark:@"immutableSnapshotDynamicIndexPathForStaticIndexPath" parameters:parameters operations:queries.count block:^{
+				for (NSIndexPath *indexPath in queries) {
+					[snapshot dynamicIndexPathForStaticIndexPath:indexPath];
+				}
+			}];
+		}
+	}
+}
+
+- (void)testPerformanceOfDynamicMapping {
+	NSArray *queries = [self queryIndexPathsForWidth:100 depth:2];
+	HRSIndexPathMapper *mapper = [self mapperWithConditionsAtIndexPaths:[self conditionIndexPathsForWidth:100 depth:2 density:0.5]];
+	
+	[self measureBlock:^{
+		for (NSIndexPath *indexPath in queries) {
+			[mapper dynamicIndexPathForStaticIndexPath:indexPath];
+		}
+	}];
+}
+
+
+
+#pragma mark - range conditions
+
+- (void)testMappingWithRangeConditions {
+	NSUInteger rows = 1000;
+	uint32_t state = HRSIndexPathMapperPerformanceSeed;
+	NSMutableArray *queries = [NSMutableArray arrayWithCapacity:HRSIndexPathMapperPerformanceQueryCount];
+	for (NSUInteger query = 0; query < HRSIndexPathMapperPerformanceQueryCount; query++) {
+		NSUInteger indexes[] = { HRSPerformanceRandom(&state) % 10, HRSPerformanceRandom(&state) % rows };
+		[queries addObject:[NSIndexPath indexPathWithIndexes:indexes length:2]];
+	}
+	
+	// every other block of ten rows is hidden, once as single conditions and once as ranges
+	HRSIndexPathMapper *singleMapper = [HRSIndexPathMapper new];
+	HRSIndexPathMapper *rangeMapper = [HRSIndexPathMapper new];
+	for (NSUInteger section = 0; section < 10; section++) {
+		for (NSUInteger row = 0; row < rows; row += 20) {
+			[rangeMapper setConditionForIndexRange:NSMakeRange(row, 10) atIndexPath:[NSIndexPath indexPathWithIndex:section] condition:^BOOL{
+				return NO;
+			}];
+			for (NSUInteger offset = 0; offset < 10; offset++) {
+				NSUInteger indexes[] = { section, row + offset };
+				[singleMapper setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2] condition:^BOOL{
+					return NO;
+				}];
+			}
+		}
+	}
+	
+	NSDictionary *mappers = @{ @"single": singleMapper, @"range": rangeMapper };
+	for (NSString *kind in mappers) {
+		HRSIndexPathMapper *mapper = mappers[kind];
+		NSDictionary *parameters = @{ @"rows": @(rows), @"conditions": kind };
+		
+		[self benchmark:@"rangeDynamicIndexPathForStaticIndexPath" parameters:parameters operations:queries.count block:^{
+			for (NSIndexPath *indexPath in queries) {
+				[mapper dynamicIndexPathForStaticIndexPath:indexPath];
+			}
+		}];
+	}
+}
+
+
+
+#pragma mark - enumeration
+
+- (void)testEnumeratingVisibleIndexes {
+	NSUInteger width = 1000;
+	HRSIndexPathMapper *mapper = [self mapperWithConditionsAtIndexPaths:[self conditionIndexPathsForWidth:width depth:1 density:0.5]];
+	NSUInteger visibleCount = [mapper numberOfVisibleIndexesOfTotal:width atIndexPath:[NSIndexPath new]];
+	NSDictionary *parameters = [self parametersForWidth:width depth:1 density:0.5 snapshot:NO];
+	
+	[self benchmark:@"staticIndexPathForDynamicIndexPathPerRow" parameters:parameters operations:visibleCount block:^{
+		for (NSUInteger row = 0; row < visibleCount; row++) {
+			[mapper staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:row]];
+		}
+	}];
+	
+	[self benchmark:@"enumerateVisibleIndexes" parameters:parameters operations:visibleCount block:^{
+		[mapper enumerateVisibleIndexesAtIndexPath:[NSIndexPath new] total:width usingBlock:^(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop) {
+		}];
+	}];
+}
+
+
+
+#pragma mark - incremental snapshots
+
+- (void)testFlippingSingleConditions {
+	for (NSNumber *widthNumber in @[ @100, @1000, @10000 ]) {
+		NSUInteger width = widthNumber.unsignedIntegerValue;
+		BOOL *flags = calloc(width, sizeof(BOOL));
+		HRSIndexPathMapper *mapper = [HRSIndexPathMapper new];
+		for (NSUInteger index = 0; index < width; index++) {
+			[mapper setConditionForIndexPath:[NSIndexPath indexPathWithIndex:index] condition:^BOOL{
+				return flags[index];
+			}];
+		}
+		mapper.snapshotEnabled = YES;
+		
+		// every flip invalidates one condition and maps the last visible row
+		uint32_t state = HRSIndexPathMapperPerformanceSeed;
+		NSUInteger flips = HRSIndexPathMapperPerformanceQueryCount;
+		NSDictionary *parameters = [self parametersForWidth:width depth:1 density:1.0 snapshot:YES];
+		[self benchmark:@"flipSingleCondition" parameters:parameters operations:flips block:^{
+			uint32_t flipState = state;
+			for (NSUInteger flip = 0; flip < flips; flip++) {
+				NSUInteger index = HRSPerformanceRandom(&flipState) % width;
+				flags[index] = !flags[index];
+				[mapper invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:index]];
+				[mapper staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:0]];
+			}
+		}];
+		
+		// the conditions are never evaluated again
+		free(flags);
+	}
+}
+
+
+
+#pragma mark - configuration
+
+- (void)testConditionRegistrationAcrossTreeShapes {
+	for (NSArray *shape in [self treeShapes]) {
+		NSUInteger width = [shape[0] unsignedIntegerValue];
+		NSUInteger depth = [shape[1] unsignedIntegerValue];
+		
+		for (NSNumber *density in [self conditionDensities]) {
+			NSArray *conditionIndexPaths = [self conditionIndexPathsForWidth:width depth:depth density:density.doubleValue];
+			if (conditionIndexPaths.count == 0) {
+				continue;
+			}
+			NSDictionary *parameters = [self parametersForWidth:width depth:depth density:density.doubleValue snapshot:NO];
+			
+			[self benchmark:@"setConditionForIndexPath" parameters:parameters operations:conditionIndexPaths.count block:^{
+				[self mapperWithConditionsAtIndexPaths:conditionIndexPaths];
+			}];
+			
+			NSMutableDictionary *conditions = [NSMutableDictionary dictionaryWithCapacity:conditionIndexPaths.count];
+			for (NSIndexPath *indexPath in conditionIndexPaths) {
+				conditions[indexPath] = ^BOOL{
+					return NO;
+				};
+			}
+			[self benchmark:@"setConditions" parameters:parameters operations:conditionIndexPaths.count block:^{
+				[[HRSIndexPathMapper new] setConditions:conditions evaluationObject:nil];
+			}];
+			
+			[self benchmark:@"removeConditionForIndexPath" parameters:parameters operations:conditionIndexPaths.count setup:^id{
+				return [self mapperWithConditionsAtIndexPaths:conditionIndexPaths];
+			} block:^(HRSIndexPathMapper *mapper) {
+				for (NSIndexPath *indexPath in conditionIndexPaths.reverseObjectEnumerator) {
+					[mapper removeConditionForIndexPath:indexPath descendant:NO];
+				}
+			}];
+			
+			[self benchmark:@"removeConditionsForIndexPaths" parameters:parameters operations:conditionIndexPaths.count setup:^id{
+				return [self mapperWithConditionsAtIndexPaths:conditionIndexPaths];
+			} block:^(HRSIndexPathMapper *mapper) {
+				[mapper removeConditionsForIndexPaths:conditionIndexPaths descendant:NO];
+			}];
+		}
+	}
+}
+
+- (void)testPerformanceOfConditionRegistration {
+	NSArray *conditionIndexPaths = [self conditionIndexPathsForWidth:100 depth:2 density:0.5];
+	
+	[self measureBlock:^{
+		[self mapperWithConditionsAtIndexPaths:conditionIndexPaths];
+	}];
+}
+
+@end
@@ -0,0 +1,172 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+
+#import <HRSAdvancedTableViews/HRSIndexPathMapping.h>
+
+
+@interface HRSIndexPathMapperSnapshotTests : XCTestCase
+
+@property (nonatomic, strong, readwrite) HRSIndexPathMapper *mapper;
+@property (nonatomic, assign, readwrite) BOOL nestedVisible;
+
+@end
+
+
+@implementation HRSIndexPathMapperSnapshotTests
+
+- (void)setUp {
+	[super setUp];
+	
+	self.mapper = [HRSIndexPathMapper new];
+	self.nestedVisible = NO;
+	
+	for (NSNumber *index in @[ @1, @4, @5 ]) {
+		[self.mapper setConditionForIndexPath:[NSIndexPath indexPathWithIndex:index.unsignedIntegerValue] condition:^BOOL{
+			return NO;
+		}];
+	}
+	__weak HRSIndexPathMapperSnapshotTests *weakSelf = self;
+	NSUInteger indexes[] = { 2, 3 };
+	[self.mapper setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2] condition:^BOOL{
+		return weakSelf.nestedVisible;
+	}];
+}
+
+- (void)tearDown {
+	self.mapper = nil;
+	
+	[super tearDown];
+}
+
+- (NSArray *)indexPathsWithWidth:(NSUInteger)width {
+	NSMutableArray *indexPaths = [NSMutableArray array];
+	for (NSUInteger section = 0; section < width; section++) {
+		for (NSUInteger row = 0; row < width; row++) {
+			NSUInteger indexes[] = { section, row };
+			[indexPaths addObject:[NSIndexPath indexPathWithIndexes:indexes length:2]];
+		}
+	}
+	return indexPaths;
+}
+
+
+
+#pragma mark - mapping
+
+- (void)testSnapshotMappingMatchesMapper {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	
+	for (NSIndexPath *indexPath in [self indexPathsWithWidth:8]) {
+		expect([snapshot dynamicIndexPathForStaticIndexPath:indexPath]).to.equal([self.mapper dynamicIndexPathForStaticIndexPath:indexPath]);
+		expect([snapshot staticIndexPathForDynamicIndexPath:indexPath]).to.equal([self.mapper staticIndexPathForDynamicIndexPath:indexPath]);
+	}
+}
+
+- (void)testSnapshotBatchMappingMatchesMapper {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	NSArray *indexPaths = [self indexPathsWithWidth:8];
+	
+	expect([snapshot dynamicIndexPathsForStaticIndexPaths:indexPaths]).to.equal([self.mapper dynamicIndexPathsForStaticIndexPaths:indexPaths]);
+	expect([snapshot staticIndexPathsForDynamicIndexPaths:indexPaths]).to.equal([self.mapper staticIndexPathsForDynamicIndexPaths:indexPaths]);
+}
+
+- (void)testSnapshotCountingMatchesMapper {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	
+	for (NSUInteger total = 0; total < 8; total++) {
+		expect([snapshot numberOfVisibleIndexesOfTotal:total atIndexPath:[NSIndexPath new]]).to.equal([self.mapper numberOfVisibleIndexesOfTotal:total atIndexPath:[NSIndexPath new]]);
+		for (NSUInteger section = 0; section < 8; section++) {
+			NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+			expect([snapshot numberOfVisibleIndexesOfTotal:total atIndexPath:indexPath]).to.equal([self.mapper numberOfVisibleIndexesOfTotal:total atIndexPath:indexPath]);
+		}
+	}
+}
+
+- (void)testSnapshotEnumerationMatchesMapper {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	
+	for (NSUInteger section = 0; section < 8; section++) {
+		NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+		expect([snapshot visibleIndexesAtIndexPath:indexPath total:8]).to.equal([self.mapper visibleIndexesAtIndexPath:indexPath total:8]);
+	}
+	expect([snapshot visibleIndexesAtIndexPath:[NSIndexPath new] total:8]).to.equal([self.mapper visibleIndexesAtIndexPath:[NSIndexPath new] total:8]);
+}
+
+- (void)testSnapshotDoesNotChangeWithConditions {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	NSUInteger indexes[] = { 2, 5 };
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndexes:indexes length:2];
+	NSIndexPath *dynamicIndexPath = [snapshot dynamicIndexPathForStaticIndexPath:indexPath];
+	
+	self.nestedVisible = YES;
+	[self.mapper removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] descendant:NO];
+	
+	expect([snapshot dynamicIndexPathForStaticIndexPath:indexPath]).to.equal(dynamicIndexPath);
+	expect([[self.mapper snapshot] dynamicIndexPathForStaticIndexPath:indexPath]).notTo.equal(dynamicIndexPath);
+}
+
+- (void)testSnapshotCanBeUsedOnBackgroundQueue {
+	HRSIndexPathMapperSnapshot *snapshot = [self.mapper snapshot];
+	NSArray *indexPaths = [self indexPathsWithWidth:8];
+	NSArray *expectedIndexPaths = [self.mapper dynamicIndexPathsForStaticIndexPaths:indexPaths];
+	
+	__block NSArray *mappedIndexPaths;
+	XCTestExpectation *expectation = [self expectationWithDescription:@"mapping"];
+	dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		mappedIndexPaths = [snapshot dynamicIndexPathsForStaticIndexPaths:indexPaths];
+		[expectation fulfill];
+	});
+	[self waitForExpectationsWithTimeout:1.0 handler:nil];
+	
+	expect(mappedIndexPaths).to.equal(expectedIndexPaths);
+}
+
+
+
+#pragma mark - diff
+
+- (void)testChangesBetweenSnapshotsMatchPerformUpdates {
+	HRSIndexPathMapperSnapshot *oldSnapshot = [self.mapper snapshot];
+	
+	__block NSArray *expectedDeleted;
+	__block NSArray *expectedInserted;
+	[self.mapper performUpdates:^{
+		self.nestedVisible = YES;
+		[self.mapper removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:4] descendant:NO];
+		[self.mapper setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+			return NO;
+		}];
+	} changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		expectedDeleted = deletedIndexPaths;
+		expectedInserted = insertedIndexPaths;
+	}];
+	HRSIndexPathMapperSnapshot *newSnapshot = [self.mapper snapshot];
+	
+	__block NSArray *deleted;
+	__block NSArray *inserted;
+	[oldSnapshot changesToSnapshot:newSnapshot changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		deleted = deletedIndexPaths;
+		inserted = insertedIndexPaths;
+	}];
+	
+	expect(deleted).to.equal(expectedDeleted);
+	expect(inserted).to.equal(expectedInserted);
+	expect(deleted).to.equal(@[ [NSIndexPath indexPathWithIndex:0] ]);
+	expect(inserted.count).to.equal(2);
+}
+
+@end
@@ -116,4 +116,88 @@
 	expect(movedMapped.row).to.equal(4);
 }
 
+- (void)testHideRowRangeAndCheckRow {
+	[self.sut setConditionForRowRange:NSMakeRange(20, 480) inSection:3 condition:^BOOL{
+		return NO;
+	}];
+	
+	NSIndexPath *untouched = [NSIndexPath indexPathForRow:19 inSection:3];
+	expect([self.sut dynamicIndexPathForStaticIndexPath:untouched]).to.equal(untouched);
+	
+	NSIndexPath *notFound = [NSIndexPath indexPathForRow:250 inSection:3];
+	NSIndexPath *notFoundMapped = [self.sut dynamicIndexPathForStaticIndexPath:notFound];
+	expect(notFoundMapped.section).to.equal(3);
+	expect(notFoundMapped.row).to.equal(NSNotFound);
+	
+	NSIndexPath *moved = [NSIndexPath indexPathForRow:500 inSection:3];
+	NSIndexPath *movedMapped = [self.sut dynamicIndexPathForStaticIndexPath:moved];
+	expect(movedMapped.row).to.equal(20);
+	
+	[self.sut removeConditionForRowRange:NSMakeRange(0, 1000) inSection:3];
+	expect([self.sut dynamicIndexPathForStaticIndexPath:moved]).to.equal(moved);
+}
+
+
+
+#pragma mark - counting tests
+
+- (void)testCountingRowsAndSections {
+	[self.sut setConditionForSection:1 condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForRow:0 inSection:2 condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForRowRange:NSMakeRange(5, 10) inSection:2 condition:^BOOL{
+		return NO;
+	}];
+	
+	expect([self.sut numberOfSectionsOfTotal:3]).to.equal(2);
+	expect([self.sut numberOfRowsInSection:0 total:4]).to.equal(4);
+	expect([self.sut numberOfRowsInSection:1 total:4]).to.equal(0);
+	expect([self.sut numberOfRowsInSection:2 total:20]).to.equal(9);
+	expect([self.sut numberOfRowsInSection:2 total:8]).to.equal(4);
+}
+
+
+
+#pragma mark - update tests
+
+- (void)testPerformUpdatesAnimatesTableView {
+	__block BOOL sectionVisible = YES;
+	__block BOOL rowVisible = NO;
+	[self.sut setConditionForSection:1 condition:^BOOL{
+		return sectionVisible;
+	}];
+	[self.sut setConditionForRow:3 inSection:2 condition:^BOOL{
+		return rowVisible;
+	}];
+	
+	id tableViewMock = OCMClassMock([UITableView class]);
+	[[tableViewMock expect] beginUpdates];
+	[[tableViewMock expect] deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationFade];
+	[[tableViewMock expect] insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:3 inSection:1] ] withRowAnimation:UITableViewRowAnimationFade];
+	[[tableViewMock expect] endUpdates];
+	
+	[self.sut performUpdates:^{
+		sectionVisible = NO;
+		rowVisible = YES;
+	} tableView:tableViewMock rowAnimation:UITableViewRowAnimationFade];
+	
+	[tableViewMock verify];
+}
+
+- (void)testPerformUpdatesWithoutChangesDoesNotTouchTableView {
+	[self.sut setConditionForSection:1 condition:^BOOL{
+		return NO;
+	}];
+	
+	id tableViewMock = OCMClassMock([UITableView class]);
+	[[tableViewMock reject] beginUpdates];
+	
+	[self.sut performUpdates:nil tableView:tableViewMock rowAnimation:UITableViewRowAnimationFade];
+	
+	[tableViewMock verify];
+}
+
 @end
@@ -18,6 +18,57 @@
 #import <HRSAdvancedTableViews/HRSIndexPathMapping.h>
 
 
+@interface HRSIndexPathMapperTestsPerson : NSObject
+
+@property (nonatomic, assign, readwrite) NSInteger age;
+@property (nonatomic, assign, readwrite) BOOL member;
+
+@end
+
+
+@implementation HRSIndexPathMapperTestsPerson
+
+@end
+
+
+/// An instrumentation that records the index paths of all evaluated conditions.
+@interface HRSIndexPathMapperTestsInstrumentation : NSObject <HRSIndexPathMapperInstrumentation>
+
+@property (nonatomic, strong, readwrite) NSMutableArray *evaluatedIndexPaths;
+@property (nonatomic, strong, readwrite) NSMutableArray *results;
+
+@end
+
+
+@implementation HRSIndexPathMapperTestsInstrumentation
+
+- (instancetype)init {
+	self = [super init];
+	if (self) {
+		_evaluatedIndexPaths = [NSMutableArray array];
+		_results = [NSMutableArray array];
+	}
+	return self;
+}
+
+- (void)indexPathMapper:(HRSIndexPathMapper *)mapper didEvaluateConditionForIndexPath:(NSIndexPath *)indexPath result:(BOOL)result duration:(NSTimeInterval)duration {
+	[self.evaluatedIndexPaths addObject:indexPath];
+	[self.results addObject:@(result)];
+}
+
+@end
+
+
+/// The private node of the mapper, declared to reach its deprecated initializer.
+@interface HRSIndexPathMapperNode : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger length;
+
+- (instancetype)initWithIndex:(NSUInteger)index condition:(BOOL(^)(void))condition;
+
+@end
+
+
 @interface HRSIndexPathMapperTests : XCTestCase
 
 @property (nonatomic, strong, readwrite) HRSIndexPathMapper *sut;
@@ -138,4 +189,745 @@
 	expect(nilIndexPath).to.beNil();
 }
 
+- (void)testSettingConditionsInAnyOrder {
+	for (NSNumber *index in @[ @5, @1, @3, @0 ]) {
+		[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:index.unsignedIntegerValue] condition:^BOOL{
+			return (index.unsignedIntegerValue == 0);
+		}];
+	}
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(2);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:6]] indexAtPosition:0]).to.equal(3);
+	expect([[self.sut staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(2);
+	
+	[self.sut removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:3] descendant:YES];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(3);
+}
+
+- (void)testSettingNullConditionRemovesCondition {
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:0];
+	[self.sut setConditionForIndexPath:indexPath condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexPath:indexPath condition:NULL];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(0);
+}
+
+- (void)testRemovingNestedCondition {
+	NSUInteger indexes[] = { 1, 1 };
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndexes:indexes length:2];
+	[self.sut setConditionForIndexPath:indexPath condition:^BOOL{
+		return NO;
+	}];
+	
+	[self.sut removeConditionForIndexPath:indexPath descendant:NO];
+	NSIndexPath *mapped = [self.sut dynamicIndexPathForStaticIndexPath:indexPath];
+	expect(mapped).to.equal(indexPath);
+}
+
+
+
+#pragma mark - condition evaluation
+
+- (void)testConstantPredicates {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] predicate:[NSPredicate predicateWithValue:NO] evaluationObject:self];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] predicate:[NSPredicate predicateWithValue:YES] evaluationObject:self];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:0]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(0);
+}
+
+- (void)testBooleanKeyPredicates {
+	HRSIndexPathMapperTestsPerson *person = [HRSIndexPathMapperTestsPerson new];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] predicate:[NSPredicate predicateWithFormat:@"member == YES"] evaluationObject:person];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] predicate:[NSPredicate predicateWithFormat:@"member != YES"] evaluationObject:person];
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:2];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:0]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(0);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	
+	person.member = YES;
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:0]] indexAtPosition:0]).to.equal(0);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+}
+
+- (void)testBooleanKeyPredicateOnObjectWithoutGetter {
+	NS_VALID_UNTIL_END_OF_SCOPE NSMutableDictionary *person = [NSMutableDictionary dictionary];
+	person[@"member"] = @NO;
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:0];
+	[self.sut setConditionForIndexPath:indexPath predicate:[NSPredicate predicateWithFormat:@"member == YES"] evaluationObject:person];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(NSNotFound);
+	
+	person[@"member"] = @YES;
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(0);
+}
+
+
+
+#pragma mark - bulk configuration
+
+- (void)testSettingConditionsInBulk {
+	HRSIndexPathMapperTestsPerson *person = [HRSIndexPathMapperTestsPerson new];
+	person.age = 32;
+	
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:4] condition:^BOOL{
+		return NO;
+	}];
+	
+	NSUInteger rowIndexes[] = { 2, 1 };
+	NSDictionary *conditions = @{
+		[NSIndexPath indexPathWithIndex:3]: ^BOOL{ return NO; },
+		[NSIndexPath indexPathWithIndex:1]: [NSPredicate predicateWithFormat:@"age > 32"],
+		[NSIndexPath indexPathWithIndexes:rowIndexes length:2]: ^BOOL{ return NO; },
+		[NSIndexPath indexPathWithIndex:2]: ^BOOL{ return YES; },
+	};
+	[self.sut setConditions:conditions evaluationObject:person];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:5]] indexAtPosition:0]).to.equal(2);
+	
+	NSUInteger staticIndexes[] = { 2, 3 };
+	NSIndexPath *dynamicIndexPath = [self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndexes:staticIndexes length:2]];
+	expect([dynamicIndexPath indexAtPosition:0]).to.equal(1);
+	expect([dynamicIndexPath indexAtPosition:1]).to.equal(2);
+	
+	person.age = 33;
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:5]] indexAtPosition:0]).to.equal(3);
+}
+
+- (void)testRemovingConditionsInBulk {
+	NSUInteger rowIndexes[] = { 2, 1 };
+	NSIndexPath *rowIndexPath = [NSIndexPath indexPathWithIndexes:rowIndexes length:2];
+	NSDictionary *conditions = @{
+		[NSIndexPath indexPathWithIndex:1]: ^BOOL{ return NO; },
+		[NSIndexPath indexPathWithIndex:2]: ^BOOL{ return YES; },
+		[NSIndexPath indexPathWithIndex:3]: ^BOOL{ return NO; },
+		rowIndexPath: ^BOOL{ return NO; },
+	};
+	[self.sut setConditions:conditions evaluationObject:nil];
+	
+	[self.sut removeConditionsForIndexPaths:@[ [NSIndexPath indexPathWithIndex:3], rowIndexPath, [NSIndexPath indexPathWithIndex:7] ] descendant:NO];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(3);
+	NSIndexPath *row = [self.sut dynamicIndexPathForStaticIndexPath:rowIndexPath];
+	expect([row indexAtPosition:0]).to.equal(1);
+	expect([row indexAtPosition:1]).to.equal(1);
+	
+	[self.sut removeConditionsForIndexPaths:@[ [NSIndexPath indexPathWithIndex:1] ] descendant:YES];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(4);
+}
+
+
+
+#pragma mark - batch mapping
+
+- (void)configureBatchConditions {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return NO;
+	}];
+	NSUInteger hiddenRow[] = { 2, 1 };
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:hiddenRow length:2] condition:^BOOL{
+		return NO;
+	}];
+	NSUInteger visibleRow[] = { 2, 3 };
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:visibleRow length:2] condition:^BOOL{
+		return YES;
+	}];
+}
+
+- (NSArray *)batchIndexPaths {
+	NSMutableArray *indexPaths = [NSMutableArray array];
+	for (NSUInteger section = 0; section < 4; section++) {
+		for (NSUInteger row = 0; row < 5; row++) {
+			NSUInteger indexes[] = { section, row };
+			[indexPaths addObject:[NSIndexPath indexPathWithIndexes:indexes length:2]];
+		}
+	}
+	return indexPaths;
+}
+
+- (void)testBatchMappingMatchesSingleMapping {
+	[self configureBatchConditions];
+	
+	NSArray *indexPaths = [self batchIndexPaths];
+	NSArray *dynamicIndexPaths = [self.sut dynamicIndexPathsForStaticIndexPaths:indexPaths];
+	NSArray *staticIndexPaths = [self.sut staticIndexPathsForDynamicIndexPaths:indexPaths];
+	
+	expect(dynamicIndexPaths).to.haveCountOf(indexPaths.count);
+	expect(staticIndexPaths).to.haveCountOf(indexPaths.count);
+	[indexPaths enumerateObjectsUsingBlock:^(NSIndexPath *indexPath, NSUInteger idx, BOOL *stop) {
+		expect(dynamicIndexPaths[idx]).to.equal([self.sut dynamicIndexPathForStaticIndexPath:indexPath]);
+		expect(staticIndexPaths[idx]).to.equal([self.sut staticIndexPathForDynamicIndexPath:indexPath]);
+	}];
+}
+
+- (void)testBatchMappingUnsortedIndexPaths {
+	[self configureBatchConditions];
+	
+	NSArray *indexPaths = [[[self batchIndexPaths] reverseObjectEnumerator] allObjects];
+	NSArray *dynamicIndexPaths = [self.sut dynamicIndexPathsForStaticIndexPaths:indexPaths];
+	NSArray *staticIndexPaths = [self.sut staticIndexPathsForDynamicIndexPaths:indexPaths];
+	
+	[indexPaths enumerateObjectsUsingBlock:^(NSIndexPath *indexPath, NSUInteger idx, BOOL *stop) {
+		expect(dynamicIndexPaths[idx]).to.equal([self.sut dynamicIndexPathForStaticIndexPath:indexPath]);
+		expect(staticIndexPaths[idx]).to.equal([self.sut staticIndexPathForDynamicIndexPath:indexPath]);
+	}];
+}
+
+- (void)testBatchMappingIntoBuffer {
+	[self configureBatchConditions];
+	
+	NSUInteger staticStorage[] = { 0, 4, 1, 0, 2, 1, 2, 2, 3, 0 };
+	NSUInteger *indexes = staticStorage;
+	[self.sut mapStaticIndexes:indexes count:5 length:2];
+	
+	expect(indexes[0]).to.equal(0);
+	expect(indexes[1]).to.equal(4);
+	expect(indexes[2]).to.equal(NSNotFound);
+	expect(indexes[3]).to.equal(NSNotFound);
+	expect(indexes[4]).to.equal(1);
+	expect(indexes[5]).to.equal(NSNotFound);
+	expect(indexes[6]).to.equal(1);
+	expect(indexes[7]).to.equal(1);
+	expect(indexes[8]).to.equal(2);
+	expect(indexes[9]).to.equal(0);
+	
+	NSUInteger dynamicStorage[] = { 1, 1, 2, 0 };
+	NSUInteger *dynamicIndexes = dynamicStorage;
+	[self.sut mapDynamicIndexes:dynamicIndexes count:2 length:2];
+	
+	expect(dynamicIndexes[0]).to.equal(2);
+	expect(dynamicIndexes[1]).to.equal(2);
+	expect(dynamicIndexes[2]).to.equal(3);
+	expect(dynamicIndexes[3]).to.equal(0);
+}
+
+
+
+#pragma mark - snapshot
+
+- (void)testSnapshotMappingMatchesEvaluatedMapping {
+	NSArray *hiddenIndexes = @[ @1, @2, @5, @9 ];
+	for (NSNumber *index in hiddenIndexes) {
+		[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:index.unsignedIntegerValue] condition:^BOOL{
+			return NO;
+		}];
+	}
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:7] condition:^BOOL{
+		return YES;
+	}];
+	
+	NSMutableArray *evaluatedDynamic = [NSMutableArray array];
+	NSMutableArray *evaluatedStatic = [NSMutableArray array];
+	for (NSUInteger index = 0; index < 12; index++) {
+		NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:index];
+		[evaluatedDynamic addObject:[self.sut dynamicIndexPathForStaticIndexPath:indexPath]];
+		[evaluatedStatic addObject:[self.sut staticIndexPathForDynamicIndexPath:indexPath]];
+	}
+	
+	self.sut.snapshotEnabled = YES;
+	for (NSUInteger index = 0; index < 12; index++) {
+		NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:index];
+		expect([self.sut dynamicIndexPathForStaticIndexPath:indexPath]).to.equal(evaluatedDynamic[index]);
+		expect([self.sut staticIndexPathForDynamicIndexPath:indexPath]).to.equal(evaluatedStatic[index]);
+	}
+}
+
+- (void)testSnapshotMappingForDescendants {
+	self.sut.snapshotEnabled = YES;
+	
+	NSUInteger hiddenIndexes[] = { 2, 0 };
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:hiddenIndexes length:2] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return NO;
+	}];
+	
+	NSUInteger staticIndexes[] = { 2, 3 };
+	NSIndexPath *dynamicIndexPath = [self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndexes:staticIndexes length:2]];
+	expect([dynamicIndexPath indexAtPosition:0]).to.equal(1);
+	expect([dynamicIndexPath indexAtPosition:1]).to.equal(2);
+	
+	NSIndexPath *staticIndexPath = [self.sut staticIndexPathForDynamicIndexPath:dynamicIndexPath];
+	expect([staticIndexPath indexAtPosition:0]).to.equal(2);
+	expect([staticIndexPath indexAtPosition:1]).to.equal(3);
+	
+	NSUInteger notFoundIndexes[] = { 1, 3 };
+	NSIndexPath *notFoundIndexPath = [self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndexes:notFoundIndexes length:2]];
+	expect([notFoundIndexPath indexAtPosition:0]).to.equal(NSNotFound);
+	expect([notFoundIndexPath indexAtPosition:1]).to.equal(NSNotFound);
+}
+
+- (void)testSnapshotIsReusedUntilInvalidated {
+	__block BOOL visible = NO;
+	__block NSUInteger evaluationCount = 0;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		evaluationCount++;
+		return visible;
+	}];
+	self.sut.snapshotEnabled = YES;
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:2];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	expect(evaluationCount).to.equal(1);
+	
+	visible = YES;
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	
+	[self.sut invalidateAll];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(2);
+	expect(evaluationCount).to.equal(2);
+}
+
+- (void)testInvalidatingSingleCondition {
+	__block BOOL firstVisible = NO;
+	__block NSUInteger firstEvaluationCount = 0;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		firstEvaluationCount++;
+		return firstVisible;
+	}];
+	__block NSUInteger secondEvaluationCount = 0;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		secondEvaluationCount++;
+		return NO;
+	}];
+	self.sut.snapshotEnabled = YES;
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:2];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(0);
+	
+	firstVisible = YES;
+	[self.sut invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:0]];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	expect(firstEvaluationCount).to.equal(2);
+	expect(secondEvaluationCount).to.equal(1);
+}
+
+- (void)testObservingEvaluationObjectInvalidatesCondition {
+	HRSIndexPathMapperTestsPerson *person = [HRSIndexPathMapperTestsPerson new];
+	person.age = 32;
+	
+	self.sut.snapshotEnabled = YES;
+	self.sut.observesEvaluationObjects = YES;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] predicate:[NSPredicate predicateWithFormat:@"age > 32"] evaluationObject:person];
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:1];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(0);
+	
+	person.age = 33; // grow old
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	
+	[self.sut removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] descendant:YES];
+}
+
+- (void)testPerformUpdatesReportsChangedIndexPaths {
+	__block BOOL sectionOneVisible = NO;
+	__block BOOL sectionThreeVisible = YES;
+	__block BOOL rowVisible = NO;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return sectionOneVisible;
+	}];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:3] condition:^BOOL{
+		return sectionThreeVisible;
+	}];
+	NSUInteger rowIndexes[] = { 2, 1 };
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:rowIndexes length:2] condition:^BOOL{
+		return rowVisible;
+	}];
+	
+	__block NSArray *deleted;
+	__block NSArray *inserted;
+	[self.sut performUpdates:^{
+		sectionOneVisible = YES;
+		sectionThreeVisible = NO;
+		rowVisible = YES;
+	} changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		deleted = deletedIndexPaths;
+		inserted = insertedIndexPaths;
+	}];
+	
+	NSUInteger insertedRowIndexes[] = { 2, 1 };
+	expect(deleted).to.equal(@[ [NSIndexPath indexPathWithIndex:2] ]);
+	expect(inserted).to.equal(@[ [NSIndexPath indexPathWithIndex:1], [NSIndexPath indexPathWithIndexes:insertedRowIndexes length:2] ]);
+}
+
+- (void)testPerformUpdatesWithSnapshotUsesPreviousResults {
+	__block BOOL visible = YES;
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return visible;
+	}];
+	self.sut.snapshotEnabled = YES;
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(1);
+	
+	visible = NO;
+	__block NSArray *deleted;
+	[self.sut performUpdates:^{
+		[self.sut invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:1]];
+	} changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		deleted = deletedIndexPaths;
+		expect(insertedIndexPaths).to.haveCountOf(0);
+	}];
+	
+	expect(deleted).to.equal(@[ [NSIndexPath indexPathWithIndex:1] ]);
+}
+
+- (void)testSettingConditionInvalidatesSnapshot {
+	self.sut.snapshotEnabled = YES;
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:2];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(2);
+	
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return NO;
+	}];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(1);
+	
+	[self.sut removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] descendant:YES];
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal(2);
+}
+
+- (void)testFlippingSingleConditionsUpdatesSnapshot {
+	// every third index is a condition, every ninth one covers a range of two
+	NSMutableArray *visibility = [NSMutableArray array];
+	HRSIndexPathMapper *evaluatingMapper = [HRSIndexPathMapper new];
+	for (NSUInteger index = 0; index < 300; index += 3) {
+		NSUInteger condition = visibility.count;
+		[visibility addObject:@NO];
+		BOOL(^block)(void) = ^BOOL{
+			return [visibility[condition] boolValue];
+		};
+		NSRange range = NSMakeRange(index, (condition % 3 == 0 ? 2 : 1));
+		[self.sut setConditionForIndexRange:range atIndexPath:[NSIndexPath new] condition:block];
+		[evaluatingMapper setConditionForIndexRange:range atIndexPath:[NSIndexPath new] condition:block];
+	}
+	self.sut.snapshotEnabled = YES;
+	expect([self.sut numberOfVisibleIndexesOfTotal:300 atIndexPath:[NSIndexPath new]]).to.equal([evaluatingMapper numberOfVisibleIndexesOfTotal:300 atIndexPath:[NSIndexPath new]]);
+	
+	uint32_t state = 7;
+	for (NSUInteger flip = 0; flip < 50; flip++) {
+		state = state * 1664525u + 1013904223u;
+		NSUInteger condition = (state >> 8) % visibility.count;
+		visibility[condition] = @(![visibility[condition] boolValue]);
+		[self.sut invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:condition * 3]];
+		
+		for (NSUInteger index = 0; index < 300; index++) {
+			NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:index];
+			expect([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]).to.equal([[evaluatingMapper dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:0]);
+			expect([[self.sut staticIndexPathForDynamicIndexPath:indexPath] indexAtPosition:0]).to.equal([[evaluatingMapper staticIndexPathForDynamicIndexPath:indexPath] indexAtPosition:0]);
+		}
+		expect([self.sut numberOfVisibleIndexesOfTotal:300 atIndexPath:[NSIndexPath new]]).to.equal([evaluatingMapper numberOfVisibleIndexesOfTotal:300 atIndexPath:[NSIndexPath new]]);
+	}
+}
+
+- (void)testInvalidatingSingleConditionDoesNotEvaluateOthers {
+	__block BOOL visible = NO;
+	for (NSUInteger index = 0; index < 10; index++) {
+		[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:index] condition:^BOOL{
+			return (index == 4 && visible);
+		}];
+	}
+	self.sut.snapshotEnabled = YES;
+	expect([[self.sut staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:0]] indexAtPosition:0]).to.equal(10);
+	
+	HRSIndexPathMapperTestsInstrumentation *instrumentation = [HRSIndexPathMapperTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	visible = YES;
+	[self.sut invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:4]];
+	expect([[self.sut staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:0]] indexAtPosition:0]).to.equal(4);
+	self.sut.instrumentation = nil;
+	
+	expect(instrumentation.evaluatedIndexPaths).to.equal(@[ [NSIndexPath indexPathWithIndex:4] ]);
+}
+
+
+
+#pragma mark - range conditions
+
+- (void)testRangeConditionHidesAllIndexesOfTheRange {
+	[self.sut setConditionForIndexRange:NSMakeRange(2, 4) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:1]] indexAtPosition:0]).to.equal(1);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:2]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:5]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:6]] indexAtPosition:0]).to.equal(2);
+	expect([[self.sut staticIndexPathForDynamicIndexPath:[NSIndexPath indexPathWithIndex:2]] indexAtPosition:0]).to.equal(6);
+}
+
+- (void)testRangeConditionMatchesSingleConditions {
+	HRSIndexPathMapper *singleMapper = [HRSIndexPathMapper new];
+	for (NSUInteger row = 1; row < 4; row++) {
+		NSUInteger indexes[] = { 2, row };
+		[singleMapper setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2] condition:^BOOL{
+			return NO;
+		}];
+	}
+	[singleMapper setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return NO;
+	}];
+	
+	[self.sut setConditionForIndexRange:NSMakeRange(1, 3) atIndexPath:[NSIndexPath indexPathWithIndex:2] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexRange:NSMakeRange(0, 1) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	
+	NSArray *indexPaths = [self batchIndexPaths];
+	for (NSNumber *snapshot in @[ @NO, @YES ]) {
+		self.sut.snapshotEnabled = snapshot.boolValue;
+		singleMapper.snapshotEnabled = snapshot.boolValue;
+		
+		expect([self.sut dynamicIndexPathsForStaticIndexPaths:indexPaths]).to.equal([singleMapper dynamicIndexPathsForStaticIndexPaths:indexPaths]);
+		expect([self.sut staticIndexPathsForDynamicIndexPaths:indexPaths]).to.equal([singleMapper staticIndexPathsForDynamicIndexPaths:indexPaths]);
+		for (NSIndexPath *indexPath in indexPaths) {
+			expect([self.sut dynamicIndexPathForStaticIndexPath:indexPath]).to.equal([singleMapper dynamicIndexPathForStaticIndexPath:indexPath]);
+			expect([self.sut staticIndexPathForDynamicIndexPath:indexPath]).to.equal([singleMapper staticIndexPathForDynamicIndexPath:indexPath]);
+		}
+	}
+}
+
+- (void)testSettingConditionInsideRangeSplitsRange {
+	[self.sut setConditionForIndexRange:NSMakeRange(0, 10) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:5] condition:^BOOL{
+		return YES;
+	}];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:5]] indexAtPosition:0]).to.equal(0);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:6]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:10]] indexAtPosition:0]).to.equal(1);
+}
+
+- (void)testSettingRangeReplacesConditionsInsideRange {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:3] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexRange:NSMakeRange(2, 3) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return YES;
+	}];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:3]] indexAtPosition:0]).to.equal(3);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:6]] indexAtPosition:0]).to.equal(6);
+}
+
+- (void)testRemovingPartOfRangeKeepsTheRemainder {
+	[self.sut setConditionForIndexRange:NSMakeRange(0, 10) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut removeConditionForIndexRange:NSMakeRange(3, 2) atIndexPath:[NSIndexPath new]];
+	[self.sut removeConditionForIndexPath:[NSIndexPath indexPathWithIndex:8] descendant:NO];
+	
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:2]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:3]] indexAtPosition:0]).to.equal(0);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:4]] indexAtPosition:0]).to.equal(1);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:5]] indexAtPosition:0]).to.equal(NSNotFound);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:8]] indexAtPosition:0]).to.equal(2);
+	expect([[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:10]] indexAtPosition:0]).to.equal(3);
+}
+
+- (void)testPerformUpdatesReportsEveryIndexOfRange {
+	__block BOOL visible = NO;
+	[self.sut setConditionForIndexRange:NSMakeRange(1, 3) atIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return visible;
+	}];
+	
+	__block NSArray *inserted;
+	[self.sut performUpdates:^{
+		visible = YES;
+	} changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		inserted = insertedIndexPaths;
+		expect(deletedIndexPaths).to.haveCountOf(0);
+	}];
+	
+	expect(inserted).to.equal(@[ [NSIndexPath indexPathForRow:1 inSection:0], [NSIndexPath indexPathForRow:2 inSection:0], [NSIndexPath indexPathForRow:3 inSection:0] ]);
+}
+
+- (void)testDeprecatedNodeInitializerCoversOneIndex {
+	HRSIndexPathMapperNode *node = [[HRSIndexPathMapperNode alloc] initWithIndex:2 condition:^BOOL{
+		return NO;
+	}];
+	
+	expect(node.length).to.equal(1);
+}
+
+
+
+#pragma mark - counting
+
+- (void)testCountingVisibleIndexes {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexRange:NSMakeRange(4, 3) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	NSUInteger rowIndexes[] = { 2, 1 };
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndexes:rowIndexes length:2] condition:^BOOL{
+		return NO;
+	}];
+	
+	for (NSNumber *snapshot in @[ @NO, @YES ]) {
+		self.sut.snapshotEnabled = snapshot.boolValue;
+		
+		expect([self.sut numberOfVisibleIndexesOfTotal:10 atIndexPath:[NSIndexPath new]]).to.equal(6);
+		expect([self.sut numberOfVisibleIndexesOfTotal:5 atIndexPath:[NSIndexPath new]]).to.equal(3);
+		expect([self.sut numberOfVisibleIndexesOfTotal:3 atIndexPath:[NSIndexPath indexPathWithIndex:2]]).to.equal(2);
+		expect([self.sut numberOfVisibleIndexesOfTotal:3 atIndexPath:[NSIndexPath indexPathWithIndex:1]]).to.equal(0);
+		expect([self.sut numberOfVisibleIndexesOfTotal:3 atIndexPath:[NSIndexPath indexPathWithIndex:5]]).to.equal(0);
+		expect([self.sut numberOfVisibleIndexesOfTotal:3 atIndexPath:[NSIndexPath indexPathWithIndex:8]]).to.equal(3);
+	}
+}
+
+- (void)testCountingMatchesMapping {
+	[self configureBatchConditions];
+	
+	for (NSUInteger section = 0; section < 4; section++) {
+		NSIndexPath *sectionIndexPath = [NSIndexPath indexPathWithIndex:section];
+		if ([[self.sut dynamicIndexPathForStaticIndexPath:sectionIndexPath] indexAtPosition:0] == NSNotFound) {
+			continue;
+		}
+		
+		NSUInteger visibleCount = 0;
+		for (NSUInteger row = 0; row < 5; row++) {
+			NSIndexPath *indexPath = [sectionIndexPath indexPathByAddingIndex:row];
+			if ([[self.sut dynamicIndexPathForStaticIndexPath:indexPath] indexAtPosition:1] != NSNotFound) {
+				visibleCount++;
+			}
+		}
+		expect([self.sut numberOfVisibleIndexesOfTotal:5 atIndexPath:sectionIndexPath]).to.equal(visibleCount);
+	}
+}
+
+
+
+#pragma mark - enumeration
+
+- (void)testEnumeratingVisibleIndexes {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:1] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:2] condition:^BOOL{
+		return YES;
+	}];
+	[self.sut setConditionForIndexRange:NSMakeRange(4, 3) atIndexPath:[NSIndexPath new] condition:^BOOL{
+		return NO;
+	}];
+	
+	for (NSNumber *snapshot in @[ @NO, @YES ]) {
+		self.sut.snapshotEnabled = snapshot.boolValue;
+		
+		NSMutableArray *staticIndexes = [NSMutableArray array];
+		NSMutableArray *dynamicIndexes = [NSMutableArray array];
+		[self.sut enumerateVisibleIndexesAtIndexPath:[NSIndexPath new] total:9 usingBlock:^(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop) {
+			[staticIndexes addObject:@(staticIndex)];
+			[dynamicIndexes addObject:@(dynamicIndex)];
+		}];
+		
+		expect(staticIndexes).to.equal(@[ @0, @2, @3, @7, @8 ]);
+		expect(dynamicIndexes).to.equal(@[ @0, @1, @2, @3, @4 ]);
+		
+		NSMutableIndexSet *expectedIndexes = [NSMutableIndexSet indexSetWithIndex:0];
+		[expectedIndexes addIndexesInRange:NSMakeRange(2, 2)];
+		expect([self.sut visibleIndexesAtIndexPath:[NSIndexPath new] total:5]).to.equal(expectedIndexes);
+	}
+}
+
+- (void)testEnumeratingMatchesMapping {
+	[self configureBatchConditions];
+	
+	for (NSUInteger section = 0; section < 4; section++) {
+		NSIndexPath *sectionIndexPath = [NSIndexPath indexPathWithIndex:section];
+		[self.sut enumerateVisibleIndexesAtIndexPath:sectionIndexPath total:5 usingBlock:^(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop) {
+			NSIndexPath *dynamicIndexPath = [self.sut dynamicIndexPathForStaticIndexPath:[sectionIndexPath indexPathByAddingIndex:staticIndex]];
+			expect([dynamicIndexPath indexAtPosition:1]).to.equal(dynamicIndex);
+		}];
+		expect([self.sut visibleIndexesAtIndexPath:sectionIndexPath total:5].count).to.equal([self.sut numberOfVisibleIndexesOfTotal:5 atIndexPath:sectionIndexPath]);
+	}
+}
+
+- (void)testEnumeratingVisibleIndexesCanBeStopped {
+	__block NSUInteger count = 0;
+	[self.sut enumerateVisibleIndexesAtIndexPath:[NSIndexPath new] total:10 usingBlock:^(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop) {
+		count++;
+		*stop = (staticIndex == 2);
+	}];
+	
+	expect(count).to.equal(3);
+}
+
+
+
+#pragma mark - instrumentation
+
+- (void)testInstrumentationReportsEvaluatedConditions {
+	NSUInteger indexes[] = { 1, 2 };
+	NSIndexPath *nestedIndexPath = [NSIndexPath indexPathWithIndexes:indexes length:2];
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setConditionForIndexPath:nestedIndexPath condition:^BOOL{
+		return YES;
+	}];
+	HRSIndexPathMapperTestsInstrumentation *instrumentation = [HRSIndexPathMapperTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	
+	NSUInteger queryIndexes[] = { 1, 4 };
+	[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndexes:queryIndexes length:2]];
+	
+	expect(instrumentation.evaluatedIndexPaths).to.equal(@[ [NSIndexPath indexPathWithIndex:0], nestedIndexPath ]);
+	expect(instrumentation.results).to.equal(@[ @NO, @YES ]);
+}
+
+- (void)testInstrumentationCanBeRemoved {
+	[self.sut setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return NO;
+	}];
+	HRSIndexPathMapperTestsInstrumentation *instrumentation = [HRSIndexPathMapperTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:2]];
+	
+	self.sut.instrumentation = nil;
+	[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:2]];
+	
+	expect(instrumentation.evaluatedIndexPaths.count).to.equal(1);
+}
+
+- (void)testInstrumentationReportsConditionsSetAfterwards {
+	HRSIndexPathMapperTestsInstrumentation *instrumentation = [HRSIndexPathMapperTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	NSUInteger indexes[] = { 1, 2 };
+	NSIndexPath *nestedIndexPath = [NSIndexPath indexPathWithIndexes:indexes length:2];
+	[self.sut setConditionForIndexPath:nestedIndexPath condition:^BOOL{
+		return NO;
+	}];
+	
+	[self.sut dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndexes:indexes length:2]];
+	
+	expect(instrumentation.evaluatedIndexPaths).to.equal(@[ nestedIndexPath ]);
+}
+
+- (void)testInstrumentationDoesNotReportOtherMappers {
+	HRSIndexPathMapper *otherMapper = [HRSIndexPathMapper new];
+	[otherMapper setConditionForIndexPath:[NSIndexPath indexPathWithIndex:0] condition:^BOOL{
+		return NO;
+	}];
+	HRSIndexPathMapperTestsInstrumentation *instrumentation = [HRSIndexPathMapperTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	
+	[otherMapper dynamicIndexPathForStaticIndexPath:[NSIndexPath indexPathWithIndex:2]];
+	
+	expect(instrumentation.evaluatedIndexPaths).to.haveCountOf(0);
+}
+
 @end
@@ -0,0 +1,85 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+
+
+/**
+ Returns the next value of a deterministic pseudo random sequence.
+ 
+ Benchmarks use this instead of `arc4random()` so that every run works on the
+ exact same data and results stay comparable between runs.
+ 
+ @param state The state of the sequence. Initialize it with a fixed seed.
+ 
+ @return The next value of the sequence.
+ */
+static inline uint32_t HRSPerformanceRandom(uint32_t *state) {
+	*state = *state * 1664525u + 1013904223u;
+	return (*state >> 8);
+}
+
+
+/**
+ A test case that runs micro benchmarks and reports their results in a machine
+ readable format.
+ 
+ Every benchmark runs its block once to warm up and then a fixed number of
+ times while measuring each run. The result is logged as a single line that
+ starts with `HRSBenchmark` followed by a JSON object with the name of the
+ suite and the benchmark, its parameters and the median, minimum and maximum
+ time of a single operation in nanoseconds.
+ 
+ Benchmarks are skipped by default so that they do not slow down the regular
+ test runs. Set the environment variable `HRS_BENCHMARK` to `1` to run them.
+ 
+ If the environment variable `HRS_BENCHMARK_OUTPUT` contains a file path, the
+ benchmarks run as well and the JSON objects are also appended to this file,
+ one per line, so that results can be collected and compared over time.
+ */
+@interface HRSPerformanceTestCase : XCTestCase
+
+/**
+ Measures the given block and reports the result.
+ 
+ @param name       The name of the benchmark, unique within the suite.
+ @param parameters The parameters of this run, e.g. the size of the input.
+                   Values must be JSON compatible.
+ @param operations The number of operations the block performs. The reported
+                   times are divided by this number.
+ @param block      The block to measure.
+ 
+ @return The median time of a single operation in nanoseconds.
+ */
+- (double)benchmark:(NSString *)name parameters:(NSDictionary *)parameters operations:(NSUInteger)operations block:(void(^)(void))block;
+
+/**
+ Measures the given block and reports the result, while preparing every run
+ with a setup block that is not measured.
+ 
+ Use this for operations that consume their input, e.g. removing conditions.
+ 
+ @param name       The name of the benchmark, unique within the suite.
+ @param parameters The parameters of this run, e.g. the size of the input.
+                   Values must be JSON compatible.
+ @param operations The number of operations the block performs. The reported
+                   times are divided by this number.
+ @param setup      A block that creates a fresh fixture before every run.
+ @param block      The block to measure. It is called with the fixture.
+ 
+ @return The median time of a single operation in nanoseconds.
+ */
+- (double)benchmark:(NSString *)name parameters:(NSDictionary *)parameters operations:(NSUInteger)operations setup:(id(^)(void))setup block:(void(^)(id fixture))block;
+
+@end
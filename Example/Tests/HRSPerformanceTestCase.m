@@ -0,0 +1,124 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import "HRSPerformanceTestCase.h"
+
+#import <mach/mach_time.h>
+
+
+static NSUInteger const HRSPerformanceSampleCount = 15;
+static NSString * const HRSPerformanceEnvironmentKey = @"HRS_BENCHMARK";
+static NSString * const HRSPerformanceOutputEnvironmentKey = @"HRS_BENCHMARK_OUTPUT";
+
+
+@implementation HRSPerformanceTestCase
+
++ (BOOL)benchmarksEnabled {
+	NSDictionary *environment = [NSProcessInfo processInfo].environment;
+	return ([environment[HRSPerformanceEnvironmentKey] boolValue] || [environment[HRSPerformanceOutputEnvironmentKey] length] > 0);
+}
+
++ (XCTestSuite *)defaultTestSuite {
+	if ([self benchmarksEnabled] == NO) {
+		return [XCTestSuite testSuiteWithName:NSStringFromClass(self)];
+	}
+	return [super defaultTestSuite];
+}
+
+- (double)benchmark:(NSString *)name parameters:(NSDictionary *)parameters operations:(NSUInteger)operations block:(void(^)(void))block {
+	NSParameterAssert(block);
+	if (block == nil) {
+		return 0.0;
+	}
+	
+	return [self benchmark:name parameters:parameters operations:operations setup:nil block:^(id fixture) {
+		block();
+	}];
+}
+
+- (double)benchmark:(NSString *)name parameters:(NSDictionary *)parameters operations:(NSUInteger)operations setup:(id(^)(void))setup block:(void(^)(id fixture))block {
+	NSParameterAssert(name);
+	NSParameterAssert(block);
+	if (name == nil || block == nil) {
+		return 0.0;
+	}
+	operations = MAX(operations, 1u);
+	
+	static mach_timebase_info_data_t timebase;
+	if (timebase.denom == 0) {
+		mach_timebase_info(&timebase);
+	}
+	
+	block(setup ? setup() : nil);
+	
+	double samples[HRSPerformanceSampleCount];
+	for (NSUInteger sample = 0; sample < HRSPerformanceSampleCount; sample++) {
+		@autoreleasepool {
+			id fixture = (setup ? setup() : nil);
+			uint64_t start = mach_absolute_time();
+			block(fixture);
+			uint64_t end = mach_absolute_time();
+			samples[sample] = (double)(end - start) * timebase.numer / timebase.denom / operations;
+		}
+	}
+	
+	// insertion sort, the number of samples is tiny
+	for (NSUInteger sample = 1; sample < HRSPerformanceSampleCount; sample++) {
+		double value = samples[sample];
+		NSUInteger position = sample;
+		while (position > 0 && samples[position - 1] > value) {
+			samples[position] = samples[position - 1];
+			position--;
+		}
+		samples[position] = value;
+	}
+	double median = samples[HRSPerformanceSampleCount / 2];
+	
+	NSDictionary *result = @{
+		@"suite": NSStringFromClass([self class]),
+		@"benchmark": name,
+		@"parameters": (parameters ?: @{}),
+		@"operations": @(operations),
+		@"samples": @(HRSPerformanceSampleCount),
+		@"median_ns": @(median),
+		@"min_ns": @(samples[0]),
+		@"max_ns": @(samples[HRSPerformanceSampleCount - 1])
+	};
+	[self reportResult:result];
+	
+	return median;
+}
+
+- (void)reportResult:(NSDictionary *)result {
+	NSData *data = [NSJSONSerialization dataWithJSONObject:result options:0 error:NULL];
+	if (data == nil) {
+		return;
+	}
+	NSString *line = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+	NSLog(@"HRSBenchmark %@", line);
+	
+	NSString *path = [NSProcessInfo processInfo].environment[HRSPerformanceOutputEnvironmentKey];
+	if (path.length == 0) {
+		return;
+	}
+	if ([[NSFileManager defaultManager] fileExistsAtPath:path] == NO) {
+		[[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+	}
+	NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+	[fileHandle seekToEndOfFile];
+	[fileHandle writeData:[[line stringByAppendingString:@"\n"] dataUsingEncoding:NSUTF8StringEncoding]];
+	[fileHandle closeFile];
+}
+
+@end
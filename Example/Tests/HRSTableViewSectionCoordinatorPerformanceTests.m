@@ -0,0 +1,395 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+
+#import <HRSAdvancedTableViews/HRSSectionController.h>
+
+#import "HRSPerformanceTestCase.h"
+
+
+static NSUInteger const HRSTableViewSectionCoordinatorPerformanceCallCount = 10000;
+static NSUInteger const HRSTableViewSectionCoordinatorPerformanceTransitionCount = 100;
+
+
+/// A table view that answers the mapped calls and ignores all updates without
+/// doing any layout work, so that the benchmarks only measure the cost of the
+/// coordinator and its proxies.
+@interface HRSTableViewSectionCoordinatorPerformanceTableView : UITableView
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorPerformanceTableView
+
+- (NSInteger)numberOfRowsInSection:(NSInteger)section {
+	return 100;
+}
+
+- (CGRect)rectForRowAtIndexPath:(NSIndexPath *)indexPath {
+	return CGRectZero;
+}
+
+- (UITableViewCell *)cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+	return nil;
+}
+
+- (void)reloadData {
+}
+
+- (void)beginUpdates {
+}
+
+- (void)endUpdates {
+}
+
+- (void)insertSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+}
+
+- (void)deleteSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+}
+
+- (void)reloadSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+}
+
+- (void)moveSection:(NSInteger)section toSection:(NSInteger)newSection {
+}
+
+@end
+
+
+@interface HRSTableViewSectionCoordinatorPerformanceController : HRSTableViewSectionController
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorPerformanceController
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+	return 100;
+}
+
+- (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath {
+	return 44.0;
+}
+
+- (NSIndexPath *)tableView:(UITableView *)tableView willSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+	return indexPath;
+}
+
+@end
+
+
+/// A controller that groups its rows into a fixed number of sections.
+@interface HRSTableViewSectionCoordinatorPerformanceMultiSectionController : HRSTableViewSectionCoordinatorPerformanceController
+
+@property (nonatomic, assign, readwrite) NSInteger sectionCount;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorPerformanceMultiSectionController
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+	return self.sectionCount;
+}
+
+@end
+
+
+@interface HRSTableViewSectionCoordinator (PerformanceTests)
+
+- (void)_finishTransition;
+
+@end
+
+
+@interface HRSTableViewSectionCoordinatorPerformanceTests : HRSPerformanceTestCase
+
+@property (nonatomic, strong, readwrite) HRSTableViewSectionCoordinator *sut;
+@property (nonatomic, strong, readwrite) UITableView *tableView;
+@property (nonatomic, strong, readwrite) NSArray *sectionController;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorPerformanceTests
+
+- (void)setUp {
+	[super setUp];
+	
+	NSMutableArray *sectionController = [NSMutableArray array];
+	for (NSUInteger section = 0; section < 10; section++) {
+		[sectionController addObject:[HRSTableViewSectionCoordinatorPerformanceController new]];
+	}
+	self.sectionController = sectionController;
+	
+	self.tableView = [[HRSTableViewSectionCoordinatorPerformanceTableView alloc] initWithFrame:CGRectMake(0.0, 0.0, 320.0, 480.0) style:UITableViewStylePlain];
+	self.sut = [HRSTableViewSectionCoordinator new];
+	[self.sut setSectionController:sectionController animated:NO];
+	[self.sut setTableView:self.tableView];
+}
+
+- (void)tearDown {
+	self.sut = nil;
+	self.tableView = nil;
+	self.sectionController = nil;
+	
+	[super tearDown];
+}
+
+- (NSDictionary *)parameters {
+	return @{ @"sections": @(self.sectionController.count) };
+}
+
+
+
+#pragma mark - section controller to table view
+
+- (void)testForwardingToTableView {
+	HRSTableViewSectionController *controller = [self.sectionController lastObject];
+	UITableView *tableView = controller.tableView;
+	UITableView *realTableView = self.tableView;
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:0];
+	NSUInteger calls = HRSTableViewSectionCoordinatorPerformanceCallCount;
+	
+	[self benchmark:@"directRectForRowAtIndexPath" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[realTableView rectForRowAtIndexPath:indexPath];
+		}
+	}];
+	
+	[self benchmark:@"proxyRectForRowAtIndexPath" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[tableView rectForRowAtIndexPath:indexPath];
+		}
+	}];
+	
+	[self benchmark:@"proxyNumberOfRowsInSection" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[tableView numberOfRowsInSection:0];
+		}
+	}];
+	
+	// not registered for mapping, takes the fast forwarding path
+	[self benchmark:@"proxyRowHeight" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[tableView rowHeight];
+		}
+	}];
+}
+
+- (void)testPerformanceOfForwardingToTableView {
+	HRSTableViewSectionController *controller = [self.sectionController lastObject];
+	UITableView *tableView = controller.tableView;
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:0];
+	
+	[self measureBlock:^{
+		for (NSUInteger call = 0; call < HRSTableViewSectionCoordinatorPerformanceCallCount; call++) {
+			[tableView rectForRowAtIndexPath:indexPath];
+		}
+	}];
+}
+
+
+
+#pragma mark - table view to section controller
+
+- (void)testForwardingToSectionController {
+	HRSTableViewSectionCoordinator *coordinator = self.sut;
+	UITableView *tableView = self.tableView;
+	id<HRSTableViewSectionController> controller = [self.sectionController lastObject];
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:self.sectionController.count - 1];
+	NSUInteger calls = HRSTableViewSectionCoordinatorPerformanceCallCount;
+	
+	[self benchmark:@"directHeightForRowAtIndexPath" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[controller tableView:tableView heightForRowAtIndexPath:indexPath];
+		}
+	}];
+	
+	[self benchmark:@"coordinatorHeightForRowAtIndexPath" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[coordinator tableView:tableView heightForRowAtIndexPath:indexPath];
+		}
+	}];
+	
+	[self benchmark:@"coordinatorNumberOfRowsInSection" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[coordinator tableView:tableView numberOfRowsInSection:indexPath.section];
+		}
+	}];
+	
+	// maps the arguments and the return value
+	[self benchmark:@"coordinatorWillSelectRowAtIndexPath" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[coordinator tableView:tableView willSelectRowAtIndexPath:indexPath];
+		}
+	}];
+}
+
+- (void)testPerformanceOfForwardingToSectionController {
+	HRSTableViewSectionCoordinator *coordinator = self.sut;
+	UITableView *tableView = self.tableView;
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:self.sectionController.count - 1];
+	
+	[self measureBlock:^{
+		for (NSUInteger call = 0; call < HRSTableViewSectionCoordinatorPerformanceCallCount; call++) {
+			[coordinator tableView:tableView heightForRowAtIndexPath:indexPath];
+		}
+	}];
+}
+
+
+
+
+#pragma mark - grouped lists
+
+- (void)testForwardingInGroupedLists {
+	static NSUInteger const sectionCount = 1000;
+	static NSUInteger const sectionsPerController = 100;
+	
+	NSMutableArray *singleSectionController = [NSMutableArray array];
+	for (NSUInteger section = 0; section < sectionCount; section++) {
+		[singleSectionController addObject:[HRSTableViewSectionCoordinatorPerformanceController new]];
+	}
+	NSMutableArray *multiSectionController = [NSMutableArray array];
+	for (NSUInteger controller = 0; controller < sectionCount / sectionsPerController; controller++) {
+		HRSTableViewSectionCoordinatorPerformanceMultiSectionController *sectionController = [HRSTableViewSectionCoordinatorPerformanceMultiSectionController new];
+		sectionController.sectionCount = sectionsPerController;
+		[multiSectionController addObject:sectionController];
+	}
+	
+	UITableView *tableView = self.tableView;
+	NSUInteger calls = HRSTableViewSectionCoordinatorPerformanceCallCount;
+	NSDictionary *lists = @{ @"single": singleSectionController, @"multi": multiSectionController };
+	
+	for (NSString *kind in @[ @"single", @"multi" ]) {
+		HRSTableViewSectionCoordinator *coordinator = [HRSTableViewSectionCoordinator new];
+		[coordinator setSectionController:lists[kind] animated:NO];
+		[coordinator setTableView:tableView];
+		
+		NSDictionary *parameters = @{ @"sections": @(sectionCount), @"controllers": @([lists[kind] count]) };
+		uint32_t state = 42;
+		
+		[self benchmark:[NSString stringWithFormat:@"%@SectionHeightForRowAtIndexPath", kind] parameters:parameters operations:calls block:^{
+			uint32_t callState = state;
+			for (NSUInteger call = 0; call < calls; call++) {
+				NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:HRSPerformanceRandom(&callState) % sectionCount];
+				[coordinator tableView:tableView heightForRowAtIndexPath:indexPath];
+			}
+		}];
+		
+		HRSTableViewSectionController *controller = [lists[kind] lastObject];
+		UITableView *tableViewProxy = controller.tableView;
+		NSIndexPath *indexPath = [NSIndexPath indexPathForRow:4 inSection:(tableViewProxy.numberOfSections - 1)];
+		[self benchmark:[NSString stringWithFormat:@"%@SectionProxyRectForRowAtIndexPath", kind] parameters:parameters operations:calls block:^{
+			for (NSUInteger call = 0; call < calls; call++) {
+				[tableViewProxy rectForRowAtIndexPath:indexPath];
+			}
+		}];
+		
+		[coordinator setTableView:nil];
+	}
+}
+
+
+
+#pragma mark - coalesced updates
+
+- (void)testCoalescedUpdates {
+	HRSTableViewSectionCoordinator *coordinator = self.sut;
+	NSMutableArray *tableViews = [NSMutableArray array];
+	for (HRSTableViewSectionController *controller in self.sectionController) {
+		[tableViews addObject:controller.tableView];
+	}
+	NSIndexSet *sections = [NSIndexSet indexSetWithIndex:0];
+	NSUInteger controllerCount = tableViews.count;
+	NSUInteger calls = HRSTableViewSectionCoordinatorPerformanceCallCount;
+	
+	// every controller reloads its section once per run loop turn
+	[self benchmark:@"immediateReloadSections" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[tableViews[call % controllerCount] reloadSections:sections withRowAnimation:UITableViewRowAnimationNone];
+		}
+	}];
+	
+	coordinator.updateCoalescingEnabled = YES;
+	[self benchmark:@"coalescedReloadSections" parameters:[self parameters] operations:calls block:^{
+		for (NSUInteger call = 0; call < calls; call++) {
+			[tableViews[call % controllerCount] reloadSections:sections withRowAnimation:UITableViewRowAnimationNone];
+			if (call % controllerCount == controllerCount - 1) {
+				[coordinator applyPendingTableViewUpdates];
+			}
+		}
+	}];
+	coordinator.updateCoalescingEnabled = NO;
+}
+
+
+
+#pragma mark - section controller transitions
+
+/// Returns a list of 100 section controllers and a filtered list that drops
+/// every tenth controller and shuffles the rest.
+- (NSArray *)transitionLists {
+	NSMutableArray *sectionController = [NSMutableArray array];
+	for (NSUInteger section = 0; section < 100; section++) {
+		[sectionController addObject:[HRSTableViewSectionCoordinatorPerformanceController new]];
+	}
+	
+	uint32_t state = 42;
+	NSMutableArray *filteredSectionController = [NSMutableArray array];
+	for (NSUInteger section = 0; section < sectionController.count; section++) {
+		if (section % 10 != 0) {
+			[filteredSectionController addObject:sectionController[section]];
+		}
+	}
+	for (NSUInteger section = filteredSectionController.count - 1; section > 0; section--) {
+		[filteredSectionController exchangeObjectAtIndex:section withObjectAtIndex:HRSPerformanceRandom(&state) % (section + 1)];
+	}
+	return @[ sectionController, filteredSectionController ];
+}
+
+- (void)testAnimatedTransitions {
+	HRSTableViewSectionCoordinator *coordinator = self.sut;
+	NSArray *lists = [self transitionLists];
+	NSUInteger transitions = HRSTableViewSectionCoordinatorPerformanceTransitionCount;
+	
+	// every transition finishes before the next one starts
+	[self benchmark:@"setSectionControllerAnimated" parameters:@{ @"sections": @([lists[0] count]) } operations:transitions block:^{
+		for (NSUInteger transition = 0; transition < transitions; transition++) {
+			[coordinator setSectionController:lists[transition % 2] animated:YES];
+			[coordinator _finishTransition];
+		}
+	}];
+}
+
+- (void)testScheduledAnimatedTransitions {
+	HRSTableViewSectionCoordinator *coordinator = self.sut;
+	NSArray *lists = [self transitionLists];
+	NSUInteger transitions = HRSTableViewSectionCoordinatorPerformanceTransitionCount;
+	
+	// all but the first and the last list are skipped
+	[self benchmark:@"setSectionControllerAnimatedScheduled" parameters:@{ @"sections": @([lists[0] count]) } operations:transitions block:^{
+		for (NSUInteger transition = 0; transition < transitions; transition++) {
+			[coordinator setSectionController:lists[transition % 2] animated:YES];
+		}
+		[coordinator _finishTransition];
+		[coordinator _finishTransition];
+	}];
+}
+
+@end
@@ -17,12 +17,269 @@
 
 #import <HRSAdvancedTableViews/HRSSectionController.h>
 #import <HRSAdvancedTableViews/HRSTableViewSectionCoordinator+IndexPathMapping.h>
+#import <HRSAdvancedTableViews/HRSTableViewSectionTransformer.h>
+
+
+@interface HRSTableViewSectionCoordinatorTableViewTestsTableView : UITableView
+
+@property (nonatomic, strong, readwrite) NSIndexPath *lastHighlightedIndexPath;
+
+- (NSIndexPath *)highlightRowAtIndexPath:(NSIndexPath *)indexPath;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsTableView
+
+- (NSIndexPath *)highlightRowAtIndexPath:(NSIndexPath *)indexPath {
+	self.lastHighlightedIndexPath = indexPath;
+	return indexPath;
+}
+
+- (void)reloadRowsAtIndexPaths:(NSArray *)indexPaths withRowAnimation:(UITableViewRowAnimation)animation {
+	// the tests do not provide any rows
+}
+
+- (void)reloadSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	// the tests do not provide any rows
+}
+
+- (void)insertSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	// the tests do not provide any rows
+}
+
+- (void)deleteSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	// the tests do not provide any rows
+}
+
+@end
+
+
+/// A table view that records the updates it receives instead of performing them.
+@interface HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView : UITableView
+
+@property (nonatomic, strong, readwrite) NSMutableArray *updates;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView
+
+- (NSMutableArray *)updates {
+	if (_updates == nil) {
+		_updates = [NSMutableArray array];
+	}
+	return _updates;
+}
+
+- (void)reloadData {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd) ]];
+}
+
+- (void)beginUpdates {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd) ]];
+}
+
+- (void)endUpdates {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd) ]];
+}
+
+- (void)insertSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), sections ]];
+}
+
+- (void)deleteSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), sections ]];
+}
+
+- (void)reloadSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), sections ]];
+}
+
+- (void)moveSection:(NSInteger)section toSection:(NSInteger)newSection {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), @(section), @(newSection) ]];
+}
+
+- (void)insertRowsAtIndexPaths:(NSArray *)indexPaths withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), indexPaths ]];
+}
+
+- (void)deleteRowsAtIndexPaths:(NSArray *)indexPaths withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), indexPaths ]];
+}
+
+- (void)reloadRowsAtIndexPaths:(NSArray *)indexPaths withRowAnimation:(UITableViewRowAnimation)animation {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), indexPaths ]];
+}
+
+- (void)moveRowAtIndexPath:(NSIndexPath *)indexPath toIndexPath:(NSIndexPath *)newIndexPath {
+	[self.updates addObject:@[ NSStringFromSelector(_cmd), indexPath, newIndexPath ]];
+}
+
+@end
+
+
+@interface HRSTableViewSectionCoordinatorTableViewTestsController : HRSTableViewSectionController
+
+@property (nonatomic, assign, readwrite) NSUInteger heightForRowHitCount;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsController
+
+- (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath {
+	self.heightForRowHitCount++;
+	return 10.0 * indexPath.row + indexPath.section;
+}
+
+- (NSIndexPath *)tableView:(UITableView *)tableView willSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+	return [NSIndexPath indexPathForRow:indexPath.row + 1 inSection:indexPath.section];
+}
+
+@end
+
+
+/// A controller that is responsible for more than one section.
+@interface HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController : HRSTableViewSectionCoordinatorTableViewTestsController
+
+@property (nonatomic, assign, readwrite) NSInteger sectionCount;
+
++ (instancetype)controllerWithSectionCount:(NSInteger)sectionCount;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController
+
++ (instancetype)controllerWithSectionCount:(NSInteger)sectionCount {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *controller = [self new];
+	controller.sectionCount = sectionCount;
+	return controller;
+}
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+	return self.sectionCount;
+}
+
+@end
+
+
+/// A controller that hides some of its methods at runtime.
+@interface HRSTableViewSectionCoordinatorTableViewTestsHidingController : HRSTableViewSectionCoordinatorTableViewTestsController
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsHidingController
+
+- (BOOL)respondsToSelector:(SEL)aSelector {
+	if (aSelector == @selector(tableView:heightForRowAtIndexPath:)) {
+		return NO;
+	}
+	return [super respondsToSelector:aSelector];
+}
+
+@end
+
+
+/// A controller that records the index paths it is asked to prefetch.
+@interface HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController : HRSTableViewSectionController <UITableViewDataSourcePrefetching>
+
+@property (nonatomic, strong, readwrite) NSMutableArray *prefetchedIndexPaths;
+@property (nonatomic, strong, readwrite) NSMutableArray *cancelledIndexPaths;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController
+
+- (void)tableView:(UITableView *)tableView prefetchRowsAtIndexPaths:(NSArray *)indexPaths {
+	if (self.prefetchedIndexPaths == nil) {
+		self.prefetchedIndexPaths = [NSMutableArray array];
+	}
+	[self.prefetchedIndexPaths addObject:indexPaths];
+}
+
+- (void)tableView:(UITableView *)tableView cancelPrefetchingForRowsAtIndexPaths:(NSArray *)indexPaths {
+	if (self.cancelledIndexPaths == nil) {
+		self.cancelledIndexPaths = [NSMutableArray array];
+	}
+	[self.cancelledIndexPaths addObject:indexPaths];
+}
+
+@end
+
+
+/// A controller that calls its table view while it is asked for a cell.
+@interface HRSTableViewSectionCoordinatorTableViewTestsCallingController : HRSTableViewSectionController
+
+@property (nonatomic, strong, readwrite) NSArray *visibleIndexPaths;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsCallingController
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+	self.visibleIndexPaths = [tableView indexPathsForVisibleRows];
+	return [UITableViewCell new];
+}
+
+@end
+
+
+/// A controller that inserts a section while it is asked for a cell.
+@interface HRSTableViewSectionCoordinatorTableViewTestsInsertingController : HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsInsertingController
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+	self.sectionCount++;
+	[tableView insertSections:[NSIndexSet indexSetWithIndex:self.sectionCount - 1] withRowAnimation:UITableViewRowAnimationNone];
+	return [UITableViewCell new];
+}
+
+@end
+
+
+/// An instrumentation that records the selectors of all reported calls.
+@interface HRSTableViewSectionCoordinatorTableViewTestsInstrumentation : NSObject <HRSTableViewSectionCoordinatorInstrumentation>
+
+@property (nonatomic, strong, readwrite) NSMutableArray *selectors;
+@property (nonatomic, strong, readwrite) NSMutableArray *sectionControllers;
+
+@end
+
+
+@implementation HRSTableViewSectionCoordinatorTableViewTestsInstrumentation
+
+- (instancetype)init {
+	self = [super init];
+	if (self) {
+		_selectors = [NSMutableArray array];
+		_sectionControllers = [NSMutableArray array];
+	}
+	return self;
+}
+
+- (void)sectionCoordinator:(HRSTableViewSectionCoordinator *)coordinator didCallSelector:(SEL)selector onSectionController:(id<HRSTableViewSectionController>)sectionController duration:(NSTimeInterval)duration {
+	[self.selectors addObject:NSStringFromSelector(selector)];
+	[self.sectionControllers addObject:sectionController];
+}
+
+@end
 
 
 @interface HRSTableViewSectionCoordinator (Tests)
 
 - (UITableView *)tableView;
+- (id<HRSTableViewSectionController>)sectionControllerForTableSection:(NSInteger)section beforeTransition:(BOOL)beforeTransition;
 - (id<HRSTableViewSectionController>)_sectionControllerForTableSection:(NSInteger)section beforeTransition:(BOOL)beforeTransition;
+- (void)_finishTransition;
 
 @end
 
@@ -82,77 +339,670 @@
 	
 	UITableView *tableView = [UITableView new];
 	
-	NSIndexPath *expectedIndexPath = [NSIndexPath indexPathForRow:3 inSection:1];
-	id tableViewMock = OCMPartialMock(tableView);
-	[[tableViewMock expect] cellForRowAtIndexPath:expectedIndexPath];
+	NSIndexPath *expectedIndexPath = [NSIndexPath indexPathForRow:3 inSection:1];
+	id tableViewMock = OCMPartialMock(tableView);
+	[[tableViewMock expect] cellForRowAtIndexPath:expectedIndexPath];
+	
+	[self.sut setTableView:tableViewMock];
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
+	[tableViewProxy cellForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:0]];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testProxiesAreReused {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
+	expect(tableViewProxy == [self.sut tableViewForSectionController:[sectionController lastObject]]).to.beTruthy();
+	expect(tableViewProxy == [self.sut tableViewForSectionController:[sectionController firstObject]]).to.beFalsy();
+	
+	id<HRSTableViewSectionController> controllerProxy = [self.sut sectionControllerForTableSection:1];
+	expect(controllerProxy == [self.sut sectionControllerForTableSection:1]).to.beTruthy();
+}
+
+- (void)testProxiesAreInvalidatedBySettingSectionController {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
+	[self.sut setSectionController:[sectionController reverseObjectEnumerator].allObjects animated:NO];
+	
+	expect(tableViewProxy == [self.sut tableViewForSectionController:[sectionController lastObject]]).to.beFalsy();
+}
+
+- (void)testProxiesAreInvalidatedBySettingTableView {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	id<HRSTableViewSectionController> controllerProxy = [self.sut sectionControllerForTableSection:1];
+	UITableView *otherTableView = [UITableView new];
+	[self.sut setTableView:otherTableView];
+	
+	expect(controllerProxy == [self.sut sectionControllerForTableSection:1]).to.beFalsy();
+}
+
+- (void)testProxiesDoNotKeepTableViewAlive {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	__weak UITableView *weakTableView;
+	@autoreleasepool {
+		UITableView *tableView = [UITableView new];
+		[self.sut setTableView:tableView];
+		[self.sut tableViewForSectionController:[sectionController lastObject]];
+		[self.sut sectionControllerForTableSection:1];
+		weakTableView = tableView;
+	}
+	
+	expect(weakTableView).to.beNil();
+}
+
+- (void)testCoordinatorDoesMapReturnValue {
+	NSArray *sectionController = @[ [HRSTableViewSectionCoordinatorTableViewTestsController new], [HRSTableViewSectionCoordinatorTableViewTestsController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	// the call is repeated, as the first call of a selector might take a different path
+	for (NSUInteger call = 0; call < 2; call++) {
+		NSIndexPath *indexPath = [self.sut tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]];
+		expect(indexPath).to.equal([NSIndexPath indexPathForRow:4 inSection:1]);
+	}
+}
+
+- (void)testCoordinatorDoesForwardFloatingPointReturnValue {
+	NSArray *sectionController = @[ [HRSTableViewSectionCoordinatorTableViewTestsController new], [HRSTableViewSectionCoordinatorTableViewTestsController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	for (NSUInteger call = 0; call < 2; call++) {
+		CGFloat height = [self.sut tableView:tableView heightForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]];
+		expect(height).to.equal(30.0);
+	}
+}
+
+- (void)testCustomTransformerIsMappedOnRepeatedCalls {
+	[HRSTableViewSectionTransformer registerTransformer:@selector(highlightRowAtIndexPath:) arguments:0, 1, NSNotFound];
+	
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	HRSTableViewSectionCoordinatorTableViewTestsTableView *tableView = [HRSTableViewSectionCoordinatorTableViewTestsTableView new];
+	[self.sut setTableView:tableView];
+	
+	HRSTableViewSectionCoordinatorTableViewTestsTableView *tableViewProxy = (HRSTableViewSectionCoordinatorTableViewTestsTableView *)[self.sut tableViewForSectionController:[sectionController lastObject]];
+	for (NSUInteger call = 0; call < 2; call++) {
+		NSIndexPath *indexPath = [tableViewProxy highlightRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:0]];
+		expect(tableView.lastHighlightedIndexPath).to.equal([NSIndexPath indexPathForRow:2 inSection:1]);
+		expect(indexPath).to.equal([NSIndexPath indexPathForRow:2 inSection:0]);
+	}
+}
+
+- (void)testTransitionProxyMapsReturnValueToOldSection {
+	NSArray *sectionController = @[ [HRSTableViewSectionCoordinatorTableViewTestsController new], [HRSTableViewSectionCoordinatorTableViewTestsController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	// the old section controllers stay around until the table view did relayout
+	[self.sut setSectionController:@[ [sectionController lastObject] ] animated:NO];
+	
+	id<UITableViewDelegate> transitionProxy = (id<UITableViewDelegate>)[self.sut sectionControllerForTableSection:1 beforeTransition:YES];
+	NSIndexPath *indexPath = [transitionProxy tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]];
+	expect(indexPath).to.equal([NSIndexPath indexPathForRow:4 inSection:1]);
+	
+	id<UITableViewDelegate> controllerProxy = (id<UITableViewDelegate>)[self.sut sectionControllerForTableSection:0];
+	indexPath = [controllerProxy tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:0]];
+	expect(indexPath).to.equal([NSIndexPath indexPathForRow:4 inSection:0]);
+}
+
+- (void)testCoordinatorRespondsOnlyToImplementedProtocolMethods {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionCoordinatorTableViewTestsController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	expect([self.sut respondsToSelector:@selector(tableView:heightForRowAtIndexPath:)]).to.beTruthy();
+	expect([self.sut respondsToSelector:@selector(tableView:titleForHeaderInSection:)]).to.beTruthy();
+	expect([self.sut respondsToSelector:@selector(tableView:didSelectRowAtIndexPath:)]).to.beFalsy();
+	expect([self.sut respondsToSelector:@selector(scrollViewDidZoom:)]).to.beFalsy();
+	
+	[self.sut setSectionController:@[ [sectionController firstObject] ] animated:NO];
+	
+	expect([self.sut respondsToSelector:@selector(tableView:heightForRowAtIndexPath:)]).to.beFalsy();
+}
+
+- (void)testCoordinatorRespectsDynamicRespondsToSelector {
+	NSArray *sectionController = @[ [HRSTableViewSectionCoordinatorTableViewTestsHidingController new], [HRSTableViewSectionCoordinatorTableViewTestsHidingController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	expect([self.sut respondsToSelector:@selector(tableView:heightForRowAtIndexPath:)]).to.beFalsy();
+	expect([self.sut respondsToSelector:@selector(tableView:willSelectRowAtIndexPath:)]).to.beTruthy();
+	
+	// the answers cached for the superclass are not affected by the subclass
+	[self.sut setSectionController:@[ [HRSTableViewSectionCoordinatorTableViewTestsController new] ] animated:NO];
+	
+	expect([self.sut respondsToSelector:@selector(tableView:heightForRowAtIndexPath:)]).to.beTruthy();
+}
+
+- (void)testCoordinatorOnlyForwardsToRespondingSectionController {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionCoordinatorTableViewTestsController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:3 inSection:0];
+	expect([self.sut tableView:tableView willSelectRowAtIndexPath:indexPath]).to.equal(indexPath);
+	expect([self.sut tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]]).to.equal([NSIndexPath indexPathForRow:4 inSection:1]);
+}
+
+- (void)testRowHeightsAreOnlyCachedWhenEnabled {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new], controller ] animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:3 inSection:1];
+	
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	expect(controller.heightForRowHitCount).to.equal(2);
+	
+	self.sut.rowHeightCacheEnabled = YES;
+	controller.heightForRowHitCount = 0;
+	expect([self.sut tableView:tableView heightForRowAtIndexPath:indexPath]).to.equal(30.0);
+	expect([self.sut tableView:tableView heightForRowAtIndexPath:indexPath]).to.equal(30.0);
+	expect(controller.heightForRowHitCount).to.equal(1);
+}
+
+- (void)testCachedRowHeightIsUsedAsEstimate {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ controller ] animated:NO];
+	self.sut.rowHeightCacheEnabled = YES;
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:2 inSection:0];
+	
+	expect([self.sut tableView:tableView estimatedHeightForRowAtIndexPath:indexPath]).to.equal(20.0);
+	expect([self.sut tableView:tableView estimatedHeightForRowAtIndexPath:indexPath]).to.equal(20.0);
+	expect([self.sut tableView:tableView heightForRowAtIndexPath:indexPath]).to.equal(20.0);
+	expect(controller.heightForRowHitCount).to.equal(1);
+}
+
+- (void)testSectionControllerCanInvalidateRowHeights {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ controller ] animated:NO];
+	self.sut.rowHeightCacheEnabled = YES;
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:2 inSection:0];
+	NSIndexPath *otherIndexPath = [NSIndexPath indexPathForRow:3 inSection:0];
+	
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	
+	[controller invalidateRowHeightAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	expect(controller.heightForRowHitCount).to.equal(3);
+	
+	[controller invalidateRowHeights];
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	expect(controller.heightForRowHitCount).to.equal(5);
+}
+
+- (void)testReloadingThroughProxyInvalidatesRowHeights {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new], controller ] animated:NO];
+	self.sut.rowHeightCacheEnabled = YES;
+	HRSTableViewSectionCoordinatorTableViewTestsTableView *tableView = [HRSTableViewSectionCoordinatorTableViewTestsTableView new];
+	[self.sut setTableView:tableView];
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:2 inSection:1];
+	NSIndexPath *otherIndexPath = [NSIndexPath indexPathForRow:3 inSection:1];
+	
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:controller];
+	[tableViewProxy reloadRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	expect(controller.heightForRowHitCount).to.equal(3);
+	
+	[tableViewProxy reloadSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut tableView:tableView heightForRowAtIndexPath:indexPath];
+	[self.sut tableView:tableView heightForRowAtIndexPath:otherIndexPath];
+	expect(controller.heightForRowHitCount).to.equal(5);
+}
+
+- (void)testCoordinatorOnlyRespondsToPrefetchingIfSectionControllerDoes {
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new] ] animated:NO];
+	expect([self.sut respondsToSelector:@selector(tableView:prefetchRowsAtIndexPaths:)]).to.beFalsy();
+	
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new], [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new] ] animated:NO];
+	expect([self.sut respondsToSelector:@selector(tableView:prefetchRowsAtIndexPaths:)]).to.beTruthy();
+	expect([self.sut respondsToSelector:@selector(tableView:cancelPrefetchingForRowsAtIndexPaths:)]).to.beTruthy();
+}
+
+- (void)testPrefetchingIsSplitBySectionController {
+	HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController *firstController = [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new];
+	HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController *secondController = [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new];
+	[self.sut setSectionController:@[ firstController, [HRSTableViewSectionController new], secondController ] animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	NSArray *indexPaths = @[ [NSIndexPath indexPathForRow:4 inSection:2], [NSIndexPath indexPathForRow:1 inSection:0], [NSIndexPath indexPathForRow:7 inSection:1], [NSIndexPath indexPathForRow:5 inSection:2] ];
+	[self.sut tableView:tableView prefetchRowsAtIndexPaths:indexPaths];
+	
+	expect(firstController.prefetchedIndexPaths).to.equal(@[ @[ [NSIndexPath indexPathForRow:1 inSection:0] ] ]);
+	expect(secondController.prefetchedIndexPaths).to.equal(@[ @[ [NSIndexPath indexPathForRow:4 inSection:0], [NSIndexPath indexPathForRow:5 inSection:0] ] ]);
+}
+
+- (void)testCancelPrefetchingIsSplitBySectionController {
+	HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController *controller = [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new];
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new], controller ] animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	[self.sut tableView:tableView cancelPrefetchingForRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0], [NSIndexPath indexPathForRow:3 inSection:1] ]];
+	
+	expect(controller.prefetchedIndexPaths).to.beNil();
+	expect(controller.cancelledIndexPaths).to.equal(@[ @[ [NSIndexPath indexPathForRow:3 inSection:0] ] ]);
+}
+
+- (void)testInstrumentationReportsForwardedCalls {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ [HRSTableViewSectionController new], controller ] animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	HRSTableViewSectionCoordinatorTableViewTestsInstrumentation *instrumentation = [HRSTableViewSectionCoordinatorTableViewTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	
+	[self.sut tableView:tableView heightForRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:1]];
+	[self.sut tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:1]];
+	
+	expect(instrumentation.selectors).to.equal(@[ NSStringFromSelector(@selector(tableView:heightForRowAtIndexPath:)), NSStringFromSelector(@selector(tableView:willSelectRowAtIndexPath:)) ]);
+	expect(instrumentation.sectionControllers).to.equal(@[ controller, controller ]);
+}
+
+- (void)testInstrumentationReportsPrefetchingCalls {
+	HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController *firstController = [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new];
+	HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController *secondController = [HRSTableViewSectionCoordinatorTableViewTestsPrefetchingController new];
+	[self.sut setSectionController:@[ firstController, secondController ] animated:NO];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	HRSTableViewSectionCoordinatorTableViewTestsInstrumentation *instrumentation = [HRSTableViewSectionCoordinatorTableViewTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	
+	[self.sut tableView:tableView prefetchRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:1], [NSIndexPath indexPathForRow:0 inSection:0] ]];
+	
+	// every section controller is called once
+	expect(instrumentation.selectors).to.equal(@[ NSStringFromSelector(@selector(tableView:prefetchRowsAtIndexPaths:)), NSStringFromSelector(@selector(tableView:prefetchRowsAtIndexPaths:)) ]);
+	expect(instrumentation.sectionControllers).to.equal(@[ secondController, firstController ]);
+}
+
+- (void)testInstrumentationDoesNotReportTableViewCalls {
+	HRSTableViewSectionCoordinatorTableViewTestsController *controller = [HRSTableViewSectionCoordinatorTableViewTestsController new];
+	[self.sut setSectionController:@[ controller ] animated:NO];
+	HRSTableViewSectionCoordinatorTableViewTestsTableView *tableView = [HRSTableViewSectionCoordinatorTableViewTestsTableView new];
+	[self.sut setTableView:tableView];
+	HRSTableViewSectionCoordinatorTableViewTestsInstrumentation *instrumentation = [HRSTableViewSectionCoordinatorTableViewTestsInstrumentation new];
+	self.sut.instrumentation = instrumentation;
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:controller];
+	[tableViewProxy reloadRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	
+	expect(instrumentation.selectors).to.haveCountOf(0);
+	
+	self.sut.instrumentation = nil;
+	[self.sut tableView:tableView heightForRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:0]];
+	expect(instrumentation.selectors).to.haveCountOf(0);
+}
+
+// TODO: Add reverse testing for all delegate & data source methods
+
+- (void)testCoordinatorDoesForwardToCorrectTableViewSection {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	
+	NSInteger expectedSection = 1;
+	id tableViewMock = OCMPartialMock(tableView);
+	[[tableViewMock expect] numberOfRowsInSection:expectedSection];
+	
+	[self.sut setTableView:tableViewMock];
+	
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
+	[tableViewProxy numberOfRowsInSection:0];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testSetTableViewTriggersReloadData {
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	[[tableViewMock expect] reloadData];
+	
+	[self.sut setTableView:tableViewMock];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testSetSectionControllerWithoutAnimationTriggersReloadData {
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	
+	[self.sut setTableView:tableViewMock];
+	
+	[[tableViewMock expect] reloadData];
+	
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testSetSectionControllerWithAnimationDoesNotTriggerReloadData {
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	
+	[self.sut setTableView:tableViewMock];
+	
+	[[tableViewMock reject] reloadData];
+	
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+
+
+#pragma mark - controller animations
+
+- (NSArray *)sectionControllerPool:(NSUInteger)count {
+	NSMutableArray *array = [NSMutableArray array];
+	for (NSUInteger idx = 0; idx < count; idx++) {
+		[array addObject:[HRSTableViewSectionController new]];
+	}
+	return [array copy];
+}
+
+- (void)testSimpleInsertAnimation {
+	NSArray *pool = [self sectionControllerPool:6];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = [pool subarrayWithRange:NSMakeRange(0, 5)];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = pool;
+	
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:5] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testSimpleRemoveAnimation {
+	NSArray *pool = [self sectionControllerPool:6];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = pool;
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = [pool subarrayWithRange:NSMakeRange(0, 5)];
+	
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:5] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testInsertRemoveAnimation {
+	NSArray *pool = [self sectionControllerPool:6];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[0], pool[4], pool[5], pool[2], pool[3] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testCompleteReplacement {
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableView;
+	
+	NSArray *oldController = [self sectionControllerPool:5];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = [self sectionControllerPool:3];
+	
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, oldController.count)] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, newController.count)] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testInsertAtStartAnimation {
+	NSArray *pool = [self sectionControllerPool:5];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[4], pool[0], pool[1], pool[2], pool[3] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testInsertAtEndAnimation {
+	NSArray *pool = [self sectionControllerPool:5];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3], pool[4] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:4] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testDeleteAtStartAnimation {
+	NSArray *pool = [self sectionControllerPool:5];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[4], pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testDeleteAtEndAnimation {
+	NSArray *pool = [self sectionControllerPool:5];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3], pool[4] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:4] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:newController animated:YES];
+	
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testReorderAnimationMovesSection {
+	NSArray *pool = [self sectionControllerPool:4];
+	
+	UITableView *tableView = [UITableView new];
+	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
+	
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:oldController];
+	
+	NSArray *newController = @[ pool[0], pool[2], pool[1], pool[3] ];
 	
-	[self.sut setTableView:tableViewMock];
+	[[[tableViewMock expect] andForwardToRealObject] moveSection:2 toSection:1];
+	[[tableViewMock reject] deleteSections:OCMOCK_ANY withRowAnimation:UITableViewRowAnimationNone];
+	[[tableViewMock reject] insertSections:OCMOCK_ANY withRowAnimation:UITableViewRowAnimationNone];
 	
-	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
-	[tableViewProxy cellForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:0]];
+	[self.sut setSectionController:newController animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-// TODO: Add testing for return value mapping
-// TODO: Add reverse testing (delegate & data source)
-
-- (void)testCoordinatorDoesForwardToCorrectTableViewSection {
-	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
-	[self.sut setSectionController:sectionController animated:NO];
+- (void)testMoveToStartAnimation {
+	NSArray *pool = [self sectionControllerPool:5];
 	
 	UITableView *tableView = [UITableView new];
-	
-	NSInteger expectedSection = 1;
 	id tableViewMock = OCMPartialMock(tableView);
-	[[tableViewMock expect] numberOfRowsInSection:expectedSection];
+	self.sut.tableView = tableViewMock;
 	
-	[self.sut setTableView:tableViewMock];
+	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3], pool[4] ];
+	[self.sut setSectionController:oldController];
 	
-	UITableView *tableViewProxy = [self.sut tableViewForSectionController:[sectionController lastObject]];
-	[tableViewProxy numberOfRowsInSection:0];
+	NSArray *newController = @[ pool[4], pool[0], pool[1], pool[2], pool[3] ];
+	
+	[[[tableViewMock expect] andForwardToRealObject] moveSection:4 toSection:0];
+	[[tableViewMock reject] moveSection:0 toSection:1];
+	
+	[self.sut setSectionController:newController animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testSetTableViewTriggersReloadData {
+- (void)testChangedSectionControllerIsReloaded {
+	NSArray *pool = [self sectionControllerPool:3];
+	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
-	[[tableViewMock expect] reloadData];
+	self.sut.tableView = tableViewMock;
 	
-	[self.sut setTableView:tableViewMock];
+	[self.sut setSectionController:pool];
+	[self.sut setSectionControllerNeedsReload:pool[1]];
+	
+	[[[tableViewMock expect] andForwardToRealObject] reloadSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	
+	[self.sut setSectionController:pool animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testSetSectionControllerWithoutAnimationTriggersReloadData {
+- (void)testChangedSectionControllerIsReplacedWhenMoved {
+	NSArray *pool = [self sectionControllerPool:3];
+	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
 	
-	[self.sut setTableView:tableViewMock];
+	[self.sut setSectionController:pool];
+	[self.sut setSectionControllerNeedsReload:pool[1]];
 	
-	[[tableViewMock expect] reloadData];
+	NSArray *newController = @[ pool[1], pool[0], pool[2] ];
 	
-	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
-	[self.sut setSectionController:sectionController animated:NO];
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	[[tableViewMock reject] moveSection:1 toSection:0];
+	
+	[self.sut setSectionController:newController animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testSetSectionControllerWithAnimationDoesNotTriggerReloadData {
+- (void)testReloadFlagIsClearedBySettingSectionController {
+	NSArray *pool = [self sectionControllerPool:3];
+	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
+	self.sut.tableView = tableViewMock;
 	
-	[self.sut setTableView:tableViewMock];
+	[self.sut setSectionController:pool];
+	[self.sut setSectionControllerNeedsReload:pool[1]];
+	[self.sut setSectionController:pool];
 	
-	[[tableViewMock reject] reloadData];
+	[[tableViewMock reject] reloadSections:OCMOCK_ANY withRowAnimation:UITableViewRowAnimationNone];
 	
-	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
-	[self.sut setSectionController:sectionController animated:YES];
+	[self.sut setSectionController:pool animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
@@ -160,174 +1010,666 @@
 
 
 
-#pragma mark - controller animations
 
-- (NSArray *)sectionControllerPool:(NSUInteger)count {
-	NSMutableArray *array = [NSMutableArray array];
-	for (NSUInteger idx = 0; idx < count; idx++) {
-		[array addObject:[HRSTableViewSectionController new]];
+#pragma mark - multiple sections
+
+- (void)testNumberOfSectionsSumsSectionsOfController {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:3];
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], multiSectionController, [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
+	
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(5);
+	expect([self.sut _sectionControllerForTableSection:0 beforeTransition:NO]).to.beIdenticalTo(sectionController[0]);
+	for (NSInteger section = 1; section < 4; section++) {
+		expect([self.sut _sectionControllerForTableSection:section beforeTransition:NO]).to.beIdenticalTo(multiSectionController);
 	}
-	return [array copy];
+	expect([self.sut _sectionControllerForTableSection:4 beforeTransition:NO]).to.beIdenticalTo(sectionController[2]);
+	expect([self.sut _sectionControllerForTableSection:5 beforeTransition:NO]).to.beNil();
 }
 
-- (void)testSimpleInsertAnimation {
-	NSArray *pool = [self sectionControllerPool:6];
+- (void)testControllerWithoutSectionsIsSkipped {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:0], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
 	
 	UITableView *tableView = [UITableView new];
-	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableViewMock;
+	[self.sut setTableView:tableView];
 	
-	NSArray *oldController = [pool subarrayWithRange:NSMakeRange(0, 5)];
-	[self.sut setSectionController:oldController];
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+	expect([self.sut _sectionControllerForTableSection:1 beforeTransition:NO]).to.beIdenticalTo(sectionController[2]);
+}
+
+- (void)testSectionsOfMultiSectionControllerAreMapped {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:3];
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], multiSectionController, [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
 	
-	NSArray *newController = pool;
+	expect([self.sut controllerSectionForTableViewSection:3 withController:multiSectionController]).to.equal(2);
+	expect([self.sut tableViewSectionForControllerSection:1 withController:multiSectionController]).to.equal(2);
+	expect([self.sut tableViewSectionForControllerSection:0 withController:[sectionController lastObject]]).to.equal(4);
 	
-	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:5] withRowAnimation:UITableViewRowAnimationNone];
+	NSIndexPath *controllerIndexPath = [self.sut controllerIndexPathForTableViewIndexPath:[NSIndexPath indexPathForRow:5 inSection:2] withController:multiSectionController];
+	expect(controllerIndexPath).to.equal([NSIndexPath indexPathForRow:5 inSection:1]);
+}
+
+- (void)testCoordinatorDoesMapIndexPathsOfMultiSectionController {
+	NSArray *sectionController = @[ [HRSTableViewSectionCoordinatorTableViewTestsController new], [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:3] ];
+	[self.sut setSectionController:sectionController animated:NO];
 	
-	[self.sut setSectionController:newController animated:YES];
+	UITableView *tableView = [UITableView new];
+	[self.sut setTableView:tableView];
 	
-	[tableViewMock verify];
-	[tableViewMock stopMocking];
+	for (NSUInteger call = 0; call < 2; call++) {
+		NSIndexPath *indexPath = [self.sut tableView:tableView willSelectRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:3]];
+		expect(indexPath).to.equal([NSIndexPath indexPathForRow:4 inSection:3]);
+		
+		// the controller sees the row in its third section
+		CGFloat height = [self.sut tableView:tableView heightForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:3]];
+		expect(height).to.equal(32.0);
+	}
 }
 
-- (void)testSimpleRemoveAnimation {
-	NSArray *pool = [self sectionControllerPool:6];
+- (void)testTableViewProxyOfMultiSectionControllerMapsSections {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:3];
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], multiSectionController ];
+	[self.sut setSectionController:sectionController animated:NO];
 	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableViewMock;
+	[[tableViewMock expect] cellForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:3]];
+	[self.sut setTableView:tableViewMock];
 	
-	NSArray *oldController = pool;
-	[self.sut setSectionController:oldController];
+	UITableView *tableViewProxy = [self.sut tableViewForSectionController:multiSectionController];
+	[tableViewProxy cellForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:2]];
+	expect(tableViewProxy.numberOfSections).to.equal(3);
 	
-	NSArray *newController = [pool subarrayWithRange:NSMakeRange(0, 5)];
+	[tableViewMock verify];
+	[tableViewMock stopMocking];
+}
+
+- (void)testInsertingSectionsThroughProxyMovesFollowingSections {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:1];
+	NSArray *sectionController = @[ multiSectionController, [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
 	
-	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:5] withRowAnimation:UITableViewRowAnimationNone];
+	HRSTableViewSectionCoordinatorTableViewTestsTableView *tableView = [HRSTableViewSectionCoordinatorTableViewTestsTableView new];
+	[self.sut setTableView:tableView];
+	expect([self.sut tableViewSectionForControllerSection:0 withController:[sectionController lastObject]]).to.equal(1);
 	
-	[self.sut setSectionController:newController animated:YES];
+	multiSectionController.sectionCount = 3;
+	[[self.sut tableViewForSectionController:multiSectionController] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] withRowAnimation:UITableViewRowAnimationNone];
 	
-	[tableViewMock verify];
-	[tableViewMock stopMocking];
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(4);
+	expect([self.sut tableViewSectionForControllerSection:0 withController:[sectionController lastObject]]).to.equal(3);
+	
+	multiSectionController.sectionCount = 2;
+	[self.sut invalidateNumberOfSectionsForSectionController:multiSectionController];
+	
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(3);
+	expect([self.sut _sectionControllerForTableSection:2 beforeTransition:NO]).to.beIdenticalTo([sectionController lastObject]);
 }
 
-- (void)testInsertRemoveAnimation {
-	NSArray *pool = [self sectionControllerPool:6];
+- (void)testMultiSectionControllerInsertAnimation {
+	NSArray *pool = [self sectionControllerPool:2];
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:2];
 	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
 	self.sut.tableView = tableViewMock;
 	
-	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
-	[self.sut setSectionController:oldController];
-	
-	NSArray *newController = @[ pool[0], pool[4], pool[5], pool[2], pool[3] ];
+	[self.sut setSectionController:pool];
 	
-	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
 	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] withRowAnimation:UITableViewRowAnimationNone];
 	
-	[self.sut setSectionController:newController animated:YES];
+	[self.sut setSectionController:@[ pool[0], multiSectionController, pool[1] ] animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testCompleteReplacement {
+- (void)testMultiSectionControllerMoveAnimationMovesAllSections {
+	NSArray *pool = [self sectionControllerPool:2];
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:2];
+	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableView;
-	
-	NSArray *oldController = [self sectionControllerPool:5];
-	[self.sut setSectionController:oldController];
+	self.sut.tableView = tableViewMock;
 	
-	NSArray *newController = [self sectionControllerPool:3];
+	[self.sut setSectionController:@[ multiSectionController, pool[0], pool[1] ]];
 	
-	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, oldController.count)] withRowAnimation:UITableViewRowAnimationNone];
-	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, newController.count)] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] moveSection:0 toSection:2];
+	[[[tableViewMock expect] andForwardToRealObject] moveSection:1 toSection:3];
+	[[tableViewMock reject] insertSections:OCMOCK_ANY withRowAnimation:UITableViewRowAnimationNone];
 	
-	[self.sut setSectionController:newController animated:YES];
+	[self.sut setSectionController:@[ pool[0], pool[1], multiSectionController ] animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testInsertAtStartAnimation {
-	NSArray *pool = [self sectionControllerPool:5];
+- (void)testChangedNumberOfSectionsReplacesSectionsOfController {
+	NSArray *pool = [self sectionControllerPool:2];
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:1];
 	
 	UITableView *tableView = [UITableView new];
 	id tableViewMock = OCMPartialMock(tableView);
 	self.sut.tableView = tableViewMock;
 	
-	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
-	[self.sut setSectionController:oldController];
-	
-	NSArray *newController = @[ pool[4], pool[0], pool[1], pool[2], pool[3] ];
+	NSArray *sectionController = @[ pool[0], multiSectionController, pool[1] ];
+	[self.sut setSectionController:sectionController];
+	multiSectionController.sectionCount = 2;
 	
-	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] withRowAnimation:UITableViewRowAnimationNone];
 	
-	[self.sut setSectionController:newController animated:YES];
+	[self.sut setSectionController:sectionController animated:YES];
 	
 	[tableViewMock verify];
 	[tableViewMock stopMocking];
 }
 
-- (void)testInsertAtEndAnimation {
-	NSArray *pool = [self sectionControllerPool:5];
+
+
+
+#pragma mark - coalesced updates
+
+/// Sets the section controllers and returns a table view that records the
+/// updates it receives afterwards.
+- (HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *)recordingTableViewWithSectionController:(NSArray *)sectionController {
+	[self.sut setSectionController:sectionController animated:NO];
 	
-	UITableView *tableView = [UITableView new];
-	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableViewMock;
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView new];
+	[self.sut setTableView:tableView];
+	[tableView.updates removeAllObjects];
+	return tableView;
+}
+
+- (void)testUpdatesAreForwardedImmediatelyWithoutCoalescing {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
 	
-	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3] ];
-	[self.sut setSectionController:oldController];
+	[[self.sut tableViewForSectionController:sectionController[1]] insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
 	
-	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3], pool[4] ];
+	expect(tableView.updates).to.equal(@[ @[ @"insertRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:2 inSection:1] ] ] ]);
+}
+
+- (void)testCoalescedUpdatesAreAppliedInOneBatch {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	UITableView *firstTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	UITableView *secondTableView = [self.sut tableViewForSectionController:sectionController[1]];
+	[secondTableView beginUpdates];
+	[secondTableView reloadRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[secondTableView endUpdates];
+	[firstTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	expect(tableView.updates).to.haveCountOf(0);
+	
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"insertRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:0 inSection:0] ] ],
+		@[ @"reloadRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:2 inSection:1] ] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+}
+
+- (void)testCoalescedRowUpdatesAreRebased {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:1 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	// the row that was at index 2 before the first update
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:1 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	// moves the row inserted before to index 1
+	[controllerTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"deleteRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:1 inSection:0], [NSIndexPath indexPathForRow:2 inSection:0] ] ],
+		@[ @"insertRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:0 inSection:0], [NSIndexPath indexPathForRow:1 inSection:0] ] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+}
+
+- (void)testCoalescedRowUpdatesInsideUpdateBlockAreNotRebased {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	// inside of a block, all rows are based on the rows before the block
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	[controllerTableView beginUpdates];
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:1 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView reloadRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:3 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView endUpdates];
+	// the row that was at index 4 before the block
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:2 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"deleteRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:1 inSection:0], [NSIndexPath indexPathForRow:2 inSection:0], [NSIndexPath indexPathForRow:4 inSection:0] ] ],
+		@[ @"reloadRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:3 inSection:0] ] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+}
+
+- (void)testCoalescedSectionUpdatesInsideUpdateBlockAreNotRebased {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:3];
+	NSArray *sectionController = @[ multiSectionController ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	multiSectionController.sectionCount = 1;
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:multiSectionController];
+	[controllerTableView beginUpdates];
+	[controllerTableView deleteSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView deleteSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView reloadSections:[NSIndexSet indexSetWithIndex:2] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView endUpdates];
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"deleteSections:withRowAnimation:", [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)] ],
+		@[ @"reloadSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:2] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+}
+
+- (void)testCallingTableViewInsideUpdateBlockDoesNotApplyCoalescedUpdates {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	[controllerTableView beginUpdates];
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView indexPathsForVisibleRows];
+	expect(tableView.updates).to.haveCountOf(0);
+	
+	[controllerTableView endUpdates];
+	[controllerTableView indexPathsForVisibleRows];
+	expect(tableView.updates).to.haveCountOf(3);
+}
+
+- (void)testConflictingCoalescedUpdatesReloadSectionsOfController {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[1]];
+	[controllerTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView deleteRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"reloadSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+}
+
+- (void)testCoalescedSectionUpdatesAreMappedBeforeAndAfterBatch {
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:1];
+	NSArray *sectionController = @[ multiSectionController, [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	multiSectionController.sectionCount = 2;
+	[[self.sut tableViewForSectionController:multiSectionController] insertSections:[NSIndexSet indexSetWithIndex:1] withRowAnimation:UITableViewRowAnimationNone];
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
 	
-	[[[tableViewMock expect] andForwardToRealObject] insertSections:[NSIndexSet indexSetWithIndex:4] withRowAnimation:UITableViewRowAnimationNone];
+	// reloaded rows are based on the sections before the batch
+	[[self.sut tableViewForSectionController:sectionController[1]] reloadRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut applyPendingTableViewUpdates];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"insertSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ],
+		@[ @"reloadRowsAtIndexPaths:withRowAnimation:", @[ [NSIndexPath indexPathForRow:0 inSection:1] ] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(3);
+}
+
+- (void)testSectionsInsertedWhileHandlingCallbackAreUsedAfterBatch {
+	HRSTableViewSectionCoordinatorTableViewTestsInsertingController *insertingController = [HRSTableViewSectionCoordinatorTableViewTestsInsertingController controllerWithSectionCount:1];
+	NSArray *sectionController = @[ insertingController, [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
 	
-	[self.sut setSectionController:newController animated:YES];
+	[self.sut tableView:tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:0]];
 	
-	[tableViewMock verify];
-	[tableViewMock stopMocking];
+	// the table view has not received the insert yet
+	expect(tableView.updates).to.haveCountOf(0);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+	expect([self.sut _sectionControllerForTableSection:1 beforeTransition:NO]).to.beIdenticalTo(sectionController[1]);
+	expect([self.sut tableViewSectionForControllerSection:0 withController:sectionController[1]]).to.equal(1);
+	
+	[self.sut applyPendingTableViewUpdates];
+	
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(3);
+	expect([self.sut _sectionControllerForTableSection:2 beforeTransition:NO]).to.beIdenticalTo(sectionController[1]);
+	expect([self.sut tableViewSectionForControllerSection:0 withController:sectionController[1]]).to.equal(2);
 }
 
-- (void)testDeleteAtStartAnimation {
-	NSArray *pool = [self sectionControllerPool:5];
+- (void)testCallingTableViewAppliesCoalescedUpdates {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
 	
-	UITableView *tableView = [UITableView new];
-	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableViewMock;
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	[controllerTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView indexPathsForVisibleRows];
 	
-	NSArray *oldController = @[ pool[4], pool[0], pool[1], pool[2], pool[3] ];
-	[self.sut setSectionController:oldController];
+	expect(tableView.updates).to.haveCountOf(3);
+	expect([tableView.updates lastObject]).to.equal(@[ @"endUpdates" ]);
+}
+
+- (void)testCallingTableViewWhileHandlingCallbackDoesNotApplyCoalescedUpdates {
+	HRSTableViewSectionCoordinatorTableViewTestsCallingController *controller = [HRSTableViewSectionCoordinatorTableViewTestsCallingController new];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ controller ]];
+	self.sut.updateCoalescingEnabled = YES;
 	
-	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[[self.sut tableViewForSectionController:controller] insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[self.sut tableView:tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:0]];
 	
-	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	expect(controller.visibleIndexPaths).notTo.beNil();
+	expect(tableView.updates).to.haveCountOf(0);
 	
-	[self.sut setSectionController:newController animated:YES];
+	// the callback is over, so calls apply the updates again
+	[[self.sut tableViewForSectionController:controller] indexPathsForVisibleRows];
+	expect(tableView.updates).to.haveCountOf(3);
+}
+
+- (void)testReloadDataDropsCoalescedUpdates {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
 	
-	[tableViewMock verify];
-	[tableViewMock stopMocking];
+	UITableView *controllerTableView = [self.sut tableViewForSectionController:sectionController[0]];
+	[controllerTableView insertRowsAtIndexPaths:@[ [NSIndexPath indexPathForRow:0 inSection:0] ] withRowAnimation:UITableViewRowAnimationNone];
+	[controllerTableView reloadData];
+	[self.sut applyPendingTableViewUpdates];
+	
+	expect(tableView.updates).to.equal(@[ @[ @"reloadData" ] ]);
 }
 
-- (void)testDeleteAtEndAnimation {
-	NSArray *pool = [self sectionControllerPool:5];
+- (void)testDisablingCoalescingAppliesPendingUpdates {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
 	
-	UITableView *tableView = [UITableView new];
-	id tableViewMock = OCMPartialMock(tableView);
-	self.sut.tableView = tableViewMock;
+	[[self.sut tableViewForSectionController:sectionController[0]] reloadSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	self.sut.updateCoalescingEnabled = NO;
 	
-	NSArray *oldController = @[ pool[0], pool[1], pool[2], pool[3], pool[4] ];
-	[self.sut setSectionController:oldController];
+	expect(tableView.updates).to.haveCountOf(3);
+}
+
+- (void)testCoalescedUpdatesAreAppliedAtEndOfRunLoopTurn {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new] ];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:sectionController];
+	self.sut.updateCoalescingEnabled = YES;
+	
+	[[self.sut tableViewForSectionController:sectionController[0]] moveRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:0] toIndexPath:[NSIndexPath indexPathForRow:3 inSection:0]];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"moveRowAtIndexPath:toIndexPath:", [NSIndexPath indexPathForRow:0 inSection:0], [NSIndexPath indexPathForRow:3 inSection:0] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).will.equal(updates);
+}
+
+
+
+#pragma mark - scheduled transitions
+
+- (void)testAnimatedChangeDuringTransitionIsScheduled {
+	NSArray *pool = [self sectionControllerPool:3];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0] ]];
+	
+	[self.sut setSectionController:@[ pool[0], pool[1] ] animated:YES];
+	[self.sut setSectionController:pool animated:YES];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"insertSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+	expect(self.sut.sectionController).to.equal(pool);
+}
+
+- (void)testScheduledChangesAreCollapsedIntoOneTransition {
+	NSArray *pool = [self sectionControllerPool:3];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0] ]];
+	
+	[self.sut setSectionController:@[ pool[0], pool[1] ] animated:YES];
+	[tableView.updates removeAllObjects];
+	[self.sut setSectionController:pool animated:YES];
+	[self.sut setSectionController:@[ pool[0], pool[2] ] animated:YES];
+	[self.sut _finishTransition];
+	
+	// the intermediate list is skipped
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"insertSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ],
+		@[ @"deleteSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+	expect([self.sut _sectionControllerForTableSection:1 beforeTransition:NO]).to.beIdenticalTo(pool[2]);
+	expect([self.sut _sectionControllerForTableSection:1 beforeTransition:YES]).to.beIdenticalTo(pool[1]);
+}
+
+- (void)testScheduledTransitionStartsWhenAnimationFinishes {
+	NSArray *pool = [self sectionControllerPool:3];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0] ]];
 	
-	NSArray *newController = @[ pool[0], pool[1], pool[2], pool[3] ];
+	[self.sut setSectionController:@[ pool[0], pool[1] ] animated:YES];
+	[self.sut setSectionController:pool animated:YES];
 	
-	[[[tableViewMock expect] andForwardToRealObject] deleteSections:[NSIndexSet indexSetWithIndex:4] withRowAnimation:UITableViewRowAnimationNone];
+	expect([self.sut numberOfSectionsInTableView:tableView]).will.equal(3);
+	expect(tableView.updates).to.haveCountOf(6);
+}
+
+- (void)testChangeWithoutAnimationDropsScheduledChange {
+	NSArray *pool = [self sectionControllerPool:3];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0] ]];
+	
+	[self.sut setSectionController:@[ pool[0], pool[1] ] animated:YES];
+	[self.sut setSectionController:pool animated:YES];
+	[self.sut setSectionController:@[ pool[2] ] animated:NO];
+	[tableView.updates removeAllObjects];
+	[self.sut _finishTransition];
+	
+	expect(tableView.updates).to.haveCountOf(0);
+	expect(self.sut.sectionController).to.equal(@[ pool[2] ]);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(1);
+}
+
+
+
+#pragma mark - visibility conditions
+
+- (void)testHiddenSectionControllerIsSkipped {
+	NSArray *pool = [self sectionControllerPool:3];
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return NO;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:pool];
 	
-	[self.sut setSectionController:newController animated:YES];
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+	expect([self.sut _sectionControllerForTableSection:1 beforeTransition:NO]).to.beIdenticalTo(pool[2]);
+	expect([self.sut isSectionControllerVisible:pool[1]]).to.beFalsy();
+	expect([pool[1] coordinator]).to.beIdenticalTo(self.sut);
+}
+
+- (void)testShowingSectionControllerInsertsItsSections {
+	NSArray *pool = [self sectionControllerPool:3];
+	__block BOOL visible = NO;
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return visible;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:pool];
+	
+	visible = YES;
+	[self.sut invalidateVisibilityOfSectionController:pool[1]];
+	
+	expect(tableView.updates).to.equal(@[ @[ @"insertSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ] ]);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(3);
+	expect([self.sut isSectionControllerVisible:pool[1]]).to.beTruthy();
+}
+
+- (void)testHidingSectionControllerDeletesAllOfItsSections {
+	NSArray *pool = [self sectionControllerPool:2];
+	HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController *multiSectionController = [HRSTableViewSectionCoordinatorTableViewTestsMultiSectionController controllerWithSectionCount:2];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0], multiSectionController, pool[1] ]];
 	
-	[tableViewMock verify];
-	[tableViewMock stopMocking];
+	[self.sut setVisibilityConditionForSectionController:multiSectionController predicate:[NSPredicate predicateWithValue:NO] evaluationObject:multiSectionController];
+	
+	expect(tableView.updates).to.equal(@[ @[ @"deleteSections:withRowAnimation:", [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] ] ]);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+}
+
+- (void)testUnchangedVisibilityDoesNotUpdateTableView {
+	NSArray *pool = [self sectionControllerPool:2];
+	[self.sut setVisibilityConditionForSectionController:pool[0] condition:^BOOL{
+		return NO;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:pool];
+	
+	[self.sut invalidateVisibilityOfSectionController:pool[0]];
+	
+	expect(tableView.updates).to.haveCountOf(0);
+}
+
+- (void)testIndexPathMappingSkipsHiddenSectionController {
+	NSArray *pool = [self sectionControllerPool:3];
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setSectionController:pool];
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathForRow:2 inSection:0];
+	expect([self.sut tableViewSectionForControllerSection:0 withController:pool[1]]).to.equal(NSNotFound);
+	expect([self.sut tableViewIndexPathForControllerIndexPath:indexPath withController:pool[1]]).to.beNil();
+	expect([self.sut tableViewIndexPathForControllerIndexPath:indexPath withController:pool[2]]).to.equal([NSIndexPath indexPathForRow:2 inSection:1]);
+	expect([self.sut controllerSectionForTableViewSection:1 withController:pool[2]]).to.equal(0);
+}
+
+- (void)testUpdatesOfHiddenSectionControllerAreDropped {
+	NSArray *pool = [self sectionControllerPool:2];
+	[self.sut setVisibilityConditionForSectionController:pool[0] condition:^BOOL{
+		return NO;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:pool];
+	
+	[[self.sut tableViewForSectionController:pool[0]] reloadSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	[[self.sut tableViewForSectionController:pool[1]] reloadSections:[NSIndexSet indexSetWithIndex:0] withRowAnimation:UITableViewRowAnimationNone];
+	
+	expect(tableView.updates).to.equal(@[ @[ @"reloadSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:0] ] ]);
+}
+
+- (void)testChangingSectionControllerKeepsEvaluatedConditions {
+	NSArray *pool = [self sectionControllerPool:4];
+	__block NSUInteger evaluations = 0;
+	[self.sut setVisibilityConditionForSectionController:pool[0] condition:^BOOL{
+		evaluations++;
+		return NO;
+	}];
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		evaluations++;
+		return NO;
+	}];
+	[self.sut setSectionController:@[ pool[0], pool[1], pool[2] ]];
+	expect(evaluations).to.equal(2);
+	
+	// only the condition of the moved controller is evaluated again
+	[self.sut setSectionController:@[ pool[0], pool[2], pool[1], pool[3] ]];
+	
+	expect(evaluations).to.equal(3);
+	expect([self.sut isSectionControllerVisible:pool[0]]).to.beFalsy();
+	expect([self.sut isSectionControllerVisible:pool[1]]).to.beFalsy();
+	expect([self.sut isSectionControllerVisible:pool[2]]).to.beTruthy();
+}
+
+- (void)testRemovingSectionControllerDropsItsCondition {
+	NSArray *pool = [self sectionControllerPool:2];
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return NO;
+	}];
+	[self.sut setSectionController:pool];
+	[self.sut setSectionController:@[ pool[0] ]];
+	[self.sut setSectionController:pool];
+	
+	expect([self.sut isSectionControllerVisible:pool[1]]).to.beTruthy();
+}
+
+- (void)testVisibilityChangeDuringTransitionIsDeferred {
+	NSArray *pool = [self sectionControllerPool:3];
+	__block BOOL visible = YES;
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return visible;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0], pool[1] ]];
+	
+	[self.sut setSectionController:pool animated:YES];
+	[tableView.updates removeAllObjects];
+	visible = NO;
+	[self.sut invalidateVisibilityOfSectionController:pool[1]];
+	
+	expect(tableView.updates).to.haveCountOf(0);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(3);
+	
+	[self.sut _finishTransition];
+	
+	expect(tableView.updates).to.equal(@[ @[ @"deleteSections:withRowAnimation:", [NSIndexSet indexSetWithIndex:1] ] ]);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(2);
+	expect([self.sut isSectionControllerVisible:pool[1]]).to.beFalsy();
+}
+
+- (void)testVisibilityChangeDuringTransitionIsPartOfScheduledTransition {
+	NSArray *pool = [self sectionControllerPool:3];
+	__block BOOL visible = YES;
+	[self.sut setVisibilityConditionForSectionController:pool[1] condition:^BOOL{
+		return visible;
+	}];
+	HRSTableViewSectionCoordinatorTableViewTestsRecordingTableView *tableView = [self recordingTableViewWithSectionController:@[ pool[0], pool[1] ]];
+	
+	[self.sut setSectionController:pool animated:YES];
+	visible = NO;
+	[self.sut invalidateVisibilityOfSectionController:pool[1]];
+	[self.sut setSectionController:@[ pool[0], pool[1] ] animated:YES];
+	[tableView.updates removeAllObjects];
+	[self.sut _finishTransition];
+	
+	NSArray *updates = @[
+		@[ @"beginUpdates" ],
+		@[ @"deleteSections:withRowAnimation:", [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)] ],
+		@[ @"endUpdates" ]
+	];
+	expect(tableView.updates).to.equal(updates);
+	expect([self.sut numberOfSectionsInTableView:tableView]).to.equal(1);
 }
 
 @end
@@ -166,6 +166,19 @@
 	expect(tableIndexPath.section).to.equal(1);
 }
 
+- (void)testSectionMappingFollowsReorderedSectionController {
+	NSArray *sectionController = @[ [HRSTableViewSectionController new], [HRSTableViewSectionController new], [HRSTableViewSectionController new] ];
+	[self.sut setSectionController:sectionController animated:NO];
+	
+	expect([self.sut tableViewSectionForControllerSection:0 withController:[sectionController firstObject]]).to.equal(0);
+	expect([self.sut controllerSectionForTableViewSection:2 withController:[sectionController lastObject]]).to.equal(0);
+	
+	[self.sut setSectionController:[sectionController reverseObjectEnumerator].allObjects animated:NO];
+	
+	expect([self.sut tableViewSectionForControllerSection:0 withController:[sectionController firstObject]]).to.equal(2);
+	expect([self.sut controllerSectionForTableViewSection:2 withController:[sectionController lastObject]]).to.equal(2);
+}
+
 /**
  This was a bug that occured, when a section controller that already was
  attached to the coordinator was set a second time inside `setSectionController:`
@@ -12,6 +12,8 @@
 //	limitations under the License.
 //
 
+#import <UIKit/UIKit.h>
+
 #import "HRSIndexPathMapper.h"
 
 
@@ -140,6 +142,79 @@
  */
 - (void)removeConditionForRow:(NSInteger)row inSection:(NSInteger)section;
 
+/**
+ Sets a block condition for a range of rows in the passed-in section while
+ overwriting possible previous conditions for these rows.
+ 
+ This is a convenience method for working with `UITableView`s. You use this
+ method when controlling a large number of consecutive rows that share the
+ same condition, e.g. rows that are only shown in an expanded state. The rows
+ are stored as a single range, so the mapping does not slow down with the
+ number of rows.
+ 
+ @see setConditionForIndexRange:atIndexPath:condition:
+ 
+ @param rows      The range of rows you want to add a condition to.
+ @param section   The section of the rows in question.
+ @param condition The condition block that should be evaluated to determine the
+                  visibility status of these rows.
+ */
+- (void)setConditionForRowRange:(NSRange)rows inSection:(NSInteger)section condition:(BOOL(^)(void))condition;
+
+/**
+ Sets a predicate condition for a range of rows in the passed-in section while
+ overwriting possible previous conditions for these rows.
+ 
+ @see setConditionForIndexRange:atIndexPath:predicate:evaluationObject:
+ 
+ @param rows      The range of rows you want to add a condition to.
+ @param section   The section of the rows in question.
+ @param predicate The predicate that describes the condition.
+ @param object    The object the predicate should be evaluated on.
+ */
+- (void)setConditionForRowRange:(NSRange)rows inSection:(NSInteger)section predicate:(NSPredicate *)predicate evaluationObject:(id)object;
+
+/**
+ Removes the conditions for a range of rows in the passed-in section.
+ 
+ This makes the rows fall back to the default `YES` behaviour, no matter if
+ their conditions were set for single rows or for a range.
+ 
+ @param rows    The range of rows you want to remove the conditions from.
+ @param section The section of the rows in question.
+ */
+- (void)removeConditionForRowRange:(NSRange)rows inSection:(NSInteger)section;
+
+/**
+ Returns the number of rows of the passed-in section that are visible inside
+ the table view.
+ 
+ This is a convenience method for implementing
+ `-tableView:numberOfRowsInSection:`. Map the section the table view asks for
+ to its static section and pass the number of rows of your model as `total`.
+ 
+ @see numberOfVisibleIndexesOfTotal:atIndexPath:
+ 
+ @param section The static section of the rows in question.
+ @param total   The number of static rows in the section.
+ 
+ @return The number of visible rows or 0 if the section itself is not visible.
+ */
+- (NSInteger)numberOfRowsInSection:(NSInteger)section total:(NSInteger)total;
+
+/**
+ Returns the number of sections that are visible inside the table view.
+ 
+ This is a convenience method for implementing `-numberOfSectionsInTableView:`.
+ 
+ @see numberOfVisibleIndexesOfTotal:atIndexPath:
+ 
+ @param total The number of static sections.
+ 
+ @return The number of visible sections.
+ */
+- (NSInteger)numberOfSectionsOfTotal:(NSInteger)total;
+
 /**
  Return the dynamically, mapped section for a certain static section by taking
  all conditions into account that are relevant for the section in question.
@@ -162,4 +237,35 @@
  */
 - (NSInteger)staticSectionForDynamicSection:(NSInteger)section;
 
+/**
+ Performs a batch of condition changes and splits the resulting changes into
+ sections and rows.
+ 
+ Index paths of length 1 are reported as sections, index paths of length 2 as
+ rows. Conditions that are more detailed than a section and a row are ignored.
+ 
+ @see performUpdates:changes:
+ 
+ @param updates A block that changes conditions.
+ @param changes A block that is called synchronously with the deleted and
+                inserted sections and rows.
+ */
+- (void)performUpdates:(void(^)(void))updates sectionChanges:(void(^)(NSIndexSet *deletedSections, NSIndexSet *insertedSections, NSArray *deletedRows, NSArray *insertedRows))changes;
+
+/**
+ Performs a batch of condition changes and animates the resulting changes in
+ the passed in table view.
+ 
+ The table view is updated with a single `beginUpdates`/`endUpdates` block,
+ deleting and inserting only the sections and rows that changed their
+ visibility. Nothing is reloaded.
+ 
+ @see performUpdates:sectionChanges:
+ 
+ @param updates   A block that changes conditions.
+ @param tableView The table view that displays the dynamic index paths.
+ @param animation The animation used to insert and delete sections and rows.
+ */
+- (void)performUpdates:(void(^)(void))updates tableView:(UITableView *)tableView rowAnimation:(UITableViewRowAnimation)animation;
+
 @end
@@ -53,6 +53,21 @@
 	[self removeConditionForIndexPath:indexPath descendant:YES];
 }
 
+- (void)setConditionForRowRange:(NSRange)rows inSection:(NSInteger)section condition:(BOOL(^)(void))condition {
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+	[self setConditionForIndexRange:rows atIndexPath:indexPath condition:condition];
+}
+
+- (void)setConditionForRowRange:(NSRange)rows inSection:(NSInteger)section predicate:(NSPredicate *)predicate evaluationObject:(id)object {
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+	[self setConditionForIndexRange:rows atIndexPath:indexPath predicate:predicate evaluationObject:object];
+}
+
+- (void)removeConditionForRowRange:(NSRange)rows inSection:(NSInteger)section {
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+	[self removeConditionForIndexRange:rows atIndexPath:indexPath];
+}
+
 
 
 #pragma mark - evaluation
@@ -69,4 +84,70 @@
 	return [staticIndexPath section];
 }
 
+- (NSInteger)numberOfRowsInSection:(NSInteger)section total:(NSInteger)total {
+	NSParameterAssert(total >= 0);
+	if (total < 0) {
+		return 0;
+	}
+	
+	NSIndexPath *indexPath = [NSIndexPath indexPathWithIndex:section];
+	return [self numberOfVisibleIndexesOfTotal:total atIndexPath:indexPath];
+}
+
+- (NSInteger)numberOfSectionsOfTotal:(NSInteger)total {
+	NSParameterAssert(total >= 0);
+	if (total < 0) {
+		return 0;
+	}
+	
+	return [self numberOfVisibleIndexesOfTotal:total atIndexPath:[NSIndexPath new]];
+}
+
+
+
+#pragma mark - updates
+
+- (void)performUpdates:(void(^)(void))updates sectionChanges:(void(^)(NSIndexSet *deletedSections, NSIndexSet *insertedSections, NSArray *deletedRows, NSArray *insertedRows))changes {
+	[self performUpdates:updates changes:^(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths) {
+		NSMutableIndexSet *deletedSections = [NSMutableIndexSet indexSet];
+		NSMutableArray *deletedRows = [NSMutableArray array];
+		for (NSIndexPath *indexPath in deletedIndexPaths) {
+			if (indexPath.length == 1) {
+				[deletedSections addIndex:[indexPath indexAtPosition:0]];
+			} else if (indexPath.length == 2) {
+				[deletedRows addObject:indexPath];
+			}
+		}
+		
+		NSMutableIndexSet *insertedSections = [NSMutableIndexSet indexSet];
+		NSMutableArray *insertedRows = [NSMutableArray array];
+		for (NSIndexPath *indexPath in insertedIndexPaths) {
+			if (indexPath.length == 1) {
+				[insertedSections addIndex:[indexPath indexAtPosition:0]];
+			} else if (indexPath.length == 2) {
+				[insertedRows addObject:indexPath];
+			}
+		}
+		
+		if (changes) {
+			changes([deletedSections copy], [insertedSections copy], [deletedRows copy], [insertedRows copy]);
+		}
+	}];
+}
+
+- (void)performUpdates:(void(^)(void))updates tableView:(UITableView *)tableView rowAnimation:(UITableViewRowAnimation)animation {
+	[self performUpdates:updates sectionChanges:^(NSIndexSet *deletedSections, NSIndexSet *insertedSections, NSArray *deletedRows, NSArray *insertedRows) {
+		if (deletedSections.count == 0 && insertedSections.count == 0 && deletedRows.count == 0 && insertedRows.count == 0) {
+			return;
+		}
+		
+		[tableView beginUpdates];
+		[tableView deleteSections:deletedSections withRowAnimation:animation];
+		[tableView deleteRowsAtIndexPaths:deletedRows withRowAnimation:animation];
+		[tableView insertSections:insertedSections withRowAnimation:animation];
+		[tableView insertRowsAtIndexPaths:insertedRows withRowAnimation:animation];
+		[tableView endUpdates];
+	}];
+}
+
 @end
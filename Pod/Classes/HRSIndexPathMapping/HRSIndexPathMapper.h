@@ -14,6 +14,35 @@
 
 #import <Foundation/Foundation.h>
 
+@class HRSIndexPathMapper;
+@class HRSIndexPathMapperSnapshot;
+
+
+/**
+ An object that is informed about every condition a mapper evaluates.
+ 
+ Use this to find out which conditions are expensive, e.g. while profiling a
+ table view that does not scroll smoothly. Counting the calls per index path
+ gives the number of evaluations, summing up their durations gives the time
+ spent in each condition.
+ 
+ @see HRSIndexPathMapper.instrumentation
+ */
+@protocol HRSIndexPathMapperInstrumentation <NSObject>
+
+/**
+ Called after the mapper evaluated the condition of an index path.
+ 
+ @param mapper    The mapper that evaluated the condition.
+ @param indexPath The index path the condition belongs to.
+ @param result    The result of the condition.
+ @param duration  The time the evaluation took, in seconds.
+ */
+- (void)indexPathMapper:(HRSIndexPathMapper *)mapper didEvaluateConditionForIndexPath:(NSIndexPath *)indexPath result:(BOOL)result duration:(NSTimeInterval)duration;
+
+@end
+
+
 /**
  HRSIndexPathMapper is responsible for mapping a various number of index pathes
  from a static list to a dynamic list, based on a condition.
@@ -49,10 +78,73 @@
        events that result in reevaluating the index pathes is up to you. This
        means that e.g. in the context of a table view, you are responsible for
        calling `insertSections:withRowAnimation:` and
-       `deleteSections:withRowAnimation:` at the right time!
+       `deleteSections:withRowAnimation:` at the right time! Wrapping your
+       changes in `performUpdates:changes:` calculates these calls for you.
  */
 @interface HRSIndexPathMapper : NSObject
 
+/**
+ Specifies if the mapper evaluates its conditions once and reuses the results
+ for all subsequent mappings.
+ 
+ By default every mapping call evaluates all conditions that are relevant for
+ the index path in question. With a large number of conditions this adds up
+ quickly, e.g. when mapping an index path for every cell of a table view.
+ 
+ If you enable snapshots, the mapper evaluates the conditions of a level only
+ once and stores the results together with the number of hidden indexes in
+ front of each condition. Mapping in both directions is then a binary search
+ until the snapshot is invalidated.
+ 
+ Setting or removing a condition invalidates the snapshot of the affected level
+ automatically. However, the mapper can not know when the outcome of a
+ condition changes. If you enable snapshots, you are responsible for calling
+ `invalidateConditionForIndexPath:` or `invalidateAll` whenever this happens,
+ unless the mapper observes the evaluation objects.
+ 
+ The default value is `NO`. Changing this value discards the current snapshot.
+ 
+ @see observesEvaluationObjects
+ */
+@property (nonatomic, assign, readwrite, getter=isSnapshotEnabled) BOOL snapshotEnabled;
+
+/**
+ Specifies if the mapper observes the evaluation objects of its predicate
+ conditions using key value observing.
+ 
+ If this is set to `YES`, the mapper collects the key paths that are referenced
+ by a predicate passed to `setConditionForIndexPath:predicate:evaluationObject:`
+ and observes them on the evaluation object. Once one of these values changes,
+ only the condition of this index path is invalidated. Together with
+ `snapshotEnabled` this means that mapping calls reuse the evaluated results and
+ only conditions that actually changed are evaluated again.
+ 
+ Block conditions and predicates created with a block do not reference any key
+ paths and therefore still need to be invalidated explicitly.
+ 
+ The default value is `NO`.
+ 
+ @note The evaluation object is not retained by the mapper. If you enable
+       observation, the evaluation object must outlive the condition, or the
+       condition must be removed before the evaluation object is deallocated.
+       Otherwise the evaluation object is deallocated while it is still
+       observed.
+ */
+@property (nonatomic, assign, readwrite) BOOL observesEvaluationObjects;
+
+/**
+ An object that is informed about every condition the mapper evaluates.
+ 
+ Conditions that are not evaluated, e.g. because their result is taken from a
+ snapshot, are not reported.
+ 
+ The default value is `nil`. As long as the mapper has no instrumentation,
+ evaluating one of its conditions does not do any additional work beyond a
+ single check, regardless of the instrumentation of other mappers, so this can
+ stay in production code.
+ */
+@property (nonatomic, weak, readwrite) id<HRSIndexPathMapperInstrumentation> instrumentation;
+
 /**
  Sets a block condition for a given index path while overwriting possible
  previous conditions.
@@ -63,6 +155,13 @@
  set for index path '1'. If this condition would return NO, this would result in
  the following list: '0-0', '0-1'.
  
+ The block is stored as is and invoked directly whenever the condition is
+ evaluated.
+ 
+ @note If the condition is NULL, this method behaves as
+       `removeConditionForIndexPath:descendant:` with the descendant parameter
+       set to `NO`.
+ 
  @param indexPath The index path the condition belongs to.
  @param condition A block that evaluates the condition for this index path.
                   The block should return YES if the index path is active or NO
@@ -84,6 +183,11 @@
  path evaluation. You can pass in any object that responds to the key path / key
  paths you specified in your predicate.
  
+ Predicates created with `+[NSPredicate predicateWithValue:]` are folded into a
+ constant when they are set. Simple comparisons of a single `BOOL` key with
+ `YES` or `NO`, e.g. `enabled == YES`, are evaluated by calling the getter of
+ the evaluation object directly.
+ 
  @note If the predicate is nil, this method behaves as
        `removeConditionForIndexPath:descendant:` with the descendant parameter
        set to `NO`.
@@ -100,6 +204,86 @@
  */
 - (void)setConditionForIndexPath:(NSIndexPath *)indexPath predicate:(NSPredicate *)predicate evaluationObject:(id)object;
 
+/**
+ Sets a block condition for a contiguous range of indexes below the given index
+ path while overwriting all previous conditions inside the range.
+ 
+ The range refers to the indexes that follow the given index path, e.g. the
+ range 20-499 at index path '3' covers the index paths '3-20' to '3-499'. Pass
+ an empty index path to cover indexes at the top level.
+ 
+ All indexes in the range share a single condition that is stored only once,
+ so mapping costs the same for a range as for a single index, regardless of
+ its length. Conditions that were set for indexes inside the range are
+ replaced, including the conditions of their descendants.
+ 
+ If you later set a condition for a single index inside the range or one of its
+ descendants, the range is split up around this index and the index keeps the
+ condition of the range for itself.
+ 
+ @note If the condition is NULL, this method behaves as
+       `removeConditionForIndexRange:atIndexPath:`.
+ 
+ @param range     The range of indexes the condition belongs to. Must not be
+                  empty.
+ @param indexPath The index path the indexes of the range follow.
+ @param condition A block that evaluates the condition for all indexes in the
+                  range. The block should return YES if the indexes are active
+                  or NO if they should be skipped.
+ */
+- (void)setConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath condition:(BOOL(^)(void))condition;
+
+/**
+ Sets a predicate condition for a contiguous range of indexes below the given
+ index path while overwriting all previous conditions inside the range.
+ 
+ @see setConditionForIndexRange:atIndexPath:condition:
+ @see setConditionForIndexPath:predicate:evaluationObject:
+ 
+ @note If the predicate is nil, this method behaves as
+       `removeConditionForIndexRange:atIndexPath:`.
+ 
+ @param range     The range of indexes the condition belongs to. Must not be
+                  empty.
+ @param indexPath The index path the indexes of the range follow.
+ @param predicate The predicate that describes the condition.
+ @param object    The object the predicate should be evaluated on.
+ */
+- (void)setConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath predicate:(NSPredicate *)predicate evaluationObject:(id)object;
+
+/**
+ Removes the conditions of all indexes inside the given range below the given
+ index path, including the conditions of their descendants.
+ 
+ This works for conditions that were set for a range as well as for single
+ indexes. A range that is only partially covered keeps its condition for the
+ indexes outside of the given range.
+ 
+ @param range     The range of indexes whose conditions should be removed.
+ @param indexPath The index path the indexes of the range follow.
+ */
+- (void)removeConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Sets a number of conditions at once while overwriting possible previous
+ conditions for the same index paths.
+ 
+ The dictionary maps an index path to its condition. A condition can either be
+ an `NSPredicate`, which is evaluated on the passed in evaluation object, or a
+ block of type `BOOL(^)(void)`.
+ 
+ This method behaves like calling `setConditionForIndexPath:condition:` or
+ `setConditionForIndexPath:predicate:evaluationObject:` for every entry, but is
+ considerably faster for a large number of conditions: the index paths are
+ sorted once and every affected node is updated in a single pass.
+ 
+ @param conditions A dictionary with `NSIndexPath` keys and `NSPredicate` or
+                   block values.
+ @param object     The object the predicates should be evaluated on. This is
+                   required if the dictionary contains at least one predicate.
+ */
+- (void)setConditions:(NSDictionary *)conditions evaluationObject:(id)object;
+
 /**
  Remove a condition for a given index path.
  
@@ -117,6 +301,88 @@
  */
 - (void)removeConditionForIndexPath:(NSIndexPath *)indexPath descendant:(BOOL)descendant;
 
+/**
+ Removes the conditions for a number of index paths at once.
+ 
+ This method behaves like calling `removeConditionForIndexPath:descendant:` for
+ every index path, but sorts the index paths once and compacts every affected
+ node only once.
+ 
+ @param indexPaths A list of index paths whose conditions should be removed.
+ @param descendant If this is set to YES, all descendant index path conditions
+                   are removed, too.
+ */
+- (void)removeConditionsForIndexPaths:(NSArray *)indexPaths descendant:(BOOL)descendant;
+
+/**
+ Marks the condition of the given index path as changed.
+ 
+ If snapshots are enabled, the condition is evaluated again with the next
+ mapping call that needs it. All other evaluated conditions are reused and the
+ snapshot is updated in logarithmic time, so a single condition can be flipped
+ cheaply even in large sections. If there is no condition for the given index
+ path, this method does nothing.
+ 
+ @see snapshotEnabled
+ 
+ @param indexPath The index path whose condition changed.
+ */
+- (void)invalidateConditionForIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Marks all conditions as changed.
+ 
+ If snapshots are enabled, all conditions are evaluated again with the next
+ mapping call.
+ 
+ @see snapshotEnabled
+ */
+- (void)invalidateAll;
+
+/**
+ Performs a batch of condition changes and reports the dynamic index paths that
+ appeared or disappeared because of them.
+ 
+ The mapper captures the visibility of all conditions before and after calling
+ the `updates` block and compares both states in a single pass over the
+ conditions. If a condition is hidden in both states or only changes its
+ descendants, it is not reported. Descendants of a condition that appears or
+ disappears are not reported either, as they are implicitly inserted or
+ deleted with it.
+ 
+ The reported index paths can directly be passed to the batch update methods of
+ a table view: deleted index paths are based on the state before the updates,
+ inserted index paths on the state after the updates.
+ 
+ If snapshots are enabled, the state before the updates is the one of the
+ current snapshot, which is what was last reported to the caller. In this case
+ you have to invalidate the conditions you change inside the `updates` block,
+ unless the mapper observes the evaluation objects.
+ 
+ @see -[HRSIndexPathMapper(TableView) performUpdates:tableView:rowAnimation:]
+ 
+ @param updates A block that changes conditions, e.g. by modifying the
+                evaluation objects or setting or removing conditions.
+ @param changes A block that is called synchronously with the lists of deleted
+                and inserted dynamic index paths, both sorted ascending.
+ */
+- (void)performUpdates:(void(^)(void))updates changes:(void(^)(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths))changes;
+
+/**
+ Evaluates all conditions once and returns an immutable snapshot of the result.
+ 
+ The snapshot offers the same mapping methods as the mapper and can be compared
+ with other snapshots. Unlike the mapper, it can be used from any thread. The
+ snapshot itself must be taken on the thread the conditions may be evaluated
+ on, usually the main thread.
+ 
+ If `snapshotEnabled` is set, the results of the current snapshot of the mapper
+ are reused instead of evaluating the conditions again.
+ 
+ @return A snapshot of the current visibility of all conditions.
+ */
+- (HRSIndexPathMapperSnapshot *)snapshot;
+
 /**
  Return the dynamically, mapped index path for a certain static index path by
  taking all conditions into account that are relevant for the index path in
@@ -141,4 +407,124 @@
  */
 - (NSIndexPath *)staticIndexPathForDynamicIndexPath:(NSIndexPath *)indexPath;
 
+/**
+ Maps a list of static index paths to their dynamic index paths at once.
+ 
+ Instead of walking the conditions for every index path separately, all index
+ paths are mapped in a single traversal that is shared between index paths with
+ a common prefix. This works best if the index paths are sorted ascending, e.g.
+ the result of `-[UITableView indexPathsForVisibleRows]`. Unsorted lists are
+ mapped correctly, but profit less from the shared traversal.
+ 
+ @see dynamicIndexPathForStaticIndexPath:
+ 
+ @param indexPaths A list of static index paths.
+ 
+ @return A list with the dynamic index path for each passed in index path, in
+         the same order.
+ */
+- (NSArray *)dynamicIndexPathsForStaticIndexPaths:(NSArray *)indexPaths;
+
+/**
+ Maps a list of dynamic index paths to their static index paths at once.
+ 
+ @see dynamicIndexPathsForStaticIndexPaths:
+ @see staticIndexPathForDynamicIndexPath:
+ 
+ @param indexPaths A list of dynamic index paths.
+ 
+ @return A list with the static index path for each passed in index path, in
+         the same order.
+ */
+- (NSArray *)staticIndexPathsForDynamicIndexPaths:(NSArray *)indexPaths;
+
+/**
+ Maps a list of static index paths, stored in a plain buffer, in place to their
+ dynamic counterparts.
+ 
+ This method does not allocate any objects. The buffer contains `count` index
+ paths with `length` indexes each, stored one after the other. The index path
+ `n` therefore starts at `indexes[n * length]`.
+ 
+ @see dynamicIndexPathsForStaticIndexPaths:
+ 
+ @param indexes A buffer of at least `count * length` indexes.
+ @param count   The number of index paths in the buffer.
+ @param length  The number of indexes of each index path.
+ */
+- (void)mapStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length;
+
+/**
+ Maps a list of dynamic index paths, stored in a plain buffer, in place to their
+ static counterparts.
+ 
+ @see mapStaticIndexes:count:length:
+ 
+ @param indexes A buffer of at least `count * length` indexes.
+ @param count   The number of index paths in the buffer.
+ @param length  The number of indexes of each index path.
+ */
+- (void)mapDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length;
+
+/**
+ Returns the number of indexes below the given static index path that are
+ visible, out of a total number of static indexes.
+ 
+ This is what a data source needs to answer e.g. the number of rows in a
+ section: pass the number of rows of the model as `total` and the mapper
+ subtracts the hidden ones. Only the conditions of the node that belongs to the
+ index path are taken into account, so this costs a single pass over them. If
+ snapshots are enabled and the conditions were not invalidated, the number of
+ hidden indexes is already known and only looked up.
+ 
+ If the index path itself or one of its ancestors is not visible, none of its
+ indexes are visible and 0 is returned.
+ 
+ @param total     The number of static indexes below the index path.
+ @param indexPath The static index path whose indexes should be counted. Pass an
+                  empty index path to count the indexes at the top level.
+ 
+ @return The number of visible indexes, which is never greater than `total`.
+ */
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total atIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Enumerates the visible indexes below the given static index path, out of a
+ total number of static indexes, together with their dynamic indexes.
+ 
+ The indexes are enumerated in ascending order, so the dynamic indexes passed
+ to the block are 0, 1, 2 and so on. This produces the complete mapping of a
+ level in a single pass over the conditions of the index path, instead of one
+ lookup per index as with `staticIndexPathForDynamicIndexPath:`. Runs of
+ visible indexes are found first and only expanded into single indexes for the
+ block.
+ 
+ If the index path itself or one of its ancestors is not visible, the block is
+ not called.
+ 
+ @param indexPath The static index path whose indexes should be enumerated. Pass
+                  an empty index path to enumerate the indexes at the top level.
+ @param total     The number of static indexes below the index path.
+ @param block     The block that is called for every visible index with its
+                  static and its dynamic index. Set `stop` to `YES` to stop the
+                  enumeration.
+ */
+- (void)enumerateVisibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total usingBlock:(void(^)(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop))block;
+
+/**
+ Returns the visible static indexes below the given static index path, out of a
+ total number of static indexes.
+ 
+ The n-th index of the set is the static index of the dynamic index n. Runs of
+ visible indexes are added to the set as a whole.
+ 
+ @see enumerateVisibleIndexesAtIndexPath:total:usingBlock:
+ 
+ @param indexPath The static index path whose indexes should be returned.
+ @param total     The number of static indexes below the index path.
+ 
+ @return The visible static indexes, empty if the index path is not visible.
+ */
+- (NSIndexSet *)visibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total;
+
 @end
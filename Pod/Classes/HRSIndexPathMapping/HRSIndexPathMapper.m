@@ -15,6 +15,15 @@
 #import "HRSIndexPathMapper.h"
 
 #import "HRSIndexPathMapperNode.h"
+#import "HRSIndexPathMapperSnapshot.h"
+#import "HRSIndexPathMapperState.h"
+
+
+@interface HRSIndexPathMapperSnapshot (Private)
+
+- (instancetype)initWithState:(HRSIndexPathMapperState *)state;
+
+@end
 
 
 @interface HRSIndexPathMapper ()
@@ -39,14 +48,15 @@
 #pragma mark - configuration
 
 - (void)setConditionForIndexPath:(NSIndexPath *)indexPath condition:(BOOL(^)(void))condition {
-	NSPredicate *predicate;
-	if (condition != NULL) {
-		predicate = [NSPredicate predicateWithBlock:^BOOL(id evaluatedObject, NSDictionary *bindings) {
-			return condition();
-		}];
+	if (condition == NULL) {
+		[self removeConditionForIndexPath:indexPath descendant:NO];
+		return;
 	}
 	
-	[self setConditionForIndexPath:indexPath predicate:predicate evaluationObject:self];
+	NSUInteger indexes[indexPath.length];
+	[indexPath getIndexes:indexes];
+	
+	[self.root setConditionForIndexes:indexes depth:indexPath.length block:condition];
 }
 
 - (void)setConditionForIndexPath:(NSIndexPath *)indexPath predicate:(NSPredicate *)predicate evaluationObject:(id)object {
@@ -74,6 +84,206 @@
 
 
 
+#pragma mark - range configuration
+
+- (void)setConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath condition:(BOOL(^)(void))condition {
+	if (condition == NULL) {
+		[self removeConditionForIndexRange:range atIndexPath:indexPath];
+		return;
+	}
+	NSParameterAssert(range.length > 0);
+	if (range.length == 0) {
+		return;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	[self.root setConditionForIndexes:indexes depth:indexPath.length range:range block:condition];
+}
+
+- (void)setConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath predicate:(NSPredicate *)predicate evaluationObject:(id)object {
+	if (predicate == nil) {
+		[self removeConditionForIndexRange:range atIndexPath:indexPath];
+		return;
+	}
+	NSParameterAssert(range.length > 0);
+	NSParameterAssert(object);
+	if (range.length == 0 || object == nil) {
+		return;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	[self.root setConditionForIndexes:indexes depth:indexPath.length range:range predicate:predicate evaluationObject:object];
+}
+
+- (void)removeConditionForIndexRange:(NSRange)range atIndexPath:(NSIndexPath *)indexPath {
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	[self.root removeConditionsForIndexes:indexes depth:indexPath.length range:range];
+}
+
+
+
+#pragma mark - bulk configuration
+
+- (void)setConditions:(NSDictionary *)conditions evaluationObject:(id)object {
+	NSArray *indexPaths = [[conditions allKeys] sortedArrayUsingSelector:@selector(compare:)];
+	
+	// the items do not retain their conditions, so they are kept alive here
+	NSMutableArray *validConditions = [NSMutableArray arrayWithCapacity:indexPaths.count];
+	NSMutableArray *validIndexPaths = [NSMutableArray arrayWithCapacity:indexPaths.count];
+	for (NSIndexPath *indexPath in indexPaths) {
+		if (indexPath.length == 0) {
+			continue;
+		}
+		
+		id condition = conditions[indexPath];
+		if ([condition isKindOfClass:[NSPredicate class]]) {
+			NSParameterAssert(object);
+			if (object == nil) {
+				continue;
+			}
+		}
+		[validConditions addObject:condition];
+		[validIndexPaths addObject:indexPath];
+	}
+	
+	[self withConditionItemsForIndexPaths:validIndexPaths perform:^(HRSIndexPathMapperConditionItem *items, NSUInteger count) {
+		for (NSUInteger item = 0; item < count; item++) {
+			id condition = validConditions[item];
+			if ([condition isKindOfClass:[NSPredicate class]]) {
+				items[item].predicate = condition;
+				items[item].evaluationObject = object;
+			} else {
+				items[item].block = condition;
+			}
+		}
+		[self.root setConditions:items count:count level:0];
+	}];
+}
+
+- (void)removeConditionsForIndexPaths:(NSArray *)indexPaths descendant:(BOOL)descendant {
+	NSMutableArray *validIndexPaths = [NSMutableArray arrayWithCapacity:indexPaths.count];
+	for (NSIndexPath *indexPath in [indexPaths sortedArrayUsingSelector:@selector(compare:)]) {
+		if (indexPath.length > 0 && [indexPath isEqual:validIndexPaths.lastObject] == NO) {
+			[validIndexPaths addObject:indexPath];
+		}
+	}
+	
+	[self withConditionItemsForIndexPaths:validIndexPaths perform:^(HRSIndexPathMapperConditionItem *items, NSUInteger count) {
+		[self.root removeConditions:items count:count level:0 descendant:descendant];
+	}];
+}
+
+- (void)withConditionItemsForIndexPaths:(NSArray *)indexPaths perform:(void(^)(HRSIndexPathMapperConditionItem *items, NSUInteger count))block {
+	NSUInteger count = indexPaths.count;
+	if (count == 0) {
+		return;
+	}
+	
+	NSUInteger totalLength = 0;
+	for (NSIndexPath *indexPath in indexPaths) {
+		totalLength += indexPath.length;
+	}
+	
+	NSUInteger *indexes = malloc(totalLength * sizeof(NSUInteger));
+	HRSIndexPathMapperConditionItem *items = calloc(count, sizeof(HRSIndexPathMapperConditionItem));
+	
+	NSUInteger offset = 0;
+	for (NSUInteger item = 0; item < count; item++) {
+		NSIndexPath *indexPath = indexPaths[item];
+		[indexPath getIndexes:&indexes[offset]];
+		items[item].indexes = &indexes[offset];
+		items[item].length = indexPath.length;
+		offset += indexPath.length;
+	}
+	
+	block(items, count);
+	
+	free(items);
+	free(indexes);
+}
+
+
+
+#pragma mark - invalidation
+
+- (void)setSnapshotEnabled:(BOOL)snapshotEnabled {
+	if (_snapshotEnabled != snapshotEnabled) {
+		_snapshotEnabled = snapshotEnabled;
+		[self invalidateAll];
+	}
+}
+
+- (BOOL)observesEvaluationObjects {
+	return self.root.observesEvaluationObject;
+}
+
+- (void)setObservesEvaluationObjects:(BOOL)observesEvaluationObjects {
+	self.root.observesEvaluationObject = observesEvaluationObjects;
+}
+
+- (void)setInstrumentation:(id<HRSIndexPathMapperInstrumentation>)instrumentation {
+	_instrumentation = instrumentation;
+	if (instrumentation == nil) {
+		self.root.evaluationObserver = nil;
+		return;
+	}
+	
+	// the root does not retain the mapper, the mapper owns the root
+	__weak HRSIndexPathMapper *weakSelf = self;
+	self.root.evaluationObserver = ^(HRSIndexPathMapperNode *node, BOOL result, NSTimeInterval duration) {
+		HRSIndexPathMapper *mapper = weakSelf;
+		[mapper.instrumentation indexPathMapper:mapper didEvaluateConditionForIndexPath:node.indexPath result:result duration:duration];
+	};
+}
+
+- (void)invalidateConditionForIndexPath:(NSIndexPath *)indexPath {
+	if (indexPath.length == 0) {
+		return;
+	}
+	
+	NSUInteger indexes[indexPath.length];
+	[indexPath getIndexes:indexes];
+	
+	[self.root invalidateConditionForIndexes:indexes depth:indexPath.length];
+}
+
+- (void)invalidateAll {
+	[self.root invalidateConditions];
+}
+
+
+
+#pragma mark - updates
+
+- (void)performUpdates:(void(^)(void))updates changes:(void(^)(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths))changes {
+	HRSIndexPathMapperState *oldState = [self.root stateUsingSnapshot:self.snapshotEnabled];
+	if (updates) {
+		updates();
+	}
+	HRSIndexPathMapperState *newState = [self.root stateUsingSnapshot:self.snapshotEnabled];
+	
+	NSMutableArray *deletedIndexPaths = [NSMutableArray array];
+	NSMutableArray *insertedIndexPaths = [NSMutableArray array];
+	[oldState addChangesToState:newState deletedIndexPaths:deletedIndexPaths insertedIndexPaths:insertedIndexPaths];
+	
+	if (changes) {
+		changes([deletedIndexPaths copy], [insertedIndexPaths copy]);
+	}
+}
+
+- (HRSIndexPathMapperSnapshot *)snapshot {
+	HRSIndexPathMapperState *state = [self.root stateUsingSnapshot:self.snapshotEnabled];
+	return [[HRSIndexPathMapperSnapshot alloc] initWithState:state];
+}
+
+
+
 #pragma mark - mapping
 
 - (NSIndexPath *)dynamicIndexPathForStaticIndexPath:(NSIndexPath *)indexPath {
@@ -84,7 +294,7 @@
 	NSUInteger indexes[indexPath.length];
 	[indexPath getIndexes:indexes];
 	
-	[self.root dynamicIndexesForStaticIndexes:indexes depth:indexPath.length];
+	[self.root dynamicIndexesForStaticIndexes:indexes depth:indexPath.length snapshot:self.snapshotEnabled];
 	
 	NSIndexPath *dynamicIndexPath = [NSIndexPath indexPathWithIndexes:indexes length:indexPath.length];
 	return dynamicIndexPath;
@@ -98,10 +308,121 @@
 	NSUInteger indexes[indexPath.length];
 	[indexPath getIndexes:indexes];
 	
-	[self.root staticIndexesForDynamicIndexes:indexes depth:indexPath.length];
+	[self.root staticIndexesForDynamicIndexes:indexes depth:indexPath.length snapshot:self.snapshotEnabled];
 	
 	NSIndexPath *staticIndexPath = [NSIndexPath indexPathWithIndexes:indexes length:indexPath.length];
 	return staticIndexPath;
 }
 
+
+
+#pragma mark - counting
+
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total atIndexPath:(NSIndexPath *)indexPath {
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	return [self.root numberOfVisibleIndexesOfTotal:total forIndexes:indexes depth:indexPath.length snapshot:self.snapshotEnabled];
+}
+
+
+
+#pragma mark - enumeration
+
+- (void)enumerateVisibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total usingBlock:(void(^)(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop))block {
+	NSParameterAssert(block);
+	if (block == NULL) {
+		return;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	[self.root enumerateVisibleRangesOfTotal:total forIndexes:indexes depth:indexPath.length snapshot:self.snapshotEnabled usingBlock:^(NSRange range, NSUInteger dynamicIndex, BOOL *stop) {
+		for (NSUInteger offset = 0; offset < range.length && *stop == NO; offset++) {
+			block(range.location + offset, dynamicIndex + offset, stop);
+		}
+	}];
+}
+
+- (NSIndexSet *)visibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total {
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	NSMutableIndexSet *visibleIndexes = [NSMutableIndexSet indexSet];
+	[self.root enumerateVisibleRangesOfTotal:total forIndexes:indexes depth:indexPath.length snapshot:self.snapshotEnabled usingBlock:^(NSRange range, NSUInteger dynamicIndex, BOOL *stop) {
+		[visibleIndexes addIndexesInRange:range];
+	}];
+	return [visibleIndexes copy];
+}
+
+
+
+#pragma mark - batch mapping
+
+- (NSArray *)dynamicIndexPathsForStaticIndexPaths:(NSArray *)indexPaths {
+	return [self mappedIndexPaths:indexPaths dynamic:YES];
+}
+
+- (NSArray *)staticIndexPathsForDynamicIndexPaths:(NSArray *)indexPaths {
+	return [self mappedIndexPaths:indexPaths dynamic:NO];
+}
+
+- (void)mapStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length {
+	NSParameterAssert(indexes != NULL || count == 0);
+	if (indexes == NULL) {
+		return;
+	}
+	[self.root dynamicIndexesForStaticIndexes:indexes count:count stride:length depth:length snapshot:self.snapshotEnabled];
+}
+
+- (void)mapDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length {
+	NSParameterAssert(indexes != NULL || count == 0);
+	if (indexes == NULL) {
+		return;
+	}
+	[self.root staticIndexesForDynamicIndexes:indexes count:count stride:length depth:length snapshot:self.snapshotEnabled];
+}
+
+- (NSArray *)mappedIndexPaths:(NSArray *)indexPaths dynamic:(BOOL)dynamic {
+	NSUInteger count = indexPaths.count;
+	if (count == 0) {
+		return [NSArray array];
+	}
+	
+	NSMutableArray *mappedIndexPaths = [NSMutableArray arrayWithCapacity:count];
+	
+	// the buffer holds index paths of the same length only, so index paths
+	// are mapped in runs of equal length
+	NSUInteger runStart = 0;
+	while (runStart < count) {
+		NSUInteger length = [indexPaths[runStart] length];
+		NSUInteger runEnd = runStart + 1;
+		while (runEnd < count && [indexPaths[runEnd] length] == length) {
+			runEnd++;
+		}
+		
+		NSUInteger runCount = runEnd - runStart;
+		NSUInteger *indexes = malloc(MAX(runCount * length, 1) * sizeof(NSUInteger));
+		for (NSUInteger item = 0; item < runCount; item++) {
+			[indexPaths[runStart + item] getIndexes:&indexes[item * length]];
+		}
+		
+		if (dynamic) {
+			[self mapStaticIndexes:indexes count:runCount length:length];
+		} else {
+			[self mapDynamicIndexes:indexes count:runCount length:length];
+		}
+		
+		for (NSUInteger item = 0; item < runCount; item++) {
+			[mappedIndexPaths addObject:[NSIndexPath indexPathWithIndexes:&indexes[item * length] length:length]];
+		}
+		free(indexes);
+		
+		runStart = runEnd;
+	}
+	
+	return [mappedIndexPaths copy];
+}
+
 @end
@@ -0,0 +1,171 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ A `HRSIndexPathMapperSnapshot` is an immutable copy of the visibility of all
+ conditions of an index path mapper at the time the snapshot was taken.
+ 
+ A snapshot is created by `-[HRSIndexPathMapper snapshot]`, which evaluates the
+ conditions once. Afterwards the snapshot neither references the conditions nor
+ their evaluation objects, so it does not change when the mapper or the model
+ changes.
+ 
+ Because it is immutable, a snapshot can be used from any thread. This allows to
+ take a snapshot on the main thread, prepare e.g. the layout of the visible rows
+ on a background queue and only apply the result on the main thread:
+ 
+     HRSIndexPathMapperSnapshot *oldSnapshot = [mapper snapshot];
+     // change the model
+     HRSIndexPathMapperSnapshot *newSnapshot = [mapper snapshot];
+     dispatch_async(queue, ^{
+         // map index paths with newSnapshot, compute the changes
+         [oldSnapshot changesToSnapshot:newSnapshot changes:^(NSArray *deleted, NSArray *inserted) {
+             dispatch_async(dispatch_get_main_queue(), ^{
+                 // apply the result
+             });
+         }];
+     });
+ 
+ Mapping with a snapshot is a binary search per index of an index path. The
+ results are the same as mapping with the mapper at the time the snapshot was
+ taken.
+ */
+@interface HRSIndexPathMapperSnapshot : NSObject <NSCopying>
+
+/**
+ Returns the dynamic index path for a static index path.
+ 
+ @see -[HRSIndexPathMapper dynamicIndexPathForStaticIndexPath:]
+ 
+ @param indexPath The static index path.
+ 
+ @return The dynamic index path. If an index in the resulting index path was not
+         visible, `NSNotFound` is returned for it and all of its descendants.
+ */
+- (NSIndexPath *)dynamicIndexPathForStaticIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Returns the static index path for a dynamic index path.
+ 
+ @see -[HRSIndexPathMapper staticIndexPathForDynamicIndexPath:]
+ 
+ @param indexPath The dynamic index path.
+ 
+ @return The static index path.
+ */
+- (NSIndexPath *)staticIndexPathForDynamicIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Maps a list of static index paths to their dynamic index paths.
+ 
+ @param indexPaths A list of static index paths.
+ 
+ @return A list with the dynamic index path for each passed in index path, in
+         the same order.
+ */
+- (NSArray *)dynamicIndexPathsForStaticIndexPaths:(NSArray *)indexPaths;
+
+/**
+ Maps a list of dynamic index paths to their static index paths.
+ 
+ @param indexPaths A list of dynamic index paths.
+ 
+ @return A list with the static index path for each passed in index path, in
+         the same order.
+ */
+- (NSArray *)staticIndexPathsForDynamicIndexPaths:(NSArray *)indexPaths;
+
+/**
+ Maps a list of static index paths, stored in a plain buffer, in place to their
+ dynamic counterparts.
+ 
+ @see -[HRSIndexPathMapper mapStaticIndexes:count:length:]
+ 
+ @param indexes A buffer of at least `count * length` indexes.
+ @param count   The number of index paths in the buffer.
+ @param length  The number of indexes of each index path.
+ */
+- (void)mapStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length;
+
+/**
+ Maps a list of dynamic index paths, stored in a plain buffer, in place to their
+ static counterparts.
+ 
+ @see mapStaticIndexes:count:length:
+ 
+ @param indexes A buffer of at least `count * length` indexes.
+ @param count   The number of index paths in the buffer.
+ @param length  The number of indexes of each index path.
+ */
+- (void)mapDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length;
+
+/**
+ Returns the number of indexes below the given static index path that were
+ visible, out of a total number of static indexes.
+ 
+ @see -[HRSIndexPathMapper numberOfVisibleIndexesOfTotal:atIndexPath:]
+ 
+ @param total     The number of static indexes below the index path.
+ @param indexPath The static index path whose indexes should be counted.
+ 
+ @return The number of visible indexes.
+ */
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total atIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Enumerates the indexes below the given static index path that were visible,
+ out of a total number of static indexes, together with their dynamic indexes.
+ 
+ @see -[HRSIndexPathMapper enumerateVisibleIndexesAtIndexPath:total:usingBlock:]
+ 
+ @param indexPath The static index path whose indexes should be enumerated.
+ @param total     The number of static indexes below the index path.
+ @param block     The block that is called for every visible index with its
+                  static and its dynamic index.
+ */
+- (void)enumerateVisibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total usingBlock:(void(^)(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop))block;
+
+/**
+ Returns the static indexes below the given static index path that were
+ visible, out of a total number of static indexes.
+ 
+ @see -[HRSIndexPathMapper visibleIndexesAtIndexPath:total:]
+ 
+ @param indexPath The static index path whose indexes should be returned.
+ @param total     The number of static indexes below the index path.
+ 
+ @return The visible static indexes.
+ */
+- (NSIndexSet *)visibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total;
+
+/**
+ Calculates the changes that are necessary to get from the receiver to the
+ passed in snapshot.
+ 
+ The lists have the same semantic as the ones of
+ `-[HRSIndexPathMapper performUpdates:changes:]`: deleted index paths are based
+ on the receiver, inserted index paths on the passed in snapshot.
+ 
+ @param snapshot The snapshot after the changes.
+ @param changes  A block that is called synchronously with the lists of deleted
+                 and inserted dynamic index paths, both sorted ascending.
+ */
+- (void)changesToSnapshot:(HRSIndexPathMapperSnapshot *)snapshot changes:(void(^)(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths))changes;
+
+// unavailable:
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
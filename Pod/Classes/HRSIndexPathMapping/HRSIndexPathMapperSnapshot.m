@@ -0,0 +1,171 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import "HRSIndexPathMapperSnapshot.h"
+
+#import "HRSIndexPathMapperState.h"
+
+
+@interface HRSIndexPathMapperSnapshot ()
+
+@property (nonatomic, strong, readonly) HRSIndexPathMapperState *state;
+
+@end
+
+
+@implementation HRSIndexPathMapperSnapshot
+
+- (instancetype)initWithState:(HRSIndexPathMapperState *)state {
+	NSParameterAssert(state);
+	if (state == nil) {
+		return nil;
+	}
+	
+	self = [super init];
+	if (self) {
+		_state = state;
+	}
+	return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+	return self;
+}
+
+
+
+#pragma mark - mapping
+
+- (NSIndexPath *)dynamicIndexPathForStaticIndexPath:(NSIndexPath *)indexPath {
+	if (indexPath == nil) {
+		return nil;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	[self.state dynamicIndexesForStaticIndexes:indexes depth:indexPath.length];
+	return [NSIndexPath indexPathWithIndexes:indexes length:indexPath.length];
+}
+
+- (NSIndexPath *)staticIndexPathForDynamicIndexPath:(NSIndexPath *)indexPath {
+	if (indexPath == nil) {
+		return nil;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	[self.state staticIndexesForDynamicIndexes:indexes depth:indexPath.length];
+	return [NSIndexPath indexPathWithIndexes:indexes length:indexPath.length];
+}
+
+
+
+#pragma mark - batch mapping
+
+- (NSArray *)dynamicIndexPathsForStaticIndexPaths:(NSArray *)indexPaths {
+	NSMutableArray *mappedIndexPaths = [NSMutableArray arrayWithCapacity:indexPaths.count];
+	for (NSIndexPath *indexPath in indexPaths) {
+		[mappedIndexPaths addObject:[self dynamicIndexPathForStaticIndexPath:indexPath]];
+	}
+	return [mappedIndexPaths copy];
+}
+
+- (NSArray *)staticIndexPathsForDynamicIndexPaths:(NSArray *)indexPaths {
+	NSMutableArray *mappedIndexPaths = [NSMutableArray arrayWithCapacity:indexPaths.count];
+	for (NSIndexPath *indexPath in indexPaths) {
+		[mappedIndexPaths addObject:[self staticIndexPathForDynamicIndexPath:indexPath]];
+	}
+	return [mappedIndexPaths copy];
+}
+
+- (void)mapStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length {
+	NSParameterAssert(indexes != NULL || count == 0);
+	if (indexes == NULL) {
+		return;
+	}
+	for (NSUInteger item = 0; item < count; item++) {
+		[self.state dynamicIndexesForStaticIndexes:&indexes[item * length] depth:length];
+	}
+}
+
+- (void)mapDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count length:(NSUInteger)length {
+	NSParameterAssert(indexes != NULL || count == 0);
+	if (indexes == NULL) {
+		return;
+	}
+	for (NSUInteger item = 0; item < count; item++) {
+		[self.state staticIndexesForDynamicIndexes:&indexes[item * length] depth:length];
+	}
+}
+
+
+
+#pragma mark - counting
+
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total atIndexPath:(NSIndexPath *)indexPath {
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	return [self.state numberOfVisibleIndexesOfTotal:total forIndexes:indexes depth:indexPath.length];
+}
+
+
+
+#pragma mark - enumeration
+
+- (void)enumerateVisibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total usingBlock:(void(^)(NSUInteger staticIndex, NSUInteger dynamicIndex, BOOL *stop))block {
+	NSParameterAssert(block);
+	if (block == NULL) {
+		return;
+	}
+	
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	[self.state enumerateVisibleRangesOfTotal:total forIndexes:indexes depth:indexPath.length usingBlock:^(NSRange range, NSUInteger dynamicIndex, BOOL *stop) {
+		for (NSUInteger offset = 0; offset < range.length && *stop == NO; offset++) {
+			block(range.location + offset, dynamicIndex + offset, stop);
+		}
+	}];
+}
+
+- (NSIndexSet *)visibleIndexesAtIndexPath:(NSIndexPath *)indexPath total:(NSUInteger)total {
+	NSUInteger indexes[MAX(indexPath.length, 1u)];
+	[indexPath getIndexes:indexes];
+	
+	NSMutableIndexSet *visibleIndexes = [NSMutableIndexSet indexSet];
+	[self.state enumerateVisibleRangesOfTotal:total forIndexes:indexes depth:indexPath.length usingBlock:^(NSRange range, NSUInteger dynamicIndex, BOOL *stop) {
+		[visibleIndexes addIndexesInRange:range];
+	}];
+	return [visibleIndexes copy];
+}
+
+
+
+#pragma mark - diff
+
+- (void)changesToSnapshot:(HRSIndexPathMapperSnapshot *)snapshot changes:(void(^)(NSArray *deletedIndexPaths, NSArray *insertedIndexPaths))changes {
+	NSParameterAssert(snapshot);
+	if (snapshot == nil) {
+		return;
+	}
+	
+	NSMutableArray *deletedIndexPaths = [NSMutableArray array];
+	NSMutableArray *insertedIndexPaths = [NSMutableArray array];
+	[self.state addChangesToState:snapshot.state deletedIndexPaths:deletedIndexPaths insertedIndexPaths:insertedIndexPaths];
+	
+	if (changes) {
+		changes([deletedIndexPaths copy], [insertedIndexPaths copy]);
+	}
+}
+
+@end
@@ -14,3 +14,4 @@
 
 #import <HRSAdvancedTableViews/HRSIndexPathMapper.h>
 #import <HRSAdvancedTableViews/HRSIndexPathMapper+TableView.h>
+#import <HRSAdvancedTableViews/HRSIndexPathMapperSnapshot.h>
@@ -14,6 +14,29 @@
 
 #import <Foundation/Foundation.h>
 
+@class HRSIndexPathMapperState;
+
+
+/**
+ A single condition in a list of conditions that are set or removed at once.
+ 
+ The struct does not retain its objects. The caller must keep them alive while
+ the list is used.
+ */
+typedef struct {
+	/// the indexes of the index path the condition belongs to
+	NSUInteger *indexes;
+	/// the number of indexes
+	NSUInteger length;
+	/// the predicate of the condition; unused when removing conditions
+	__unsafe_unretained NSPredicate *predicate;
+	/// the object the predicate is evaluated on; unused when removing conditions
+	__unsafe_unretained id evaluationObject;
+	/// a block that is used instead of the predicate if set; unused when removing conditions
+	__unsafe_unretained BOOL (^block)(void);
+} HRSIndexPathMapperConditionItem;
+
+
 /**
  A `HRSIndexPathMapperNode` represents a node in a tree of index paths that
  contains a condition and/or child nodes for a specific index in that index path.
@@ -37,11 +60,56 @@
 @property (nonatomic, assign, readonly) NSUInteger index;
 
 /**
- The children of the node that either contain conditions or more children.
+ The number of consecutive indexes the node represents, starting at `index`.
+ 
+ A node that is created for a single index has a length of 1. A node with a
+ greater length represents a range of indexes that share the same condition.
+ Such a node is always a leaf: as soon as a condition is set for a single index
+ inside the range or one of its descendants, the range is split up.
+ */
+@property (nonatomic, assign, readonly) NSUInteger length;
+
+/**
+ The children of the node that either contain conditions or more children,
+ sorted by their index.
+ 
+ The node stores its children in a flat list together with a plain buffer of
+ their indexes. This property returns a copy of that list.
  
  This array contains `HRSIndexPatchMapperNode` objects.
  */
-@property (nonatomic, strong, readwrite) NSArray /* HRSIndexPathMapperNode */ *children;
+@property (nonatomic, copy, readonly) NSArray /* HRSIndexPathMapperNode */ *children;
+
+/**
+ The node that contains the receiver in its list of children or `nil` if the
+ receiver is the root node.
+ */
+@property (nonatomic, weak, readonly) HRSIndexPathMapperNode *parent;
+
+/**
+ Specifies if the node observes the key paths of its predicate on the
+ evaluation object and invalidates its condition once one of them changes.
+ 
+ Setting this property also sets it on all descendants. Newly created children
+ inherit the value of their parent.
+ */
+@property (nonatomic, assign, readwrite) BOOL observesEvaluationObject;
+
+/**
+ A block that is called after the condition of a descendant was evaluated.
+ 
+ The block is only taken into account on the root node of a tree; it is called
+ for the evaluations of all nodes of the tree. Every node of the tree keeps a
+ reference to the block of its root, so as long as the root node has no such
+ block, evaluating a condition of the tree only costs a single check.
+ */
+@property (nonatomic, copy, readwrite) void (^evaluationObserver)(HRSIndexPathMapperNode *node, BOOL result, NSTimeInterval duration);
+
+/**
+ The index path of the node in its tree, made up of the indexes of all of its
+ ancestors except the root node.
+ */
+@property (nonatomic, strong, readonly) NSIndexPath *indexPath;
 
 /**
  Create a new node with the given index and a condition if there is any.
@@ -73,7 +141,8 @@
  If this method is called with only one index left in the list (meaning the
  depth parameter is 1), it will set the condition.
  
- @deprecated In favor of setConditionForIndexes:depth:predicate:evaluationObject:
+ @deprecated In favor of setConditionForIndexes:depth:block: and
+             setConditionForIndexes:depth:predicate:evaluationObject:
  
  @param indexes   A pointer to a list of indexes that represent the remaining
                   indexes of the index path from the receiver's node to the
@@ -92,6 +161,12 @@
  depth parameter is 1), it will set the condition's predicate and evaluation
  object.
  
+ The predicate is inspected once when it is set. A predicate created with
+ `+predicateWithValue:` is folded into a constant. A comparison of a single key
+ with `YES` or `NO` is evaluated by calling the corresponding getter directly if
+ the object implements it with a `BOOL` return type. All other predicates are
+ evaluated with `-evaluateWithObject:`.
+ 
  @param indexes   A pointer to a list of indexes that represent the remaining
                   indexes of the index path from the receiver's node to the
                   leaf.
@@ -101,6 +176,73 @@
  */
 - (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth predicate:(NSPredicate *)predicate evaluationObject:(id)object;
 
+/**
+ Sets a block condition for the given indexes like
+ `setConditionForIndexes:depth:predicate:evaluationObject:`.
+ 
+ The block is stored as is and invoked directly whenever the condition is
+ evaluated.
+ 
+ @param indexes A pointer to a list of indexes that represent the remaining
+                indexes of the index path from the receiver's node to the
+                leaf.
+ @param depth   The number of indexes in the list.
+ @param block   The block that describes the condition.
+ */
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth block:(BOOL(^)(void))block;
+
+/**
+ Sets a block condition for a range of indexes below the node that is found by
+ traversing through the given indexes like
+ `setConditionForIndexes:depth:block:`.
+ 
+ A single child is created for the whole range. All children of the node found
+ that are located inside the range are replaced by it, including their
+ descendants. Range children that are only partially covered by the range are
+ cut to the part outside of it.
+ 
+ @param indexes A pointer to a list of indexes that represent the indexes of
+                the index path from the receiver's node to the node whose
+                children the range belongs to.
+ @param depth   The number of indexes in the list, may be 0.
+ @param range   The range of indexes the condition belongs to.
+ @param block   The block that describes the condition.
+ */
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range block:(BOOL(^)(void))block;
+
+/**
+ Sets a predicate condition for a range of indexes like
+ `setConditionForIndexes:depth:range:block:`.
+ 
+ @see setConditionForIndexes:depth:predicate:evaluationObject:
+ 
+ @param indexes   A pointer to a list of indexes that represent the indexes of
+                  the index path from the receiver's node to the node whose
+                  children the range belongs to.
+ @param depth     The number of indexes in the list, may be 0.
+ @param range     The range of indexes the condition belongs to.
+ @param predicate The predicate that describes the condition.
+ @param object    The object the predicate should be evaluated on.
+ */
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range predicate:(NSPredicate *)predicate evaluationObject:(id)object;
+
+/**
+ Removes the conditions of all indexes inside the given range below the node
+ that is found by traversing through the given indexes, including their
+ descendants.
+ 
+ Range children that are only partially covered by the range are cut to the
+ part outside of it. Nodes on the way that end up without children and without
+ a condition are removed as well.
+ 
+ @param indexes A pointer to a list of indexes that represent the indexes of
+                the index path from the receiver's node to the node whose
+                children the range belongs to.
+ @param depth   The number of indexes in the list, may be 0.
+ @param range   The range of indexes whose conditions should be removed.
+ */
+- (void)removeConditionsForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range;
+
 /**
  Removes a condition for the given indexes by traversing through the child
  hierarchy to find the next index. After the item with the next index is found
@@ -122,6 +264,40 @@
  */
 - (void)removeConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth descendant:(BOOL)descendant;
 
+/**
+ Sets a list of conditions at once.
+ 
+ The items must be sorted ascending by their indexes and must all share the
+ same indexes up to `level`. Items with the same index at `level` are grouped
+ and handed down to the corresponding child together. All children that need
+ to be created are merged into the receiver's children in a single pass, so
+ every node is visited only once, regardless of the number of conditions.
+ 
+ @param items An array of conditions, sorted ascending by their indexes.
+ @param count The number of items in the array.
+ @param level The position of the index in each item that belongs to the
+              children of the receiver.
+ */
+- (void)setConditions:(HRSIndexPathMapperConditionItem *)items count:(NSUInteger)count level:(NSUInteger)level;
+
+/**
+ Removes a list of conditions at once.
+ 
+ The items must be sorted ascending by their indexes and must all share the
+ same indexes up to `level`. Children that need to be removed are only marked
+ while the items are processed and are removed in a single pass afterwards.
+ 
+ @see removeConditionForIndexes:depth:descendant:
+ 
+ @param items      An array of conditions, sorted ascending by their indexes.
+ @param count      The number of items in the array.
+ @param level      The position of the index in each item that belongs to the
+                   children of the receiver.
+ @param descendant Specifies if you want to remove all descendant child nodes
+                   as well.
+ */
+- (void)removeConditions:(HRSIndexPathMapperConditionItem *)items count:(NSUInteger)count level:(NSUInteger)level descendant:(BOOL)descendant;
+
 /**
  Recursively traverses through the list of given static indexes and maps them in
  place to its coresponding dynamic index based on the condition of the receiver.
@@ -148,4 +324,152 @@
  */
 - (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth;
 
+/**
+ Recursively traverses through the list of given static indexes and maps them in
+ place to its coresponding dynamic index.
+ 
+ If `snapshot` is `YES`, the receiver does not evaluate the conditions of its
+ children on every call. Instead it evaluates all of them once, stores the
+ results in a visibility list together with a Fenwick tree over the number of
+ hidden indexes in front of each child and reuses these results until the
+ snapshot is invalidated. The mapping in both directions is then logarithmic in
+ the number of children.
+ 
+ @see -invalidateConditions
+ 
+ @param indexes  A pointer to a list of indexes that represent the remaining
+                 indexes of the index path from the receiver's node to the
+                 leaf.
+ @param depth    The number of indexes in the list.
+ @param snapshot Specifies if the mapping should be based on the snapshot.
+ */
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot;
+
+/**
+ Recursively traverses through the list of given dynamic indexes and maps them
+ in place to its coresponding static index.
+ 
+ @see -dynamicIndexesForStaticIndexes:depth:snapshot:
+ 
+ @param indexes  A pointer to a list of indexes that represent the remaining
+                 indexes of the index path from the receiver's node to the
+                 leaf.
+ @param depth    The number of indexes in the list.
+ @param snapshot Specifies if the mapping should be based on the snapshot.
+ */
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot;
+
+/**
+ Maps a list of static index lists in place to their dynamic counterparts in a
+ single traversal of the tree.
+ 
+ The index lists are stored consecutively in `indexes`, the list of item `n`
+ starts at `indexes[n * stride]`. Items that share their first index are
+ forwarded to the corresponding child in one call, so the walk down the tree is
+ shared between siblings. If the items are sorted ascending, the children of
+ the receiver are enumerated only once for all items; whenever an item is
+ smaller than its predecessor, the enumeration starts over.
+ 
+ @see -dynamicIndexesForStaticIndexes:depth:snapshot:
+ 
+ @param indexes  A pointer to the first index of the first item.
+ @param count    The number of items in the list.
+ @param stride   The distance between the first indexes of two items.
+ @param depth    The number of indexes of each item that should be mapped.
+ @param snapshot Specifies if the mapping should be based on the snapshot.
+ */
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count stride:(NSUInteger)stride depth:(NSUInteger)depth snapshot:(BOOL)snapshot;
+
+/**
+ Maps a list of dynamic index lists in place to their static counterparts in a
+ single traversal of the tree.
+ 
+ @see -dynamicIndexesForStaticIndexes:count:stride:depth:snapshot:
+ 
+ @param indexes  A pointer to the first index of the first item.
+ @param count    The number of items in the list.
+ @param stride   The distance between the first indexes of two items.
+ @param depth    The number of indexes of each item that should be mapped.
+ @param snapshot Specifies if the mapping should be based on the snapshot.
+ */
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count stride:(NSUInteger)stride depth:(NSUInteger)depth snapshot:(BOOL)snapshot;
+
+/**
+ Counts the visible indexes among the first `total` children indexes of the node
+ that is found by traversing through the given indexes.
+ 
+ If there is no node for the indexes, there is no condition below them and all
+ indexes are visible. If the node or one of its ancestors is not visible, 0 is
+ returned. Hidden ranges are counted with their length, as far as they are
+ located inside the total.
+ 
+ @param total    The number of indexes to count.
+ @param indexes  A pointer to a list of indexes that represent the indexes of
+                 the index path from the receiver's node to the node whose
+                 children should be counted.
+ @param depth    The number of indexes in the list, may be 0.
+ @param snapshot Specifies if the count should be based on the snapshot.
+ 
+ @return The number of visible indexes.
+ */
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot;
+
+/**
+ Enumerates the runs of visible indexes among the first `total` children indexes
+ of the node that is found by traversing through the given indexes.
+ 
+ The children are merged against the range of indexes in a single pass. Every
+ run of consecutive visible indexes is reported once, in ascending order,
+ together with the dynamic index of its first index. If there is no node for
+ the indexes, all indexes are reported as one run. If the node or one of its
+ ancestors is not visible, nothing is reported.
+ 
+ @param total    The number of indexes to enumerate.
+ @param indexes  A pointer to a list of indexes that represent the indexes of
+                 the index path from the receiver's node to the node whose
+                 children should be enumerated.
+ @param depth    The number of indexes in the list, may be 0.
+ @param snapshot Specifies if the enumeration should be based on the snapshot.
+ @param block    The block that is called for every run. Set `stop` to `YES` to
+                 stop the enumeration.
+ */
+- (void)enumerateVisibleRangesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot usingBlock:(void(^)(NSRange range, NSUInteger dynamicIndex, BOOL *stop))block;
+
+/**
+ Captures the current visibility of all descendants of the receiver.
+ 
+ The receiver itself is always captured as visible as a node never evaluates its
+ own condition.
+ 
+ @param snapshot Specifies if the already evaluated results should be reused for
+                 conditions that were not invalidated.
+ 
+ @return A state tree that mirrors the receiver's tree.
+ */
+- (HRSIndexPathMapperState *)stateUsingSnapshot:(BOOL)snapshot;
+
+/**
+ Marks the condition for the given indexes as changed by traversing through the
+ child hierarchy like `removeConditionForIndexes:depth:descendant:`.
+ 
+ Only the condition of the node found is evaluated again the next time the
+ snapshot of its parent is used. All other results are reused and the snapshot
+ is updated in logarithmic time instead of being rebuilt.
+ 
+ @param indexes A pointer to a list of indexes that represent the remaining
+                indexes of the index path from the receiver's node to the
+                leaf.
+ @param depth   The number of indexes in the list.
+ */
+- (void)invalidateConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth;
+
+/**
+ Marks the conditions of all descendants of the receiver as changed and
+ discards their snapshots.
+ 
+ The snapshots are rebuilt lazily the next time a mapping method is called with
+ `snapshot` set to `YES`.
+ */
+- (void)invalidateConditions;
+
 @end
@@ -14,14 +14,184 @@
 
 #import "HRSIndexPathMapperNode.h"
 
+#import "HRSIndexPathMapperState.h"
 
-@interface HRSIndexPathMapperNode ()
+#import <mach/mach_time.h>
+#import <objc/message.h>
+
+
+static void *HRSIndexPathMapperNodeObservationContext = &HRSIndexPathMapperNodeObservationContext;
+
+static void HRSIndexPathMapperCollectKeyPathsFromPredicate(NSPredicate *predicate, NSMutableSet *keyPaths);
+
+static void HRSIndexPathMapperCollectKeyPathsFromExpression(NSExpression *expression, NSMutableSet *keyPaths) {
+	switch (expression.expressionType) {
+		case NSKeyPathExpressionType:
+			// collection operators like @count can not be observed
+			if ([expression.keyPath rangeOfString:@"@"].location == NSNotFound) {
+				[keyPaths addObject:expression.keyPath];
+			}
+			break;
+			
+		case NSFunctionExpressionType:
+			HRSIndexPathMapperCollectKeyPathsFromExpression(expression.operand, keyPaths);
+			for (NSExpression *argument in expression.arguments) {
+				HRSIndexPathMapperCollectKeyPathsFromExpression(argument, keyPaths);
+			}
+			break;
+			
+		case NSConditionalExpressionType:
+			HRSIndexPathMapperCollectKeyPathsFromPredicate(expression.predicate, keyPaths);
+			HRSIndexPathMapperCollectKeyPathsFromExpression(expression.trueExpression, keyPaths);
+			HRSIndexPathMapperCollectKeyPathsFromExpression(expression.falseExpression, keyPaths);
+			break;
+			
+		default:
+			break;
+	}
+}
+
+static void HRSIndexPathMapperCollectKeyPathsFromPredicate(NSPredicate *predicate, NSMutableSet *keyPaths) {
+	if ([predicate isKindOfClass:[NSCompoundPredicate class]]) {
+		for (NSPredicate *subpredicate in [(NSCompoundPredicate *)predicate subpredicates]) {
+			HRSIndexPathMapperCollectKeyPathsFromPredicate(subpredicate, keyPaths);
+		}
+	} else if ([predicate isKindOfClass:[NSComparisonPredicate class]]) {
+		HRSIndexPathMapperCollectKeyPathsFromExpression([(NSComparisonPredicate *)predicate leftExpression], keyPaths);
+		HRSIndexPathMapperCollectKeyPathsFromExpression([(NSComparisonPredicate *)predicate rightExpression], keyPaths);
+	}
+}
+
+
+/**
+ Returns the getter of a predicate in the form `key == YES` or `key != NO` (and
+ their variations) if the evaluation object implements it with a `BOOL` return
+ type. Such a predicate can be evaluated by calling the getter directly instead
+ of going through key-value coding.
+ 
+ @param predicate     The predicate to compile.
+ @param object        The object the predicate is evaluated on.
+ @param expectedValue On return, the value the getter must return for the
+                      predicate to evaluate to `YES`.
+ 
+ @return The getter or `NULL` if the predicate cannot be compiled.
+ */
+static SEL HRSIndexPathMapperGetterForPredicate(NSPredicate *predicate, id object, BOOL *expectedValue) {
+	if (object == nil || [predicate isKindOfClass:[NSComparisonPredicate class]] == NO) {
+		return NULL;
+	}
+	
+	NSComparisonPredicate *comparison = (NSComparisonPredicate *)predicate;
+	if (comparison.comparisonPredicateModifier != NSDirectPredicateModifier || comparison.options != 0) {
+		return NULL;
+	}
+	
+	BOOL negated;
+	if (comparison.predicateOperatorType == NSEqualToPredicateOperatorType) {
+		negated = NO;
+	} else if (comparison.predicateOperatorType == NSNotEqualToPredicateOperatorType) {
+		negated = YES;
+	} else {
+		return NULL;
+	}
+	
+	NSExpression *keyPathExpression = comparison.leftExpression;
+	NSExpression *valueExpression = comparison.rightExpression;
+	if (keyPathExpression.expressionType != NSKeyPathExpressionType || valueExpression.expressionType != NSConstantValueExpressionType) {
+		return NULL;
+	}
+	
+	// only a single key can be mapped to a getter
+	NSString *key = keyPathExpression.keyPath;
+	if ([key rangeOfString:@"."].location != NSNotFound || [key rangeOfString:@"@"].location != NSNotFound) {
+		return NULL;
+	}
+	
+	id value = valueExpression.constantValue;
+	if ([value isKindOfClass:[NSNumber class]] == NO || ([value isEqual:@YES] == NO && [value isEqual:@NO] == NO)) {
+		return NULL;
+	}
+	
+	SEL getter = NSSelectorFromString(key);
+	if ([object respondsToSelector:getter] == NO) {
+		return NULL;
+	}
+	const char *returnType = [[object methodSignatureForSelector:getter] methodReturnType];
+	if (strcmp(returnType, @encode(BOOL)) != 0 && strcmp(returnType, @encode(bool)) != 0) {
+		return NULL;
+	}
+	
+	*expectedValue = ([value boolValue] != negated);
+	return getter;
+}
+
+
+/**
+ The way a node evaluates its condition. The type is determined once when the
+ condition is set, so that the evaluation itself does not need to inspect the
+ condition again.
+ */
+typedef NS_ENUM(NSUInteger, HRSIndexPathMapperNodeConditionType) {
+	/// the node has no condition and is always visible
+	HRSIndexPathMapperNodeConditionTypeNone,
+	/// the condition always evaluates to the same result
+	HRSIndexPathMapperNodeConditionTypeConstant,
+	/// the condition is a block that is invoked directly
+	HRSIndexPathMapperNodeConditionTypeBlock,
+	/// the condition compares a `BOOL` getter of the evaluation object
+	HRSIndexPathMapperNodeConditionTypeGetter,
+	/// the condition is a predicate that is evaluated on the evaluation object
+	HRSIndexPathMapperNodeConditionTypePredicate
+};
+
+
+@interface HRSIndexPathMapperNode () {
+	HRSIndexPathMapperNodeConditionType _conditionType;
+	BOOL (^_conditionBlock)(void);
+	SEL _conditionGetter;
+	BOOL _conditionValue;
+	
+	BOOL _conditionResultValid;
+	BOOL _conditionResult;
+	
+	// The children are stored as a flat list, sorted by their index. The
+	// indexes and lengths are kept in plain buffers, so that finding a child is
+	// a binary search that never touches the child objects. All buffers share
+	// the same capacity; the hidden counts have one additional element.
+	NSUInteger _childCount;
+	NSUInteger _childCapacity;
+	NSUInteger *_childIndexes;
+	NSUInteger *_childLengths;
+	NSMutableArray *_childNodes;
+	
+	// The snapshot keeps the visibility of every child and a Fenwick tree over
+	// the gaps between the dynamic indexes the children would have if they
+	// were visible. Element i of the tree is `index(i) - index(i - 1) -
+	// hiddenLength(i - 1)`, so the sum of the first i + 1 elements is the
+	// dynamic index of child i and all elements are non-negative. A child whose
+	// visibility flips only changes the element of its successor. The tree has
+	// one additional element as it is 1-based.
+	BOOL _snapshotValid;
+	BOOL *_snapshotVisibility;
+	NSUInteger *_snapshotTree;
+	NSUInteger _snapshotHiddenCount;
+	NSMutableIndexSet *_snapshotInvalidPositions;
+	
+	// The evaluation observer of the root node, shared by all nodes of its
+	// tree, so that an evaluation neither walks up to the root nor touches
+	// any other tree.
+	void (^_treeEvaluationObserver)(HRSIndexPathMapperNode *node, BOOL result, NSTimeInterval duration);
+}
 
 @property (nonatomic, assign, readwrite) NSUInteger index;
+@property (nonatomic, assign, readwrite) NSUInteger length;
 @property (nonatomic, strong, readwrite) NSPredicate *predicate;
 @property (nonatomic, weak, readwrite) id evaluationObject;
+@property (nonatomic, weak, readwrite) HRSIndexPathMapperNode *parent;
+@property (nonatomic, strong, readwrite) NSArray *observedKeyPaths;
 
 @property (nonatomic, assign, readonly, getter=isLeaf) BOOL leaf;
+@property (nonatomic, assign, readonly) BOOL hasCondition;
 
 @end
 
@@ -37,13 +207,361 @@
 	self = [super init];
 	if (self) {
 		_index = index;
-		_children = [NSArray array];
+		_length = 1;
+		_childNodes = [NSMutableArray array];
 	}
 	return self;
 }
 
+- (void)dealloc {
+	[self stopObservingEvaluationObject];
+	free(_childIndexes);
+	free(_childLengths);
+	free(_snapshotVisibility);
+	free(_snapshotTree);
+}
+
 - (BOOL)isLeaf {
-	return (self.children.count == 0);
+	return (_childCount == 0);
+}
+
+- (NSArray *)children {
+	return [_childNodes copy];
+}
+
+- (BOOL)hasCondition {
+	return (_conditionType != HRSIndexPathMapperNodeConditionTypeNone);
+}
+
+- (NSIndexPath *)indexPath {
+	NSUInteger length = 0;
+	for (HRSIndexPathMapperNode *node = self; node.parent; node = node.parent) {
+		length++;
+	}
+	
+	NSUInteger indexes[MAX(length, 1u)];
+	NSUInteger position = length;
+	for (HRSIndexPathMapperNode *node = self; node.parent; node = node.parent) {
+		indexes[--position] = node.index;
+	}
+	return [NSIndexPath indexPathWithIndexes:indexes length:length];
+}
+
+static inline BOOL HRSIndexPathMapperNodeEvaluateCondition(HRSIndexPathMapperNode *node) {
+	switch (node->_conditionType) {
+		case HRSIndexPathMapperNodeConditionTypeNone:
+			return YES;
+		case HRSIndexPathMapperNodeConditionTypeConstant:
+			return node->_conditionValue;
+		case HRSIndexPathMapperNodeConditionTypeBlock:
+			return node->_conditionBlock();
+		case HRSIndexPathMapperNodeConditionTypeGetter: {
+			id object = node.evaluationObject;
+			if (object) {
+				return (((BOOL (*)(id, SEL))objc_msgSend)(object, node->_conditionGetter) == node->_conditionValue);
+			}
+			return [node.predicate evaluateWithObject:nil];
+		}
+		case HRSIndexPathMapperNodeConditionTypePredicate:
+			return [node.predicate evaluateWithObject:node.evaluationObject];
+	}
+}
+
+- (BOOL)evaluateCondition {
+	void (^observer)(HRSIndexPathMapperNode *, BOOL, NSTimeInterval) = _treeEvaluationObserver;
+	if (observer == nil || _conditionType == HRSIndexPathMapperNodeConditionTypeNone) {
+		return HRSIndexPathMapperNodeEvaluateCondition(self);
+	}
+	
+	static mach_timebase_info_data_t timebase;
+	if (timebase.denom == 0) {
+		mach_timebase_info(&timebase);
+	}
+	uint64_t start = mach_absolute_time();
+	BOOL result = HRSIndexPathMapperNodeEvaluateCondition(self);
+	uint64_t end = mach_absolute_time();
+	observer(self, result, (NSTimeInterval)(end - start) * timebase.numer / timebase.denom / NSEC_PER_SEC);
+	return result;
+}
+
+- (void)setEvaluationObserver:(void (^)(HRSIndexPathMapperNode *, BOOL, NSTimeInterval))evaluationObserver {
+	_evaluationObserver = [evaluationObserver copy];
+	[self setTreeEvaluationObserver:_evaluationObserver];
+}
+
+- (void)setTreeEvaluationObserver:(void (^)(HRSIndexPathMapperNode *, BOOL, NSTimeInterval))observer {
+	_treeEvaluationObserver = observer;
+	for (HRSIndexPathMapperNode *child in _childNodes) {
+		[child setTreeEvaluationObserver:observer];
+	}
+}
+
+- (BOOL)cachedConditionResult {
+	if (_conditionResultValid == NO) {
+		_conditionResult = [self evaluateCondition];
+		_conditionResultValid = YES;
+	}
+	return _conditionResult;
+}
+
+- (void)setPredicate:(NSPredicate *)predicate evaluationObject:(id)object {
+	[self stopObservingEvaluationObject];
+	self.predicate = predicate;
+	self.evaluationObject = object;
+	_conditionBlock = nil;
+	[self compileCondition];
+	[self startObservingEvaluationObject];
+	[self invalidateCondition];
+}
+
+- (void)setConditionBlock:(BOOL(^)(void))block {
+	[self stopObservingEvaluationObject];
+	self.predicate = nil;
+	self.evaluationObject = nil;
+	_conditionBlock = [block copy];
+	_conditionType = (block ? HRSIndexPathMapperNodeConditionTypeBlock : HRSIndexPathMapperNodeConditionTypeNone);
+	[self invalidateCondition];
+}
+
+- (void)compileCondition {
+	_conditionGetter = NULL;
+	
+	NSPredicate *predicate = self.predicate;
+	if (predicate == nil) {
+		_conditionType = HRSIndexPathMapperNodeConditionTypeNone;
+		return;
+	}
+	
+	// predicates created with +predicateWithValue: do not depend on the object
+	if ([predicate isKindOfClass:[NSComparisonPredicate class]] == NO && [predicate isKindOfClass:[NSCompoundPredicate class]] == NO) {
+		NSString *format = predicate.predicateFormat;
+		if ([format isEqualToString:@"TRUEPREDICATE"] || [format isEqualToString:@"FALSEPREDICATE"]) {
+			_conditionType = HRSIndexPathMapperNodeConditionTypeConstant;
+			_conditionValue = [format isEqualToString:@"TRUEPREDICATE"];
+			return;
+		}
+	}
+	
+	BOOL value;
+	SEL getter = HRSIndexPathMapperGetterForPredicate(predicate, self.evaluationObject, &value);
+	if (getter) {
+		_conditionType = HRSIndexPathMapperNodeConditionTypeGetter;
+		_conditionGetter = getter;
+		_conditionValue = value;
+		return;
+	}
+	
+	_conditionType = HRSIndexPathMapperNodeConditionTypePredicate;
+}
+
+- (void)setConditionOfNode:(HRSIndexPathMapperNode *)node {
+	if (node->_conditionBlock) {
+		[self setConditionBlock:node->_conditionBlock];
+	} else {
+		[self setPredicate:node.predicate evaluationObject:node.evaluationObject];
+	}
+}
+
+
+
+#pragma mark - children
+
+/**
+ Returns the position of the first child whose index is greater than or equal
+ to the given index.
+ */
+- (NSUInteger)positionForIndex:(NSUInteger)index {
+	// appending in ascending order is the most common case
+	if (_childCount == 0 || _childIndexes[_childCount - 1] < index) {
+		return _childCount;
+	}
+	
+	NSUInteger lower = 0;
+	NSUInteger upper = _childCount;
+	while (lower < upper) {
+		NSUInteger middle = lower + (upper - lower) / 2;
+		if (_childIndexes[middle] < index) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+- (NSUInteger)positionOfChildWithIndex:(NSUInteger)index {
+	NSUInteger position = [self positionForIndex:index];
+	if (position < _childCount && _childIndexes[position] == index) {
+		return position;
+	}
+	return NSNotFound;
+}
+
+/**
+ Returns the position of the child that covers the given index or, if there is
+ none, the position of the first child behind the index.
+ */
+- (NSUInteger)positionForCoveredIndex:(NSUInteger)index {
+	NSUInteger position = [self positionForIndex:index];
+	if (position > 0 && _childIndexes[position - 1] + _childLengths[position - 1] > index) {
+		return position - 1;
+	}
+	return position;
+}
+
+- (NSUInteger)positionOfChildCoveringIndex:(NSUInteger)index {
+	NSUInteger position = [self positionForCoveredIndex:index];
+	if (position < _childCount && _childIndexes[position] <= index) {
+		return position;
+	}
+	return NSNotFound;
+}
+
+- (void)ensureChildCapacity:(NSUInteger)capacity {
+	if (capacity <= _childCapacity) {
+		return;
+	}
+	
+	_childCapacity = MAX(MAX(_childCapacity * 2, 4), capacity);
+	_childIndexes = realloc(_childIndexes, _childCapacity * sizeof(NSUInteger));
+	_childLengths = realloc(_childLengths, _childCapacity * sizeof(NSUInteger));
+	_snapshotVisibility = realloc(_snapshotVisibility, _childCapacity * sizeof(BOOL));
+	_snapshotTree = realloc(_snapshotTree, (_childCapacity + 1) * sizeof(NSUInteger));
+}
+
+- (HRSIndexPathMapperNode *)newChildWithIndex:(NSUInteger)index {
+	HRSIndexPathMapperNode *child = [[HRSIndexPathMapperNode alloc] initWithIndex:index];
+	child.parent = self;
+	child.observesEvaluationObject = self.observesEvaluationObject;
+	child->_treeEvaluationObserver = _treeEvaluationObserver;
+	return child;
+}
+
+- (HRSIndexPathMapperNode *)insertChildWithIndex:(NSUInteger)index atPosition:(NSUInteger)position {
+	return [self insertChildWithIndex:index length:1 atPosition:position];
+}
+
+- (HRSIndexPathMapperNode *)insertChildWithIndex:(NSUInteger)index length:(NSUInteger)length atPosition:(NSUInteger)position {
+	[self ensureChildCapacity:_childCount + 1];
+	
+	if (position < _childCount) {
+		memmove(&_childIndexes[position + 1], &_childIndexes[position], (_childCount - position) * sizeof(NSUInteger));
+		memmove(&_childLengths[position + 1], &_childLengths[position], (_childCount - position) * sizeof(NSUInteger));
+	}
+	_childIndexes[position] = index;
+	_childLengths[position] = length;
+	_childCount++;
+	
+	HRSIndexPathMapperNode *child = [self newChildWithIndex:index];
+	child.length = length;
+	[_childNodes insertObject:child atIndex:position];
+	
+	_snapshotValid = NO;
+	return child;
+}
+
+- (void)removeChildAtPosition:(NSUInteger)position {
+	[self removeChildrenInPositionRange:NSMakeRange(position, 1)];
+}
+
+- (void)removeChildrenInPositionRange:(NSRange)range {
+	if (range.length == 0) {
+		return;
+	}
+	
+	NSUInteger end = NSMaxRange(range);
+	if (end < _childCount) {
+		memmove(&_childIndexes[range.location], &_childIndexes[end], (_childCount - end) * sizeof(NSUInteger));
+		memmove(&_childLengths[range.location], &_childLengths[end], (_childCount - end) * sizeof(NSUInteger));
+	}
+	_childCount -= range.length;
+	[_childNodes removeObjectsInRange:range];
+	
+	_snapshotValid = NO;
+}
+
+/**
+ Makes sure that no child covers both the given index and the index in front of
+ it by splitting the range child that does into two children with the same
+ condition.
+ */
+- (void)splitChildrenAtIndex:(NSUInteger)index {
+	NSUInteger position = [self positionForIndex:index];
+	if (position == 0) {
+		return;
+	}
+	position--;
+	
+	NSUInteger start = _childIndexes[position];
+	NSUInteger end = start + _childLengths[position];
+	if (end <= index) {
+		return;
+	}
+	
+	HRSIndexPathMapperNode *child = _childNodes[position];
+	_childLengths[position] = index - start;
+	child.length = index - start;
+	
+	HRSIndexPathMapperNode *remainder = [self insertChildWithIndex:index length:end - index atPosition:position + 1];
+	[remainder setConditionOfNode:child];
+}
+
+/**
+ Splits the range child that covers the given index, if there is any, so that
+ the index is represented by a child of its own that keeps the condition of the
+ range.
+ */
+- (void)isolateIndex:(NSUInteger)index {
+	[self splitChildrenAtIndex:index];
+	[self splitChildrenAtIndex:index + 1];
+}
+
+/**
+ Removes all children inside the given range and returns the position the range
+ starts at. Range children that are only partially inside are cut.
+ */
+- (NSUInteger)removeChildrenInRange:(NSRange)range {
+	[self splitChildrenAtIndex:range.location];
+	[self splitChildrenAtIndex:NSMaxRange(range)];
+	
+	NSUInteger position = [self positionForIndex:range.location];
+	NSUInteger end = [self positionForIndex:NSMaxRange(range)];
+	[self removeChildrenInPositionRange:NSMakeRange(position, end - position)];
+	return position;
+}
+
+/**
+ Replaces all children inside the given range by a single child that covers the
+ whole range.
+ */
+- (HRSIndexPathMapperNode *)replaceChildrenInRange:(NSRange)range {
+	NSUInteger position = [self removeChildrenInRange:range];
+	return [self insertChildWithIndex:range.location length:range.length atPosition:position];
+}
+
+/**
+ Isolates all indexes of the given items at `level` that are covered by a range
+ child. Both lists are sorted, so they are walked side by side.
+ */
+- (void)isolateIndexesOfItems:(HRSIndexPathMapperConditionItem *)items count:(NSUInteger)count level:(NSUInteger)level {
+	NSMutableIndexSet *coveredIndexes;
+	NSUInteger position = 0;
+	for (NSUInteger item = 0; item < count; item++) {
+		NSUInteger index = items[item].indexes[level];
+		while (position < _childCount && _childIndexes[position] + _childLengths[position] <= index) {
+			position++;
+		}
+		if (position < _childCount && _childLengths[position] > 1 && _childIndexes[position] <= index) {
+			if (coveredIndexes == nil) {
+				coveredIndexes = [NSMutableIndexSet indexSet];
+			}
+			[coveredIndexes addIndex:index];
+		}
+	}
+	
+	[coveredIndexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+		[self isolateIndex:index];
+	}];
 }
 
 
@@ -57,75 +575,558 @@
 		return;
 	}
 	
-	NSUInteger objectIndex = [self.children indexOfObjectPassingTest:^BOOL(HRSIndexPathMapperNode *child, NSUInteger idx, BOOL *stop) {
-		return (child.index == indexes[0]);
-	}];
+	[[self descendantForIndexes:indexes depth:depth] setPredicate:predicate evaluationObject:object];
+}
+
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth block:(BOOL(^)(void))block {
+	NSParameterAssert(block);
+	if (block == NULL) {
+		return;
+	}
 	
-	HRSIndexPathMapperNode *child;
-	if (objectIndex == NSNotFound) {
-		child = [[HRSIndexPathMapperNode alloc] initWithIndex:indexes[0]];
-		NSArray *children = [[self.children arrayByAddingObject:child] sortedArrayUsingDescriptors:@[ [NSSortDescriptor sortDescriptorWithKey:@"index" ascending:YES] ]];
-		self.children = children;
-	} else {
-		child = self.children[objectIndex];
+	[[self descendantForIndexes:indexes depth:depth] setConditionBlock:block];
+}
+
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range predicate:(NSPredicate *)predicate evaluationObject:(id)object {
+	NSParameterAssert(range.length > 0);
+	NSParameterAssert(predicate);
+	NSParameterAssert(object);
+	if (range.length == 0 || predicate == nil || object == nil) {
+		return;
 	}
-	if (depth > 1) {
-		[child setConditionForIndexes:&indexes[1] depth:--depth predicate:predicate evaluationObject:object];
-	} else {
-		child.predicate = predicate;
-		child.evaluationObject = object;
+	
+	HRSIndexPathMapperNode *node = [self descendantForIndexes:indexes depth:depth];
+	[[node replaceChildrenInRange:range] setPredicate:predicate evaluationObject:object];
+}
+
+- (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range block:(BOOL(^)(void))block {
+	NSParameterAssert(range.length > 0);
+	NSParameterAssert(block);
+	if (range.length == 0 || block == NULL) {
+		return;
+	}
+	
+	HRSIndexPathMapperNode *node = [self descendantForIndexes:indexes depth:depth];
+	[[node replaceChildrenInRange:range] setConditionBlock:block];
+}
+
+- (HRSIndexPathMapperNode *)descendantForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	HRSIndexPathMapperNode *node = self;
+	for (NSUInteger level = 0; level < depth; level++) {
+		// a range never has children, so the index needs a node of its own
+		[node isolateIndex:indexes[level]];
+		
+		NSUInteger position = [node positionForIndex:indexes[level]];
+		if (position < node->_childCount && node->_childIndexes[position] == indexes[level]) {
+			node = node->_childNodes[position];
+		} else {
+			node = [node insertChildWithIndex:indexes[level] atPosition:position];
+		}
 	}
+	return node;
 }
 
 - (void)removeConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth descendant:(BOOL)descendant {
-	NSUInteger objectIndex = [self.children indexOfObjectPassingTest:^BOOL(HRSIndexPathMapperNode *child, NSUInteger idx, BOOL *stop) {
-		return (child.index == indexes[0]);
-	}];
+	if (depth == 1) {
+		[self isolateIndex:indexes[0]];
+	}
 	
-	if (objectIndex == NSNotFound) {
+	NSUInteger position = [self positionOfChildWithIndex:indexes[0]];
+	if (position == NSNotFound) {
 		return;
 	}
 	
-	HRSIndexPathMapperNode *child = self.children[objectIndex];
+	HRSIndexPathMapperNode *child = _childNodes[position];
 	if (depth > 1) {
-		[child removeConditionForIndexes:indexes depth:--depth descendant:descendant];
+		[child removeConditionForIndexes:&indexes[1] depth:--depth descendant:descendant];
+		
+		// a node without children and without a condition has no meaning
+		if (child.isLeaf && child.hasCondition == NO) {
+			[self removeChildAtPosition:position];
+		}
 	} else if (descendant || child.isLeaf) {
-		NSMutableArray *children = [self.children mutableCopy];
-		[children removeObjectAtIndex:objectIndex];
-		self.children = [NSArray arrayWithArray:children];
+		[self removeChildAtPosition:position];
+	} else {
+		[child setPredicate:nil evaluationObject:nil];
+	}
+}
+
+- (void)removeConditionsForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth range:(NSRange)range {
+	if (range.length == 0) {
+		return;
+	}
+	
+	if (depth == 0) {
+		[self removeChildrenInRange:range];
+		return;
+	}
+	
+	NSUInteger position = [self positionOfChildWithIndex:indexes[0]];
+	if (position == NSNotFound) {
+		return;
+	}
+	
+	HRSIndexPathMapperNode *child = _childNodes[position];
+	[child removeConditionsForIndexes:&indexes[1] depth:depth - 1 range:range];
+	
+	// a node without children and without a condition has no meaning
+	if (child.isLeaf && child.hasCondition == NO) {
+		[self removeChildAtPosition:position];
+	}
+}
+
+
+
+#pragma mark - bulk configuration
+
+- (void)setConditions:(HRSIndexPathMapperConditionItem *)items count:(NSUInteger)count level:(NSUInteger)level {
+	if (count == 0) {
+		return;
+	}
+	[self isolateIndexesOfItems:items count:count level:level];
+	
+	// count the indexes that do not have a child yet
+	NSUInteger missingCount = 0;
+	NSUInteger position = 0;
+	for (NSUInteger item = 0; item < count; item++) {
+		NSUInteger index = items[item].indexes[level];
+		if (item > 0 && items[item - 1].indexes[level] == index) {
+			continue;
+		}
+		while (position < _childCount && _childIndexes[position] < index) {
+			position++;
+		}
+		if (position == _childCount || _childIndexes[position] != index) {
+			missingCount++;
+		}
+	}
+	
+	// merge the missing children into the existing ones in a single pass
+	if (missingCount > 0) {
+		NSUInteger mergedCount = _childCount + missingCount;
+		NSUInteger *mergedIndexes = malloc(mergedCount * sizeof(NSUInteger));
+		NSUInteger *mergedLengths = malloc(mergedCount * sizeof(NSUInteger));
+		NSMutableArray *mergedNodes = [NSMutableArray arrayWithCapacity:mergedCount];
+		
+		NSUInteger oldPosition = 0;
+		NSUInteger mergedPosition = 0;
+		for (NSUInteger item = 0; item < count; item++) {
+			NSUInteger index = items[item].indexes[level];
+			if (item > 0 && items[item - 1].indexes[level] == index) {
+				continue;
+			}
+			while (oldPosition < _childCount && _childIndexes[oldPosition] < index) {
+				mergedIndexes[mergedPosition] = _childIndexes[oldPosition];
+				mergedLengths[mergedPosition++] = _childLengths[oldPosition];
+				[mergedNodes addObject:_childNodes[oldPosition++]];
+			}
+			if (oldPosition < _childCount && _childIndexes[oldPosition] == index) {
+				continue;
+			}
+			mergedIndexes[mergedPosition] = index;
+			mergedLengths[mergedPosition++] = 1;
+			[mergedNodes addObject:[self newChildWithIndex:index]];
+		}
+		while (oldPosition < _childCount) {
+			mergedIndexes[mergedPosition] = _childIndexes[oldPosition];
+			mergedLengths[mergedPosition++] = _childLengths[oldPosition];
+			[mergedNodes addObject:_childNodes[oldPosition++]];
+		}
+		
+		[self ensureChildCapacity:mergedCount];
+		memcpy(_childIndexes, mergedIndexes, mergedCount * sizeof(NSUInteger));
+		memcpy(_childLengths, mergedLengths, mergedCount * sizeof(NSUInteger));
+		free(mergedIndexes);
+		free(mergedLengths);
+		_childNodes = mergedNodes;
+		_childCount = mergedCount;
+		_snapshotValid = NO;
+	}
+	
+	// hand the items down to the children
+	position = 0;
+	NSUInteger item = 0;
+	while (item < count) {
+		NSUInteger index = items[item].indexes[level];
+		NSUInteger groupEnd = item + 1;
+		while (groupEnd < count && items[groupEnd].indexes[level] == index) {
+			groupEnd++;
+		}
+		while (_childIndexes[position] < index) {
+			position++;
+		}
+		HRSIndexPathMapperNode *child = _childNodes[position];
+		
+		// the item that ends at this level is sorted in front of its descendants
+		if (items[item].length == level + 1) {
+			if (items[item].block) {
+				[child setConditionBlock:items[item].block];
+			} else {
+				[child setPredicate:items[item].predicate evaluationObject:items[item].evaluationObject];
+			}
+			item++;
+		}
+		if (item < groupEnd) {
+			[child setConditions:&items[item] count:groupEnd - item level:level + 1];
+		}
+		
+		item = groupEnd;
+	}
+}
+
+- (void)removeConditions:(HRSIndexPathMapperConditionItem *)items count:(NSUInteger)count level:(NSUInteger)level descendant:(BOOL)descendant {
+	[self isolateIndexesOfItems:items count:count level:level];
+	NSMutableIndexSet *removedPositions = [NSMutableIndexSet indexSet];
+	
+	NSUInteger position = 0;
+	NSUInteger item = 0;
+	while (item < count) {
+		NSUInteger index = items[item].indexes[level];
+		NSUInteger groupEnd = item + 1;
+		while (groupEnd < count && items[groupEnd].indexes[level] == index) {
+			groupEnd++;
+		}
+		while (position < _childCount && _childIndexes[position] < index) {
+			position++;
+		}
+		if (position == _childCount || _childIndexes[position] != index) {
+			item = groupEnd;
+			continue;
+		}
+		HRSIndexPathMapperNode *child = _childNodes[position];
+		
+		// the item that ends at this level is sorted in front of its descendants
+		if (items[item].length == level + 1) {
+			if (descendant || child.isLeaf) {
+				[removedPositions addIndex:position];
+				item = groupEnd;
+				continue;
+			}
+			[child setPredicate:nil evaluationObject:nil];
+			item++;
+		}
+		if (item < groupEnd) {
+			[child removeConditions:&items[item] count:groupEnd - item level:level + 1 descendant:descendant];
+		}
+		
+		// a node without children and without a condition has no meaning
+		if (child.isLeaf && child.hasCondition == NO) {
+			[removedPositions addIndex:position];
+		}
+		
+		item = groupEnd;
+	}
+	
+	if (removedPositions.count == 0) {
+		return;
+	}
+	
+	NSUInteger keptCount = 0;
+	for (NSUInteger childPosition = 0; childPosition < _childCount; childPosition++) {
+		if ([removedPositions containsIndex:childPosition] == NO) {
+			_childIndexes[keptCount] = _childIndexes[childPosition];
+			_childLengths[keptCount++] = _childLengths[childPosition];
+		}
+	}
+	[_childNodes removeObjectsAtIndexes:removedPositions];
+	_childCount = keptCount;
+	_snapshotValid = NO;
+}
+
+
+
+#pragma mark - state
+
+- (HRSIndexPathMapperState *)stateUsingSnapshot:(BOOL)snapshot {
+	return [self stateWithVisibility:YES snapshot:snapshot];
+}
+
+- (HRSIndexPathMapperState *)stateWithVisibility:(BOOL)visible snapshot:(BOOL)snapshot {
+	NSMutableArray *children = [NSMutableArray arrayWithCapacity:(visible ? _childCount : 0)];
+	if (visible) {
+		for (HRSIndexPathMapperNode *child in _childNodes) {
+			BOOL childVisible = (snapshot ? [child cachedConditionResult] : [child evaluateCondition]);
+			[children addObject:[child stateWithVisibility:childVisible snapshot:snapshot]];
+		}
+	}
+	return [[HRSIndexPathMapperState alloc] initWithIndex:self.index length:self.length visible:visible children:children];
+}
+
+
+
+#pragma mark - invalidation
+
+- (void)invalidateCondition {
+	_conditionResultValid = NO;
+	[self.parent invalidateSnapshotOfChild:self];
+}
+
+/**
+ Marks the snapshot entry of the given child as changed, so that only this
+ child is evaluated and updated in the snapshot the next time it is used.
+ */
+- (void)invalidateSnapshotOfChild:(HRSIndexPathMapperNode *)child {
+	if (_snapshotValid == NO) {
+		return;
+	}
+	
+	NSUInteger position = [self positionOfChildWithIndex:child.index];
+	if (position == NSNotFound || _childNodes[position] != child) {
+		_snapshotValid = NO;
+		return;
+	}
+	
+	if (_snapshotInvalidPositions == nil) {
+		_snapshotInvalidPositions = [NSMutableIndexSet indexSet];
+	}
+	[_snapshotInvalidPositions addIndex:position];
+}
+
+- (void)invalidateConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	NSUInteger position = [self positionOfChildCoveringIndex:indexes[0]];
+	if (position == NSNotFound) {
+		return;
+	}
+	
+	HRSIndexPathMapperNode *child = _childNodes[position];
+	if (depth > 1) {
+		[child invalidateConditionForIndexes:&indexes[1] depth:--depth];
+	} else {
+		[child invalidateCondition];
+	}
+}
+
+- (void)invalidateConditions {
+	_snapshotValid = NO;
+	for (HRSIndexPathMapperNode *child in _childNodes) {
+		child->_conditionResultValid = NO;
+		[child invalidateConditions];
+	}
+}
+
+
+
+#pragma mark - observation
+
+- (void)setObservesEvaluationObject:(BOOL)observesEvaluationObject {
+	if (_observesEvaluationObject == observesEvaluationObject) {
+		return;
+	}
+	
+	if (observesEvaluationObject) {
+		_observesEvaluationObject = YES;
+		[self startObservingEvaluationObject];
 	} else {
-		child.predicate = nil;
-		child.evaluationObject = nil;
+		[self stopObservingEvaluationObject];
+		_observesEvaluationObject = NO;
+	}
+	
+	for (HRSIndexPathMapperNode *child in _childNodes) {
+		child.observesEvaluationObject = observesEvaluationObject;
 	}
 }
 
+- (void)startObservingEvaluationObject {
+	id object = self.evaluationObject;
+	if (self.observesEvaluationObject == NO || self.predicate == nil || object == nil) {
+		return;
+	}
+	
+	NSMutableSet *keyPaths = [NSMutableSet set];
+	HRSIndexPathMapperCollectKeyPathsFromPredicate(self.predicate, keyPaths);
+	for (NSString *keyPath in keyPaths) {
+		[object addObserver:self forKeyPath:keyPath options:0 context:HRSIndexPathMapperNodeObservationContext];
+	}
+	self.observedKeyPaths = [keyPaths allObjects];
+}
+
+- (void)stopObservingEvaluationObject {
+	id object = self.evaluationObject;
+	for (NSString *keyPath in self.observedKeyPaths) {
+		[object removeObserver:self forKeyPath:keyPath context:HRSIndexPathMapperNodeObservationContext];
+	}
+	self.observedKeyPaths = nil;
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
+	if (context == HRSIndexPathMapperNodeObservationContext) {
+		[self invalidateCondition];
+	} else {
+		[super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+	}
+}
+
+
+
+#pragma mark - snapshot
+
+/// Returns the sum of the first `count` elements of a 1-based Fenwick tree.
+static inline NSUInteger HRSIndexPathMapperFenwickSum(NSUInteger *tree, NSUInteger count) {
+	NSUInteger sum = 0;
+	for (NSUInteger node = count; node > 0; node -= (node & -node)) {
+		sum += tree[node];
+	}
+	return sum;
+}
+
+/// Adds a value to an element of a 1-based Fenwick tree. Unsigned arithmetic
+/// wraps around, so a value can be subtracted by adding its two's complement.
+static inline void HRSIndexPathMapperFenwickAdd(NSUInteger *tree, NSUInteger count, NSUInteger position, NSUInteger value) {
+	for (NSUInteger node = position + 1; node <= count; node += (node & -node)) {
+		tree[node] += value;
+	}
+}
+
+/// Returns the number of leading elements of a 1-based Fenwick tree with
+/// non-negative elements whose sum is less than or equal to the given value.
+static inline NSUInteger HRSIndexPathMapperFenwickCount(NSUInteger *tree, NSUInteger count, NSUInteger value) {
+	NSUInteger step = 1;
+	while (step <= count / 2) {
+		step *= 2;
+	}
+	
+	NSUInteger position = 0;
+	for (; step > 0; step /= 2) {
+		if (position + step <= count && tree[position + step] <= value) {
+			position += step;
+			value -= tree[position];
+		}
+	}
+	return position;
+}
+
+/// Returns the number of hidden indexes in front of the child at the given
+/// position, based on the snapshot.
+static inline NSUInteger HRSIndexPathMapperNodeSnapshotHiddenCount(HRSIndexPathMapperNode *node, NSUInteger position) {
+	if (position >= node->_childCount) {
+		return node->_snapshotHiddenCount;
+	}
+	return node->_childIndexes[position] - HRSIndexPathMapperFenwickSum(node->_snapshotTree, position + 1);
+}
+
+- (void)buildSnapshotIfNeeded {
+	if (_snapshotValid) {
+		if (_snapshotInvalidPositions.count > 0) {
+			[self updateSnapshotAtInvalidPositions];
+		}
+		return;
+	}
+	
+	// Only children that were invalidated evaluate their condition again. The
+	// tree is built in linear time by pushing every element to its parent.
+	if (_snapshotTree == NULL) {
+		_snapshotTree = malloc(sizeof(NSUInteger));
+	}
+	_snapshotHiddenCount = 0;
+	NSUInteger previousIndex = 0;
+	NSUInteger previousHiddenLength = 0;
+	for (NSUInteger position = 0; position < _childCount; position++) {
+		HRSIndexPathMapperNode *child = _childNodes[position];
+		BOOL visible = [child cachedConditionResult];
+		_snapshotVisibility[position] = visible;
+		_snapshotTree[position + 1] = _childIndexes[position] - previousIndex - previousHiddenLength;
+		
+		previousIndex = _childIndexes[position];
+		previousHiddenLength = (visible ? 0 : _childLengths[position]);
+		_snapshotHiddenCount += previousHiddenLength;
+	}
+	for (NSUInteger node = 1; node <= _childCount; node++) {
+		NSUInteger parent = node + (node & -node);
+		if (parent <= _childCount) {
+			_snapshotTree[parent] += _snapshotTree[node];
+		}
+	}
+	
+	[_snapshotInvalidPositions removeAllIndexes];
+	_snapshotValid = YES;
+}
+
+/**
+ Evaluates the conditions of the children that were invalidated since the
+ snapshot was built and applies the changes to the tree, in logarithmic time
+ per child.
+ */
+- (void)updateSnapshotAtInvalidPositions {
+	for (NSUInteger position = _snapshotInvalidPositions.firstIndex; position != NSNotFound; position = [_snapshotInvalidPositions indexGreaterThanIndex:position]) {
+		BOOL visible = [_childNodes[position] cachedConditionResult];
+		if (visible == _snapshotVisibility[position]) {
+			continue;
+		}
+		_snapshotVisibility[position] = visible;
+		
+		// the successor moves by the length of the child
+		NSUInteger length = _childLengths[position];
+		if (visible) {
+			_snapshotHiddenCount -= length;
+			HRSIndexPathMapperFenwickAdd(_snapshotTree, _childCount, position + 1, length);
+		} else {
+			_snapshotHiddenCount += length;
+			HRSIndexPathMapperFenwickAdd(_snapshotTree, _childCount, position + 1, 0 - length);
+		}
+	}
+	[_snapshotInvalidPositions removeAllIndexes];
+}
+
+/**
+ Returns the position of the first child that is located behind the given
+ dynamic index.
+ 
+ For every child, `index - hiddenCount` is the dynamic index the child would
+ have if it was visible. This is the sum of the leading elements of the
+ snapshot tree, so the position is found by descending the tree once.
+ */
+- (NSUInteger)snapshotPositionForDynamicIndex:(NSUInteger)dynamicIndex {
+	return HRSIndexPathMapperFenwickCount(_snapshotTree, _childCount, dynamicIndex);
+}
+
 
 
 #pragma mark - mapping
 
 - (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	[self dynamicIndexesForStaticIndexes:indexes depth:depth snapshot:NO];
+}
+
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	[self staticIndexesForDynamicIndexes:indexes depth:depth snapshot:NO];
+}
+
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot {
 	NSUInteger staticIndex = indexes[0];
-	__block NSUInteger dynamicIndex = staticIndex;
+	NSUInteger dynamicIndex = staticIndex;
 	
-	__block HRSIndexPathMapperNode *nextNode;
+	HRSIndexPathMapperNode *nextNode;
 	
-	// TODO: We could introduce a short path for NSNotFound here if we are able to find the right node in O(1).
-	[self.children enumerateObjectsUsingBlock:^(HRSIndexPathMapperNode *child, NSUInteger idx, BOOL *stop) {
-		if (child.index < staticIndex) {
-			BOOL visible = (child.predicate ? [child.predicate evaluateWithObject:child.evaluationObject] : YES);
-			if (visible == NO) {
-				dynamicIndex--;
-			}
-		} else if (child.index == staticIndex) {
-			BOOL visible = (child.predicate ? [child.predicate evaluateWithObject:child.evaluationObject] : YES);
-			if (visible == NO) {
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+		
+		NSUInteger position = [self positionForCoveredIndex:staticIndex];
+		if (position < _childCount && _childIndexes[position] <= staticIndex) {
+			nextNode = _childNodes[position];
+			if (_snapshotVisibility[position] == NO) {
 				dynamicIndex = NSNotFound;
 			}
-			nextNode = child;
-		} else {
-			*stop = YES;
 		}
-	}];
+		if (dynamicIndex != NSNotFound) {
+			dynamicIndex = staticIndex - HRSIndexPathMapperNodeSnapshotHiddenCount(self, position);
+		}
+		
+	} else {
+		for (NSUInteger position = 0; position < _childCount && _childIndexes[position] <= staticIndex; position++) {
+			HRSIndexPathMapperNode *child = _childNodes[position];
+			NSUInteger length = _childLengths[position];
+			if (_childIndexes[position] + length <= staticIndex) {
+				if ([child evaluateCondition] == NO) {
+					dynamicIndex -= length;
+				}
+			} else {
+				if ([child evaluateCondition] == NO) {
+					dynamicIndex = NSNotFound;
+				}
+				nextNode = child;
+			}
+		}
+	}
 	
 	if (dynamicIndex == NSNotFound) {
 		// set all children to NSNotFound
@@ -138,35 +1139,288 @@
 		// if this node has a child with the corresponding index, there might be
 		// other conditions that need to be evaluated down the road!
 		if (nextNode && nextNode.isLeaf == NO && depth > 1) {
-			[nextNode dynamicIndexesForStaticIndexes:&indexes[1] depth:--depth];
+			[nextNode dynamicIndexesForStaticIndexes:&indexes[1] depth:--depth snapshot:snapshot];
 		}
 	}
 }
 
-- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot {
 	NSUInteger dynamicIndex = indexes[0];
 	
-	__block NSUInteger staticIndex = dynamicIndex;
-	__block NSUInteger childIndex = NSNotFound;
+	NSUInteger staticIndex = dynamicIndex;
+	NSUInteger childIndex = NSNotFound;
 	
-	[self.children enumerateObjectsUsingBlock:^(HRSIndexPathMapperNode *child, NSUInteger idx, BOOL *stop) {
-		if (child.index <= staticIndex) {
-			BOOL visible = (child.predicate ? [child.predicate evaluateWithObject:child.evaluationObject] : YES);
-			if (visible == NO) {
-				staticIndex++;
-			} else if (child.index == staticIndex) {
-				childIndex = idx;
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+		
+		NSUInteger position = [self snapshotPositionForDynamicIndex:dynamicIndex];
+		staticIndex = dynamicIndex + HRSIndexPathMapperNodeSnapshotHiddenCount(self, position);
+		if (position > 0 && _childIndexes[position - 1] == staticIndex) {
+			childIndex = position - 1;
+		}
+		
+	} else {
+		for (NSUInteger position = 0; position < _childCount && _childIndexes[position] <= staticIndex; position++) {
+			if ([_childNodes[position] evaluateCondition] == NO) {
+				staticIndex += _childLengths[position];
+			} else if (_childIndexes[position] == staticIndex) {
+				childIndex = position;
 			}
-		} else {
-			*stop = YES;
 		}
-	}];
+	}
 	
 	indexes[0] = staticIndex;
 	
 	if (childIndex != NSNotFound && depth > 1) {
-		HRSIndexPathMapperNode *child = self.children[childIndex];
-		[child staticIndexesForDynamicIndexes:&indexes[1] depth:--depth];
+		HRSIndexPathMapperNode *child = _childNodes[childIndex];
+		[child staticIndexesForDynamicIndexes:&indexes[1] depth:--depth snapshot:snapshot];
+	}
+}
+
+
+
+#pragma mark - counting
+
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot {
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+	}
+	
+	if (depth > 0) {
+		NSUInteger position = [self positionOfChildCoveringIndex:indexes[0]];
+		if (position == NSNotFound) {
+			return total;
+		}
+		
+		HRSIndexPathMapperNode *child = _childNodes[position];
+		BOOL visible = (snapshot ? _snapshotVisibility[position] : [child evaluateCondition]);
+		if (visible == NO) {
+			return 0;
+		}
+		return [child numberOfVisibleIndexesOfTotal:total forIndexes:&indexes[1] depth:depth - 1 snapshot:snapshot];
+	}
+	
+	NSUInteger hiddenCount = 0;
+	if (snapshot) {
+		NSUInteger position = [self positionForIndex:total];
+		hiddenCount = HRSIndexPathMapperNodeSnapshotHiddenCount(self, position);
+		
+		// a hidden range in front of the total may reach beyond it
+		if (position > 0 && _snapshotVisibility[position - 1] == NO) {
+			NSUInteger end = _childIndexes[position - 1] + _childLengths[position - 1];
+			if (end > total) {
+				hiddenCount -= end - total;
+			}
+		}
+		
+	} else {
+		for (NSUInteger position = 0; position < _childCount && _childIndexes[position] < total; position++) {
+			if ([_childNodes[position] evaluateCondition] == NO) {
+				hiddenCount += MIN(_childIndexes[position] + _childLengths[position], total) - _childIndexes[position];
+			}
+		}
+	}
+	return total - hiddenCount;
+}
+
+- (void)enumerateVisibleRangesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth snapshot:(BOOL)snapshot usingBlock:(void(^)(NSRange range, NSUInteger dynamicIndex, BOOL *stop))block {
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+	}
+	
+	BOOL stop = NO;
+	if (depth > 0) {
+		NSUInteger position = [self positionOfChildCoveringIndex:indexes[0]];
+		if (position == NSNotFound) {
+			if (total > 0) {
+				block(NSMakeRange(0, total), 0, &stop);
+			}
+			return;
+		}
+		
+		HRSIndexPathMapperNode *child = _childNodes[position];
+		BOOL visible = (snapshot ? _snapshotVisibility[position] : [child evaluateCondition]);
+		if (visible) {
+			[child enumerateVisibleRangesOfTotal:total forIndexes:&indexes[1] depth:depth - 1 snapshot:snapshot usingBlock:block];
+		}
+		return;
+	}
+	
+	// every hidden child ends the current run of visible indexes
+	NSUInteger runStart = 0;
+	NSUInteger hiddenCount = 0;
+	for (NSUInteger position = 0; position < _childCount && _childIndexes[position] < total; position++) {
+		BOOL visible = (snapshot ? _snapshotVisibility[position] : [_childNodes[position] evaluateCondition]);
+		if (visible) {
+			continue;
+		}
+		
+		NSUInteger start = _childIndexes[position];
+		if (start > runStart) {
+			block(NSMakeRange(runStart, start - runStart), runStart - hiddenCount, &stop);
+			if (stop) {
+				return;
+			}
+		}
+		NSUInteger end = MIN(start + _childLengths[position], total);
+		hiddenCount += end - start;
+		runStart = end;
+	}
+	if (total > runStart) {
+		block(NSMakeRange(runStart, total - runStart), runStart - hiddenCount, &stop);
+	}
+}
+
+
+
+#pragma mark - batch mapping
+
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes count:(NSUInteger)count stride:(NSUInteger)stride depth:(NSUInteger)depth snapshot:(BOOL)snapshot {
+	if (count == 0 || depth == 0) {
+		return;
+	}
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+	}
+	
+	// cursor into the children, only used if the snapshot is not used
+	NSUInteger position = 0;
+	NSUInteger hiddenCount = 0;
+	NSUInteger previousIndex = 0;
+	NSUInteger coveringPosition = NSNotFound;
+	BOOL coveringVisible = YES;
+	
+	NSUInteger item = 0;
+	while (item < count) {
+		NSUInteger staticIndex = indexes[item * stride];
+		
+		// all following items with the same index share the walk down the tree
+		NSUInteger groupEnd = item + 1;
+		while (groupEnd < count && indexes[groupEnd * stride] == staticIndex) {
+			groupEnd++;
+		}
+		
+		HRSIndexPathMapperNode *nextNode;
+		BOOL visible = YES;
+		NSUInteger dynamicIndex;
+		
+		if (snapshot) {
+			NSUInteger snapshotPosition = [self positionForCoveredIndex:staticIndex];
+			if (snapshotPosition < _childCount && _childIndexes[snapshotPosition] <= staticIndex) {
+				nextNode = _childNodes[snapshotPosition];
+				visible = _snapshotVisibility[snapshotPosition];
+			}
+			dynamicIndex = staticIndex - HRSIndexPathMapperNodeSnapshotHiddenCount(self, snapshotPosition);
+			
+		} else {
+			if (staticIndex < previousIndex) {
+				position = 0;
+				hiddenCount = 0;
+			}
+			previousIndex = staticIndex;
+			
+			while (position < _childCount && _childIndexes[position] + _childLengths[position] <= staticIndex) {
+				BOOL childVisible = (position == coveringPosition ? coveringVisible : [_childNodes[position] evaluateCondition]);
+				if (childVisible == NO) {
+					hiddenCount += _childLengths[position];
+				}
+				position++;
+			}
+			dynamicIndex = staticIndex - hiddenCount;
+			
+			// the covering child stays at the cursor as a range may cover the
+			// next items as well; its result is kept to not evaluate it again
+			if (position < _childCount && _childIndexes[position] <= staticIndex) {
+				nextNode = _childNodes[position];
+				if (position != coveringPosition) {
+					coveringPosition = position;
+					coveringVisible = [nextNode evaluateCondition];
+				}
+				visible = coveringVisible;
+			}
+		}
+		
+		for (NSUInteger groupItem = item; groupItem < groupEnd; groupItem++) {
+			NSUInteger *itemIndexes = &indexes[groupItem * stride];
+			if (visible) {
+				itemIndexes[0] = dynamicIndex;
+			} else {
+				for (NSUInteger level = 0; level < depth; level++) {
+					itemIndexes[level] = NSNotFound;
+				}
+			}
+		}
+		
+		if (visible && nextNode && nextNode.isLeaf == NO && depth > 1) {
+			[nextNode dynamicIndexesForStaticIndexes:&indexes[item * stride + 1] count:groupEnd - item stride:stride depth:depth - 1 snapshot:snapshot];
+		}
+		
+		item = groupEnd;
+	}
+}
+
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes count:(NSUInteger)count stride:(NSUInteger)stride depth:(NSUInteger)depth snapshot:(BOOL)snapshot {
+	if (count == 0 || depth == 0) {
+		return;
+	}
+	if (snapshot) {
+		[self buildSnapshotIfNeeded];
+	}
+	
+	// cursor into the children, only used if the snapshot is not used
+	NSUInteger position = 0;
+	NSUInteger hiddenCount = 0;
+	NSUInteger previousIndex = 0;
+	
+	NSUInteger item = 0;
+	while (item < count) {
+		NSUInteger dynamicIndex = indexes[item * stride];
+		
+		// all following items with the same index share the walk down the tree
+		NSUInteger groupEnd = item + 1;
+		while (groupEnd < count && indexes[groupEnd * stride] == dynamicIndex) {
+			groupEnd++;
+		}
+		
+		HRSIndexPathMapperNode *nextNode;
+		NSUInteger staticIndex;
+		
+		if (snapshot) {
+			NSUInteger snapshotPosition = [self snapshotPositionForDynamicIndex:dynamicIndex];
+			staticIndex = dynamicIndex + HRSIndexPathMapperNodeSnapshotHiddenCount(self, snapshotPosition);
+			if (snapshotPosition > 0 && _childIndexes[snapshotPosition - 1] == staticIndex) {
+				nextNode = _childNodes[snapshotPosition - 1];
+			}
+			
+		} else {
+			if (dynamicIndex < previousIndex) {
+				position = 0;
+				hiddenCount = 0;
+			}
+			previousIndex = dynamicIndex;
+			
+			staticIndex = dynamicIndex + hiddenCount;
+			while (position < _childCount && _childIndexes[position] <= staticIndex) {
+				HRSIndexPathMapperNode *child = _childNodes[position];
+				if ([child evaluateCondition] == NO) {
+					staticIndex += _childLengths[position];
+					hiddenCount += _childLengths[position];
+				} else if (_childIndexes[position] == staticIndex) {
+					nextNode = child;
+				}
+				position++;
+			}
+		}
+		
+		for (NSUInteger groupItem = item; groupItem < groupEnd; groupItem++) {
+			indexes[groupItem * stride] = staticIndex;
+		}
+		
+		if (nextNode && depth > 1) {
+			[nextNode staticIndexesForDynamicIndexes:&indexes[item * stride + 1] count:groupEnd - item stride:stride depth:depth - 1 snapshot:snapshot];
+		}
+		
+		item = groupEnd;
 	}
 }
 
@@ -178,27 +1432,23 @@
 	self = [super init];
 	if (self) {
 		_index = index;
-		_children = [NSArray array];
+		_length = 1;
+		_childNodes = [NSMutableArray array];
 		
 		if (condition != NULL) {
-			_predicate = [NSPredicate predicateWithBlock:^BOOL(id evaluatedObject, NSDictionary *bindings) {
-				return condition();
-			}];
+			_conditionBlock = [condition copy];
+			_conditionType = HRSIndexPathMapperNodeConditionTypeBlock;
 		}
 	}
 	return self;
 }
 
 - (void)setConditionForIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth condition:(BOOL(^)(void))condition {
-	NSPredicate *predicate;
 	if (condition == NULL) {
-		predicate = [NSPredicate predicateWithValue:YES];
+		[self setConditionForIndexes:indexes depth:depth predicate:[NSPredicate predicateWithValue:YES] evaluationObject:self];
 	} else {
-		predicate = [NSPredicate predicateWithBlock:^BOOL(id evaluatedObject, NSDictionary *bindings) {
-			return condition();
-		}];
+		[self setConditionForIndexes:indexes depth:depth block:condition];
 	}
-	[self setConditionForIndexes:indexes depth:depth predicate:predicate evaluationObject:self];
 }
 
 @end
@@ -0,0 +1,157 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ A `HRSIndexPathMapperState` captures the visibility of a single index at the
+ time the state was created, together with the states of its descendants.
+ 
+ States are created by a `HRSIndexPathMapperNode` and mirror its tree. The
+ descendants of an index that is not visible are not captured as they can not
+ participate in the mapping.
+ 
+ A state is immutable. Everything it needs for mapping is computed when it is
+ created, so it can be used from any thread.
+ */
+@interface HRSIndexPathMapperState : NSObject
+
+/**
+ The index the state represents.
+ */
+@property (nonatomic, assign, readonly) NSUInteger index;
+
+/**
+ The number of consecutive indexes the state represents, starting at `index`.
+ A state with a length greater than 1 represents a range and has no children.
+ */
+@property (nonatomic, assign, readonly) NSUInteger length;
+
+/**
+ Whether the index was visible at the time the state was captured.
+ */
+@property (nonatomic, assign, readonly, getter=isVisible) BOOL visible;
+
+/**
+ The states of the children, sorted by their index.
+ 
+ This array contains `HRSIndexPathMapperState` objects.
+ */
+@property (nonatomic, copy, readonly) NSArray /* HRSIndexPathMapperState */ *children;
+
+/**
+ Creates a new state for a single index.
+ 
+ @param index    The index the state represents.
+ @param visible  Whether the index is visible.
+ @param children The states of the children, sorted by their index.
+ 
+ @return An initialized state object
+ */
+- (instancetype)initWithIndex:(NSUInteger)index visible:(BOOL)visible children:(NSArray *)children;
+
+/**
+ Creates a new state for a range of indexes.
+ 
+ This is the designated initializer.
+ 
+ @param index    The first index the state represents.
+ @param length   The number of indexes the state represents.
+ @param visible  Whether the indexes are visible.
+ @param children The states of the children, sorted by their index. Must be
+                 empty if the length is greater than 1.
+ 
+ @return An initialized state object
+ */
+- (instancetype)initWithIndex:(NSUInteger)index length:(NSUInteger)length visible:(BOOL)visible children:(NSArray *)children NS_DESIGNATED_INITIALIZER;
+
+// unavailable:
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Calculates the changes that are necessary to get from the receiver to the
+ passed in state.
+ 
+ Both states are traversed once, side by side. Ranges are compared in segments
+ in which neither side changes its visibility. Indexes that are visible in the
+ receiver but not in the passed in state are reported as deleted, using their
+ dynamic index path in the receiver. Indexes that are only visible in the passed
+ in state are reported as inserted, using their dynamic index path in that
+ state. Descendants are only compared if their ancestor is visible in both
+ states.
+ 
+ The resulting lists have the same semantic as the arguments of a table view's
+ batch updates: deleted index paths are relative to the old state, inserted
+ index paths are relative to the new state.
+ 
+ @param state    The state after the changes.
+ @param deleted  A mutable array the deleted index paths are added to.
+ @param inserted A mutable array the inserted index paths are added to.
+ */
+- (void)addChangesToState:(HRSIndexPathMapperState *)state deletedIndexPaths:(NSMutableArray *)deleted insertedIndexPaths:(NSMutableArray *)inserted;
+
+/**
+ Maps the given static indexes in place to their dynamic counterparts, based on
+ the visibility captured by the receiver and its descendants.
+ 
+ @param indexes The indexes of a static index path, starting at the level of
+                the receiver's children.
+ @param depth   The number of indexes.
+ */
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth;
+
+/**
+ Maps the given dynamic indexes in place to their static counterparts, based on
+ the visibility captured by the receiver and its descendants.
+ 
+ @param indexes The indexes of a dynamic index path, starting at the level of
+                the receiver's children.
+ @param depth   The number of indexes.
+ */
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth;
+
+/**
+ Counts the visible indexes among the first `total` children indexes of the
+ state that is found by traversing through the given indexes, based on the
+ visibility captured by the receiver and its descendants.
+ 
+ @see -[HRSIndexPathMapperNode numberOfVisibleIndexesOfTotal:forIndexes:depth:snapshot:]
+ 
+ @param total   The number of indexes to count.
+ @param indexes The indexes of a static index path, starting at the level of
+                the receiver's children.
+ @param depth   The number of indexes, may be 0.
+ 
+ @return The number of visible indexes.
+ */
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth;
+
+/**
+ Enumerates the runs of visible indexes among the first `total` children indexes
+ of the state that is found by traversing through the given indexes, based on
+ the visibility captured by the receiver and its descendants.
+ 
+ @see -[HRSIndexPathMapperNode enumerateVisibleRangesOfTotal:forIndexes:depth:snapshot:usingBlock:]
+ 
+ @param total   The number of indexes to enumerate.
+ @param indexes The indexes of a static index path, starting at the level of
+                the receiver's children.
+ @param depth   The number of indexes, may be 0.
+ @param block   The block that is called for every run. Set `stop` to `YES` to
+                stop the enumeration.
+ */
+- (void)enumerateVisibleRangesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth usingBlock:(void(^)(NSRange range, NSUInteger dynamicIndex, BOOL *stop))block;
+
+@end
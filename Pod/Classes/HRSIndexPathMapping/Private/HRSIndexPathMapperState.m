@@ -0,0 +1,302 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+
+#import "HRSIndexPathMapperState.h"
+
+
+@interface HRSIndexPathMapperState () {
+	// The indexes and lengths of the children and the number of hidden indexes
+	// in front of each position; the hidden counts have one additional element.
+	NSUInteger _childCount;
+	NSUInteger *_childIndexes;
+	NSUInteger *_childLengths;
+	NSUInteger *_hiddenCounts;
+}
+
+@end
+
+
+@implementation HRSIndexPathMapperState
+
+- (instancetype)initWithIndex:(NSUInteger)index visible:(BOOL)visible children:(NSArray *)children {
+	return [self initWithIndex:index length:1 visible:visible children:children];
+}
+
+- (instancetype)initWithIndex:(NSUInteger)index length:(NSUInteger)length visible:(BOOL)visible children:(NSArray *)children {
+	self = [super init];
+	if (self) {
+		_index = index;
+		_length = length;
+		_visible = visible;
+		_children = [children copy] ?: [NSArray array];
+		
+		_childCount = _children.count;
+		_childIndexes = malloc(MAX(_childCount, 1u) * sizeof(NSUInteger));
+		_childLengths = malloc(MAX(_childCount, 1u) * sizeof(NSUInteger));
+		_hiddenCounts = malloc((_childCount + 1) * sizeof(NSUInteger));
+		_hiddenCounts[0] = 0;
+		for (NSUInteger position = 0; position < _childCount; position++) {
+			HRSIndexPathMapperState *child = _children[position];
+			_childIndexes[position] = child.index;
+			_childLengths[position] = child.length;
+			_hiddenCounts[position + 1] = _hiddenCounts[position] + (child.isVisible ? 0 : child.length);
+		}
+	}
+	return self;
+}
+
+- (void)dealloc {
+	free(_childIndexes);
+	free(_childLengths);
+	free(_hiddenCounts);
+}
+
+
+
+#pragma mark - mapping
+
+/// Returns the position of the first child whose index is greater than or equal to the given index.
+- (NSUInteger)positionForIndex:(NSUInteger)index {
+	NSUInteger lower = 0;
+	NSUInteger upper = _childCount;
+	while (lower < upper) {
+		NSUInteger middle = lower + (upper - lower) / 2;
+		if (_childIndexes[middle] < index) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+/// Returns the position of the child that covers the given index or, if there is none, the position of the first child behind it.
+- (NSUInteger)positionForCoveredIndex:(NSUInteger)index {
+	NSUInteger position = [self positionForIndex:index];
+	if (position > 0 && _childIndexes[position - 1] + _childLengths[position - 1] > index) {
+		return position - 1;
+	}
+	return position;
+}
+
+/// Returns the number of children that are mapped to a dynamic index less than or equal to the given one.
+- (NSUInteger)positionForDynamicIndex:(NSUInteger)dynamicIndex {
+	NSUInteger lower = 0;
+	NSUInteger upper = _childCount;
+	while (lower < upper) {
+		NSUInteger middle = lower + (upper - lower) / 2;
+		if (_childIndexes[middle] - _hiddenCounts[middle] <= dynamicIndex) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+- (void)dynamicIndexesForStaticIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	if (depth == 0) {
+		return;
+	}
+	
+	NSUInteger staticIndex = indexes[0];
+	NSUInteger position = [self positionForCoveredIndex:staticIndex];
+	HRSIndexPathMapperState *child;
+	if (position < _childCount && _childIndexes[position] <= staticIndex) {
+		child = _children[position];
+		if (child.isVisible == NO) {
+			for (NSUInteger level = 0; level < depth; level++) {
+				indexes[level] = NSNotFound;
+			}
+			return;
+		}
+	}
+	
+	indexes[0] = staticIndex - _hiddenCounts[position];
+	[child dynamicIndexesForStaticIndexes:&indexes[1] depth:depth - 1];
+}
+
+- (void)staticIndexesForDynamicIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	if (depth == 0) {
+		return;
+	}
+	
+	NSUInteger position = [self positionForDynamicIndex:indexes[0]];
+	NSUInteger staticIndex = indexes[0] + _hiddenCounts[position];
+	indexes[0] = staticIndex;
+	
+	if (position > 0 && _childIndexes[position - 1] == staticIndex) {
+		HRSIndexPathMapperState *child = _children[position - 1];
+		[child staticIndexesForDynamicIndexes:&indexes[1] depth:depth - 1];
+	}
+}
+
+
+
+#pragma mark - counting
+
+- (NSUInteger)numberOfVisibleIndexesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth {
+	if (depth > 0) {
+		NSUInteger position = [self positionForCoveredIndex:indexes[0]];
+		if (position == _childCount || _childIndexes[position] > indexes[0]) {
+			return total;
+		}
+		
+		HRSIndexPathMapperState *child = _children[position];
+		if (child.isVisible == NO) {
+			return 0;
+		}
+		return [child numberOfVisibleIndexesOfTotal:total forIndexes:&indexes[1] depth:depth - 1];
+	}
+	
+	NSUInteger position = [self positionForIndex:total];
+	NSUInteger hiddenCount = _hiddenCounts[position];
+	
+	// a hidden range in front of the total may reach beyond it
+	if (position > 0 && [_children[position - 1] isVisible] == NO) {
+		NSUInteger end = _childIndexes[position - 1] + _childLengths[position - 1];
+		if (end > total) {
+			hiddenCount -= end - total;
+		}
+	}
+	return total - hiddenCount;
+}
+
+- (void)enumerateVisibleRangesOfTotal:(NSUInteger)total forIndexes:(NSUInteger *)indexes depth:(NSUInteger)depth usingBlock:(void(^)(NSRange range, NSUInteger dynamicIndex, BOOL *stop))block {
+	BOOL stop = NO;
+	if (depth > 0) {
+		NSUInteger position = [self positionForCoveredIndex:indexes[0]];
+		if (position == _childCount || _childIndexes[position] > indexes[0]) {
+			if (total > 0) {
+				block(NSMakeRange(0, total), 0, &stop);
+			}
+			return;
+		}
+		
+		HRSIndexPathMapperState *child = _children[position];
+		if (child.isVisible) {
+			[child enumerateVisibleRangesOfTotal:total forIndexes:&indexes[1] depth:depth - 1 usingBlock:block];
+		}
+		return;
+	}
+	
+	// every hidden child ends the current run of visible indexes
+	NSUInteger runStart = 0;
+	NSUInteger hiddenCount = 0;
+	for (NSUInteger position = 0; position < _childCount && _childIndexes[position] < total; position++) {
+		if ([_children[position] isVisible]) {
+			continue;
+		}
+		
+		NSUInteger start = _childIndexes[position];
+		if (start > runStart) {
+			block(NSMakeRange(runStart, start - runStart), runStart - hiddenCount, &stop);
+			if (stop) {
+				return;
+			}
+		}
+		NSUInteger end = MIN(start + _childLengths[position], total);
+		hiddenCount += end - start;
+		runStart = end;
+	}
+	if (total > runStart) {
+		block(NSMakeRange(runStart, total - runStart), runStart - hiddenCount, &stop);
+	}
+}
+
+
+
+#pragma mark - diff
+
+- (void)addChangesToState:(HRSIndexPathMapperState *)state deletedIndexPaths:(NSMutableArray *)deleted insertedIndexPaths:(NSMutableArray *)inserted {
+	[self addChangesToState:state oldIndexPath:[NSIndexPath new] newIndexPath:[NSIndexPath new] deletedIndexPaths:deleted insertedIndexPaths:inserted];
+}
+
+- (void)addChangesToState:(HRSIndexPathMapperState *)state oldIndexPath:(NSIndexPath *)oldIndexPath newIndexPath:(NSIndexPath *)newIndexPath deletedIndexPaths:(NSMutableArray *)deleted insertedIndexPaths:(NSMutableArray *)inserted {
+	NSArray *oldChildren = self.children;
+	NSArray *newChildren = state.children;
+	NSUInteger oldCount = oldChildren.count;
+	NSUInteger newCount = newChildren.count;
+	
+	NSUInteger oldPosition = 0;
+	NSUInteger newPosition = 0;
+	NSUInteger oldHidden = 0;
+	NSUInteger newHidden = 0;
+	NSUInteger index = 0;
+	
+	// merge both lists by their indexes in segments that neither side changes
+	// its visibility in; an index without a state is visible and has no
+	// descendants that are relevant for the mapping
+	while (oldPosition < oldCount || newPosition < newCount) {
+		HRSIndexPathMapperState *oldChild = (oldPosition < oldCount ? oldChildren[oldPosition] : nil);
+		HRSIndexPathMapperState *newChild = (newPosition < newCount ? newChildren[newPosition] : nil);
+		
+		// skip the indexes in front of both children
+		index = MAX(index, MIN((oldChild ? oldChild.index : NSUIntegerMax), (newChild ? newChild.index : NSUIntegerMax)));
+		
+		BOOL oldCovers = (oldChild && oldChild.index <= index);
+		BOOL newCovers = (newChild && newChild.index <= index);
+		
+		NSUInteger end = NSUIntegerMax;
+		if (oldChild) {
+			end = MIN(end, (oldCovers ? oldChild.index + oldChild.length : oldChild.index));
+		}
+		if (newChild) {
+			end = MIN(end, (newCovers ? newChild.index + newChild.length : newChild.index));
+		}
+		NSUInteger length = end - index;
+		
+		BOOL oldVisible = (oldCovers ? oldChild.isVisible : YES);
+		BOOL newVisible = (newCovers ? newChild.isVisible : YES);
+		
+		if (oldVisible && newVisible) {
+			// only a single index can have children
+			if ((oldCovers && oldChild.children.count > 0) || (newCovers && newChild.children.count > 0)) {
+				HRSIndexPathMapperState *oldState = (oldCovers ? oldChild : [[HRSIndexPathMapperState alloc] initWithIndex:index visible:YES children:nil]);
+				HRSIndexPathMapperState *newState = (newCovers ? newChild : [[HRSIndexPathMapperState alloc] initWithIndex:index visible:YES children:nil]);
+				[oldState addChangesToState:newState
+							   oldIndexPath:[oldIndexPath indexPathByAddingIndex:index - oldHidden]
+							   newIndexPath:[newIndexPath indexPathByAddingIndex:index - newHidden]
+						  deletedIndexPaths:deleted
+						 insertedIndexPaths:inserted];
+			}
+		} else if (oldVisible) {
+			for (NSUInteger offset = 0; offset < length; offset++) {
+				[deleted addObject:[oldIndexPath indexPathByAddingIndex:index - oldHidden + offset]];
+			}
+		} else if (newVisible) {
+			for (NSUInteger offset = 0; offset < length; offset++) {
+				[inserted addObject:[newIndexPath indexPathByAddingIndex:index - newHidden + offset]];
+			}
+		}
+		
+		if (oldVisible == NO) {
+			oldHidden += length;
+		}
+		if (newVisible == NO) {
+			newHidden += length;
+		}
+		
+		index = end;
+		if (oldCovers && oldChild.index + oldChild.length <= index) {
+			oldPosition++;
+		}
+		if (newCovers && newChild.index + newChild.length <= index) {
+			newPosition++;
+		}
+	}
+}
+
+@end
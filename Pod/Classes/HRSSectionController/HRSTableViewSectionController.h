@@ -28,6 +28,11 @@
  treat its table view as if it is the only section that is visible in the table
  view.
  
+ A section controller can also be responsible for several consecutive sections
+ by implementing `numberOfSectionsInTableView:`. Its sections are then numbered
+ from 0 to the number of sections minus 1, and `numberOfSections` of its table
+ view returns its own number of sections.
+ 
  If a section controller has to communicate with the table view on its own, it
  can ask its coordinator for `tableViewForSectionController:` to get a table
  view container it can deal with. The controller should make no attempts to get
@@ -113,4 +118,24 @@
  */
 @property (nonatomic, strong, readwrite) NSString *sectionFooterTitle;
 
+/**
+ Drops all cached row heights of this section controller.
+ 
+ Call this if the heights of the rows change without a reload of the section,
+ e.g. because the content of the rows changed. This does nothing if the row
+ height cache of the coordinator is not enabled.
+ 
+ @see -[HRSTableViewSectionCoordinator rowHeightCacheEnabled]
+ */
+- (void)invalidateRowHeights;
+
+/**
+ Drops the cached row height of a single row of this section controller.
+ 
+ @param indexPath the index path of the row in the space of this controller
+ 
+ @see -[HRSTableViewSectionCoordinator rowHeightCacheEnabled]
+ */
+- (void)invalidateRowHeightAtIndexPath:(NSIndexPath *)indexPath;
+
 @end
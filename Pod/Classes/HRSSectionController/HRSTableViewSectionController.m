@@ -66,6 +66,18 @@
 
 
 
+#pragma mark - row height cache
+
+- (void)invalidateRowHeights {
+	[self.coordinator invalidateRowHeightsForSectionController:self];
+}
+
+- (void)invalidateRowHeightAtIndexPath:(NSIndexPath *)indexPath {
+	[self.coordinator invalidateRowHeightAtIndexPath:indexPath forSectionController:self];
+}
+
+
+
 #pragma mark - UITraitEnvironment
 
 - (void)_updateTraitCollectionIfNecessary {
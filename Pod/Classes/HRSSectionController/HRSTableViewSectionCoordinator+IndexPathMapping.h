@@ -35,11 +35,11 @@
 /**
  Maps a section from the table view space to the given controller's section.
  
- @note When calling this with the a controller and the section it is controlling
-       it will always return 0, however this is in preparation of the fact that
-       one day a section controller should be able to handle more than one
-       section. You can also use this method to calculate offsets between two
-       different section controllers.
+ @note When calling this with a controller and one of the sections it is
+       controlling it returns the index of this section within the controller,
+       which is 0 for controllers that only handle a single section. You can
+       also use this method to calculate offsets between two different section
+       controllers.
  
  @param tableViewSection The section you want to map in the table view's space.
  @param controller       The controller the returned section should be in
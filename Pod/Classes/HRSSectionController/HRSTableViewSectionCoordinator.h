@@ -15,9 +15,39 @@
 #import <UIKit/UIKit.h>
 
 
+@class HRSTableViewSectionCoordinator;
+
 @protocol HRSTableViewSectionController;
 
 
+/**
+ An object that is informed about every call a section coordinator forwards to
+ one of its section controllers.
+ 
+ Use this to find out which section controller is slow, e.g. while profiling a
+ table view that does not scroll smoothly. Counting the calls per selector and
+ section controller gives the number of calls, summing up their durations gives
+ the time spent in each section controller.
+ 
+ @see HRSTableViewSectionCoordinator.instrumentation
+ */
+@protocol HRSTableViewSectionCoordinatorInstrumentation <NSObject>
+
+/**
+ Called after a section controller returned from a table view delegate or data
+ source method the coordinator forwarded to it.
+ 
+ @param coordinator       The coordinator that forwarded the call.
+ @param selector          The selector that was called.
+ @param sectionController The section controller that was called.
+ @param duration          The time the section controller took, including the
+                          mapping of the arguments, in seconds.
+ */
+- (void)sectionCoordinator:(HRSTableViewSectionCoordinator *)coordinator didCallSelector:(SEL)selector onSectionController:(id<HRSTableViewSectionController>)sectionController duration:(NSTimeInterval)duration;
+
+@end
+
+
 /**
  A section coordinator is responsible for agregating and managing the data flow
  between a section controller and the table view the coordinator is linked to.
@@ -32,6 +62,17 @@
  Each section controller in a coordinator is responsible for a single section
  that should be treated as section 0, from the controllers point of view.
  
+ A section controller that implements `numberOfSectionsInTableView:` is
+ responsible for as many consecutive sections as it returns there instead,
+ numbered from 0 from the controller's point of view. This way a grouped list
+ can be managed by a single controller instead of one controller per group.
+ The coordinator keeps the first section of every controller as a running
+ total, so the controller of a table view section is found by binary search.
+ The number of sections is read when the section controllers or the table view
+ are set, and whenever a controller inserts or deletes sections through its
+ table view. Call `invalidateNumberOfSectionsForSectionController:` if it
+ changes for any other reason, e.g. before reloading the table view.
+ 
  The mapping is done internally by the coordinator. If the coordinator hands you
  a table view, you will never get the underlying table view instance, instead
  you get an object you can treat as a table view that only contains the section
@@ -62,7 +103,7 @@
           the section coordinator will no longer be the delegate and data source
           of the table view itself.
  */
-@interface HRSTableViewSectionCoordinator : UIResponder <UITableViewDelegate, UITableViewDataSource, UITraitEnvironment>
+@interface HRSTableViewSectionCoordinator : UIResponder <UITableViewDelegate, UITableViewDataSource, UITableViewDataSourcePrefetching, UITraitEnvironment>
 
 /**
  The transformer class to be used by the coordinator. This class must be of kind
@@ -83,7 +124,9 @@
  The list of section controllers that are managed by the coordinator.
  
  The setter implementation simply calls `setSectionController:animated:` with
- this array and with the animated parameter set to NO.
+ this array and with the animated parameter set to NO. While an animated change
+ is scheduled, the getter returns the scheduled list instead of the list that
+ is shown by the table view.
  */
 @property (nonatomic, copy, readwrite) NSArray /* id<HRSTableViewSectionController> */ *sectionController;
 
@@ -110,6 +153,18 @@
  exception. To be able to enable this feature in the future, an NSArray
  is used.
  
+ When animated, the old and the new list are compared by identity in linear
+ time. Sections of removed controllers are deleted, sections of new controllers
+ are inserted and sections of reordered controllers are moved, so that they
+ keep their cells. Sections of controllers that were flagged with
+ `setSectionControllerNeedsReload:` are reloaded.
+ 
+ An animated change while the table view still animates the previous one is
+ scheduled instead of being applied. When the running animation finished, the
+ latest scheduled list is animated in a single transition from the sections on
+ screen, all lists that were set in between are skipped. A change that is not
+ animated drops the scheduled list and is applied immediately.
+ 
  @param sectionController an array of objects that conform to the
                           HRSTableViewSectionController protocol
  @param animated          YES if the change in sections should be animated on
@@ -118,6 +173,20 @@
  */
 - (void)setSectionController:(NSArray /* id<HRSTableViewSectionController> */ *)sectionController animated:(BOOL)animated;
 
+/**
+ Flags a section controller as changed.
+ 
+ The next call of `setSectionController:animated:` reloads the section of the
+ flagged controller if it is still part of the new list of section controllers.
+ If the controller is moved at the same time, its section is deleted and
+ inserted instead. Every call of `setSectionController:animated:` clears all
+ flags, unless the call is scheduled after a running animation. In this case the
+ flags are used and cleared by the scheduled transition.
+ 
+ @param controller the section controller whose section should be reloaded
+ */
+- (void)setSectionControllerNeedsReload:(id<HRSTableViewSectionController>)controller;
+
 /**
  Link the coordinator to a table view.
  
@@ -132,7 +201,11 @@
  table view everytime `viewDidLoad` is called.
  
  @note This method automatically claims the dataSource and the delegate of the
-       table view.
+       table view. If the table view supports prefetching and at least one
+       section controller implements `UITableViewDataSourcePrefetching`, it also
+       claims the prefetchDataSource. Prefetched index paths are split by
+       section controller, so that every section controller receives a single
+       call with the index paths in its own space.
  
  @param tableView The table view that should be linked with the coordinator
  */
@@ -153,6 +226,9 @@
  if your section controller is the only one that is interacting with the table
  view.
  
+ The proxy is created once per section controller and reused until the
+ section controllers or the table view of the coordinator change.
+ 
  @note Do not make decisions based on pointer equality. This is not the same
        object as the table view.
  
@@ -178,6 +254,191 @@
  */
 - (id<HRSTableViewSectionController>)sectionControllerForTableSection:(NSInteger)section;
 
+/**
+ Asks the given section controller for its number of sections again and moves
+ the sections of all following section controllers accordingly.
+ 
+ This does not update the table view. Call it right before you reload the table
+ view or animate the change of the sections, just like you would update the
+ model of a table view.
+ 
+ @note Inserting or deleting sections through the table view of a section
+       controller calls this method automatically.
+ 
+ @param controller the section controller whose number of sections changed
+ */
+- (void)invalidateNumberOfSectionsForSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Whether the coordinator caches the row heights of its section controllers.
+ 
+ When enabled, `tableView:heightForRowAtIndexPath:` is only forwarded to a
+ section controller if there is no cached height for the row yet. The cache is
+ keyed by the section controller and the index path in the controller's space.
+ Cached heights are also returned by `tableView:estimatedHeightForRowAtIndexPath:`.
+ 
+ Cached heights of a section controller are dropped automatically when it
+ reloads, inserts, deletes or moves rows or sections through its table view
+ proxy, when it is removed or reloaded by `setSectionController:animated:` and
+ when the table view is reloaded. Call `invalidateRowHeights` or
+ `invalidateRowHeightAtIndexPath:` on the section controller if a height
+ changes for any other reason, e.g. a changed table view width.
+ 
+ The default is NO. Changing this property drops all cached heights.
+ */
+@property (nonatomic, assign, readwrite, getter=isRowHeightCacheEnabled) BOOL rowHeightCacheEnabled;
+
+/**
+ Drops all cached row heights of the given section controller.
+ 
+ @param controller the section controller whose heights should be dropped
+ 
+ @see rowHeightCacheEnabled
+ */
+- (void)invalidateRowHeightsForSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Drops the cached height of a single row of the given section controller.
+ 
+ @param indexPath  the index path of the row in the space of the controller
+ @param controller the section controller the row belongs to
+ 
+ @see rowHeightCacheEnabled
+ */
+- (void)invalidateRowHeightAtIndexPath:(NSIndexPath *)indexPath forSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Whether the coordinator collects the table view updates of its section
+ controllers and applies them in a single batch.
+ 
+ When enabled, inserting, deleting, reloading and moving rows or sections
+ through the table view of a section controller does not update the table view
+ immediately. The updates of all section controllers are collected instead and
+ applied between a single `beginUpdates` and `endUpdates` at the end of the
+ current run loop turn, before the table view lays out its rows. This way
+ several section controllers that update their content at the same time only
+ cause a single layout pass of the table view.
+ 
+ The updates of a section controller are rebased while they are collected, so
+ that the controller can send them one after another just like to a table view
+ without coalescing. Updates that cannot be rebased, e.g. deleting a row that
+ was inserted in the same run loop turn, reload all sections of the controller
+ instead. Updates between `beginUpdates` and `endUpdates` of a section
+ controller's table view are collected like a batch of a table view, so they
+ are based on the rows before the block. Calling `reloadData` drops all
+ pending updates.
+ 
+ Any other call to the table view of a section controller, e.g.
+ `cellForRowAtIndexPath:`, as well as `setSectionController:animated:` apply
+ the pending updates first, so that they see a consistent table view. Calls
+ that dequeue cells and calls a section controller makes while it handles a
+ call of the table view, e.g. `tableView:cellForRowAtIndexPath:`, do not, as
+ the table view must not be updated while it asks for its content.
+ 
+ Until the pending updates are applied, the coordinator answers the table view
+ and maps sections with the sections the table view has, even if a section
+ controller already inserted or deleted some of its sections.
+ 
+ The default is NO. Disabling it applies the pending updates.
+ */
+@property (nonatomic, assign, readwrite, getter=isUpdateCoalescingEnabled) BOOL updateCoalescingEnabled;
+
+/**
+ Applies the table view updates that were collected in the current run loop
+ turn right away.
+ 
+ Does nothing if there are no pending updates.
+ 
+ @see updateCoalescingEnabled
+ */
+- (void)applyPendingTableViewUpdates;
+
+/**
+ Sets a block condition that decides if the sections of the given section
+ controller are shown while overwriting a possible previous condition.
+ 
+ A hidden section controller stays part of `sectionController` and keeps its
+ coordinator and table view, but none of its sections are part of the table
+ view. It is skipped by `numberOfSectionsInTableView:` and by the methods of
+ the `IndexPathMapping` category, and the updates it sends to its table view
+ are dropped.
+ 
+ The conditions are kept in an `HRSIndexPathMapper` that maps the index of a
+ section controller to its visibility. Conditions are evaluated once and
+ reused until `invalidateVisibilityOfSectionController:` is called or the
+ controller moves to another index of `sectionController`. If the
+ controller is part of `sectionController`, the condition is evaluated right
+ away and the sections of the controller are inserted or deleted if its
+ visibility changes. Otherwise the condition is evaluated when the controller
+ is added. The condition is removed when the controller is removed from
+ `sectionController`.
+ 
+ @note If the condition is NULL, the condition of the controller is removed
+       and the controller is shown.
+ 
+ @param controller the section controller the condition belongs to
+ @param condition  a block that returns YES if the controller should be shown
+ */
+- (void)setVisibilityConditionForSectionController:(id<HRSTableViewSectionController>)controller condition:(BOOL(^)(void))condition;
+
+/**
+ Sets a predicate condition that decides if the sections of the given section
+ controller are shown while overwriting a possible previous condition.
+ 
+ The evaluation object is not retained, it must outlive the condition.
+ 
+ @see setVisibilityConditionForSectionController:condition:
+ @see -[HRSIndexPathMapper setConditionForIndexPath:predicate:evaluationObject:]
+ 
+ @param controller the section controller the condition belongs to
+ @param predicate  the predicate that describes the condition
+ @param object     the object the predicate should be evaluated on
+ */
+- (void)setVisibilityConditionForSectionController:(id<HRSTableViewSectionController>)controller predicate:(NSPredicate *)predicate evaluationObject:(id)object;
+
+/**
+ Evaluates the visibility condition of the given section controller again.
+ 
+ If the visibility of the controller changed, its sections are inserted into or
+ deleted from the table view with a single `insertSections:withRowAnimation:` or
+ `deleteSections:withRowAnimation:` call, using `rowAnimation`. All other
+ section controllers keep their sections. While an animated transition of
+ `setSectionController:animated:` is running, the sections are inserted or
+ deleted once it finished, or by the transition that was scheduled during it.
+ 
+ @param controller the section controller whose condition changed
+ */
+- (void)invalidateVisibilityOfSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Returns whether the sections of the given section controller are shown.
+ 
+ @param controller the section controller in question
+ 
+ @return YES if the controller is part of `sectionController` and not hidden
+         by its visibility condition
+ */
+- (BOOL)isSectionControllerVisible:(id<HRSTableViewSectionController>)controller;
+
+/**
+ An object that is informed about every call the coordinator forwards to one of
+ its section controllers.
+ 
+ While an instrumentation is set, the coordinator also emits signpost intervals
+ around `tableView:cellForRowAtIndexPath:` and
+ `tableView:heightForRowAtIndexPath:` on iOS 12 and later, so that they show up
+ as points of interest in Instruments.
+ 
+ The default value is `nil`. Without an instrumentation, forwarding a call only
+ costs an additional check, so this can stay in production code.
+ 
+ @note Scroll view delegate methods are not reported. The coordinator sends them
+       directly to the first section controller that implements them, without
+       a proxy. `scrollViewDidScroll:` is only sent to the first section
+       controller.
+ */
+@property (nonatomic, weak, readwrite) id<HRSTableViewSectionCoordinatorInstrumentation> instrumentation;
+
 /**
  Updates the trait collection with the given trait collection and passes the new
  trait collection on to the coordinator's section controllers.
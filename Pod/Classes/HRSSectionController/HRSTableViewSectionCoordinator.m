@@ -16,12 +16,18 @@
 #import "HRSTableViewSectionCoordinator+IndexPathMapping.h"
 #import "HRSTableViewSectionCoordinator+TransformerSupport.h"
 
+#import <mach/mach_time.h>
 #import <objc/runtime.h>
+#import <os/signpost.h>
 
 #import "HRSTableViewSectionController.h"
 #import "HRSTableViewSectionTransformer.h"
+#import "HRSIndexPathMapper+TableView.h"
 
 #import "_HRSTableViewSectionCoordinatorProxy.h"
+#import "_HRSTableViewSectionCoordinatorResponders.h"
+#import "_HRSTableViewSectionCoordinatorSections.h"
+#import "_HRSTableViewSectionCoordinatorUpdates.h"
 
 
 @interface HRSTableViewSectionController (Private)
@@ -31,12 +37,36 @@
 @end
 
 
-@interface HRSTableViewSectionCoordinator ()
+@interface HRSTableViewSectionCoordinator () {
+	BOOL _instrumented; /// whether an instrumentation was set, checked on the hot paths instead of loading the weak reference
+	CFRunLoopObserverRef _updateObserver; /// applies the pending updates at the end of the current run loop turn
+	NSUInteger _tableViewCallbackDepth; /// the nesting of table view callbacks that are forwarded to section controllers right now
+	NSUInteger _transition; /// counts the calls of `setSectionController:animated:`, so that callbacks of replaced transitions do nothing
+	BOOL _transitioning; /// whether the table view animates a transition that has not finished yet
+	BOOL _transitionScheduled; /// whether `scheduledSectionController` is set after the running transition
+}
 
 @property (nonatomic, weak, readwrite) UITableView *tableView;
 @property (nonatomic, strong, readwrite) HRSTableViewSectionTransformer *transformer;
 
 @property (nonatomic, strong, readwrite) NSArray *oldSectionController; /// This is the list of old section controllers during a transition.
+@property (nonatomic, strong, readwrite) NSArray *scheduledSectionController; /// the latest list of section controllers that was set during a transition
+
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorSections *sections; /// which table view sections belong to which controller of `sectionController`
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorSections *oldSections; /// which table view sections belong to which controller of `oldSectionController`
+@property (nonatomic, strong, readwrite) NSMapTable *proxies; /// controller -> proxy that maps from the controller to the table view
+@property (nonatomic, strong, readwrite) NSMapTable *transitionProxies; /// controller -> proxy that maps from the table view to the controller using the old section controllers
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorResponders *responders; /// which controllers of `sectionController` implement which protocol methods
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorResponders *oldResponders; /// which controllers of `oldSectionController` implement which protocol methods
+@property (nonatomic, strong, readwrite) NSHashTable *changedSectionController; /// controllers whose sections are reloaded by the next animated transition
+@property (nonatomic, strong, readwrite) NSMapTable *rowHeights; /// controller -> (controller index path -> height)
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorUpdates *pendingUpdates; /// table view updates collected in the current run loop turn
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorSections *pendingSections; /// the sections after `pendingUpdates`, which replace `sections` when the updates are applied
+@property (nonatomic, strong, readwrite) NSMapTable *visibilityConditions; /// controller -> block or predicate that decides if the controller is shown
+@property (nonatomic, strong, readwrite) NSMapTable *visibilityEvaluationObjects; /// controller -> evaluation object of its predicate condition
+@property (nonatomic, strong, readwrite) HRSIndexPathMapper *visibilityMapper; /// maps the index of a controller of `sectionController` to its visibility, nil without conditions
+@property (nonatomic, strong, readwrite) NSHashTable *hiddenSectionController; /// controllers of `sectionController` that are hidden by their condition
+@property (nonatomic, strong, readwrite) NSHashTable *deferredVisibilitySectionController; /// controllers whose visibility changed during the running transition
 
 @property (nonatomic, strong, readwrite) UITraitCollection *traitCollection;
 
@@ -45,9 +75,122 @@
 
 static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 
+/// Core Animation commits its transaction with the order 2000000, the pending
+/// updates need to be applied before the table view lays out its rows.
+static CFIndex const HRSTableViewSectionCoordinatorUpdateObserverOrder = 1999000;
+
+
+/**
+ Marks one longest strictly increasing subsequence of the given sections.
+ 
+ This is the patience sorting algorithm, it runs in O(n log n) and uses O(n)
+ additional memory. Sections that extend the longest subsequence found so far
+ skip the binary search, so sections that are already in order take O(n).
+ 
+ @param sections the list of sections
+ @param count    the number of sections in the list
+ @param marks    a list of `count` flags that are set to YES for every section
+                 that is part of the subsequence
+ */
+static void HRSTableViewSectionCoordinatorMarkIncreasingSections(const NSUInteger *sections, NSUInteger count, BOOL *marks) {
+	if (count == 0) {
+		return;
+	}
+	
+	// tails[length - 1] is the position of the smallest last element of all
+	// increasing subsequences of the given length found so far
+	NSUInteger *tails = malloc(count * sizeof(NSUInteger));
+	NSUInteger *predecessors = malloc(count * sizeof(NSUInteger));
+	NSUInteger length = 0;
+	for (NSUInteger position = 0; position < count; position++) {
+		NSUInteger low = 0;
+		NSUInteger high = length;
+		if (length > 0 && sections[tails[length - 1]] < sections[position]) {
+			low = length;
+		}
+		while (low < high) {
+			NSUInteger middle = low + (high - low) / 2;
+			if (sections[tails[middle]] < sections[position]) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		predecessors[position] = (low > 0 ? tails[low - 1] : NSNotFound);
+		tails[low] = position;
+		if (low == length) {
+			length++;
+		}
+	}
+	
+	for (NSUInteger position = tails[length - 1]; position != NSNotFound; position = predecessors[position]) {
+		marks[position] = YES;
+	}
+	
+	free(predecessors);
+	free(tails);
+}
+
+/// the intervals the coordinator emits while it is instrumented
+typedef NS_ENUM(NSUInteger, HRSTableViewSectionCoordinatorSignpost) {
+	HRSTableViewSectionCoordinatorSignpostCellForRow,
+	HRSTableViewSectionCoordinatorSignpostHeightForRow
+};
+
+static os_log_t HRSTableViewSectionCoordinatorSignpostLog(void) API_AVAILABLE(ios(12.0)) {
+	static os_log_t log;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		log = os_log_create("HRSAdvancedTableViews", "PointsOfInterest");
+	});
+	return log;
+}
+
+/**
+ Begins a signpost interval that shows up in Instruments, if signposts are
+ available.
+ 
+ @param signpost  the kind of interval to begin
+ @param indexPath the table view index path the interval belongs to
+ 
+ @return the identifier to end the interval with
+ */
+static os_signpost_id_t HRSTableViewSectionCoordinatorBeginSignpost(HRSTableViewSectionCoordinatorSignpost signpost, NSIndexPath *indexPath) {
+	if (@available(iOS 12.0, *)) {
+		os_log_t log = HRSTableViewSectionCoordinatorSignpostLog();
+		os_signpost_id_t identifier = os_signpost_id_generate(log);
+		switch (signpost) {
+			case HRSTableViewSectionCoordinatorSignpostCellForRow:
+				os_signpost_interval_begin(log, identifier, "cellForRowAtIndexPath", "section %ld row %ld", (long)indexPath.section, (long)indexPath.row);
+				break;
+			case HRSTableViewSectionCoordinatorSignpostHeightForRow:
+				os_signpost_interval_begin(log, identifier, "heightForRowAtIndexPath", "section %ld row %ld", (long)indexPath.section, (long)indexPath.row);
+				break;
+		}
+		return identifier;
+	}
+	return OS_SIGNPOST_ID_NULL;
+}
+
+static void HRSTableViewSectionCoordinatorEndSignpost(HRSTableViewSectionCoordinatorSignpost signpost, os_signpost_id_t identifier) {
+	if (@available(iOS 12.0, *)) {
+		os_log_t log = HRSTableViewSectionCoordinatorSignpostLog();
+		switch (signpost) {
+			case HRSTableViewSectionCoordinatorSignpostCellForRow:
+				os_signpost_interval_end(log, identifier, "cellForRowAtIndexPath");
+				break;
+			case HRSTableViewSectionCoordinatorSignpostHeightForRow:
+				os_signpost_interval_end(log, identifier, "heightForRowAtIndexPath");
+				break;
+		}
+	}
+}
+
 
 @implementation HRSTableViewSectionCoordinator
 
+@synthesize sectionController = _sectionController;
+
 + (Class)transformerClass {
     return [HRSTableViewSectionTransformer class];
 }
@@ -57,14 +200,25 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
     if (self) {
         _rowAnimation = UITableViewRowAnimationNone;
         _traitCollection = [UITraitCollection new];
+        _sections = [[_HRSTableViewSectionCoordinatorSections alloc] initWithSectionControllers:nil numberOfSections:nil];
+        _proxies = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+        _transitionProxies = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+        _changedSectionController = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+        _rowHeights = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+        _visibilityConditions = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+        _visibilityEvaluationObjects = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsWeakMemory];
+        _hiddenSectionController = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+        _deferredVisibilitySectionController = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
     }
     return self;
 }
 
 - (void)dealloc {
+	[self _discardPendingTableViewUpdates];
+	
 	// notify the section controller that the new table is now nil, in case they
 	// cached it.
-    for (HRSTableViewSectionController *controller in self.sectionController) {
+    for (HRSTableViewSectionController *controller in _sectionController) {
         [controller tableViewDidChange:nil];
     }
 	
@@ -73,6 +227,9 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 	if (tableView) {
         tableView.dataSource = nil;
         tableView.delegate = nil;
+        if ([tableView respondsToSelector:@selector(setPrefetchDataSource:)]) {
+            tableView.prefetchDataSource = nil;
+        }
 		objc_setAssociatedObject(tableView, CoordinatorTableViewLink, nil, OBJC_ASSOCIATION_ASSIGN);
 	}
 }
@@ -99,7 +256,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 
 - (void)_traitCollectionDidChange:(UITraitCollection *)previousTraitCollection {
     [self traitCollectionDidChange:previousTraitCollection];
-    for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+    for (id<HRSTableViewSectionController> sectionController in _sectionController) {
         if ([sectionController isKindOfClass:[HRSTableViewSectionController class]]) {
             [(HRSTableViewSectionController *)sectionController _updateTraitCollectionIfNecessary];
         }
@@ -118,20 +275,46 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
     HRSTableViewSectionTransformer *transformer = [[[self class] transformerClass] transformerWithSectionCoordinator:self];
     self.tableView.delegate = transformer;
     self.tableView.dataSource = transformer;
+    if ([self.tableView respondsToSelector:@selector(setPrefetchDataSource:)]) {
+        BOOL prefetches = [self respondsToSelector:@selector(tableView:prefetchRowsAtIndexPaths:)];
+        self.tableView.prefetchDataSource = (prefetches ? transformer : nil);
+    }
     self.transformer = transformer;
 }
 
+- (NSArray *)sectionController {
+	// report the latest list, so that it can be changed again during a transition
+	return (_transitionScheduled ? self.scheduledSectionController : _sectionController);
+}
+
 - (void)setSectionController:(NSArray *)sectionController {
 	[self setSectionController:sectionController animated:NO];
 }
 
 - (void)setSectionController:(NSArray *)sectionController animated:(BOOL)animated {
+	if (animated && _transitioning) {
+		// the table view is still animating, only the latest list is animated
+		// once the running transition finished
+		[self _scheduleSectionController:sectionController];
+		return;
+	}
+	
+	// this transition replaces the running one and all scheduled ones
+	NSUInteger transition = ++_transition;
+	_transitioning = animated;
+	_transitionScheduled = NO;
+	self.scheduledSectionController = nil;
+	
+	// the pending updates are based on the current section controllers
+	[self applyPendingTableViewUpdates];
+	
 	// setup local variables for operations and ensure we don't operate on or
 	// store a mutable array.
 	NSArray *oldSectionController = _sectionController;
 	NSArray *newSectionController = [sectionController copy];
     
     self.oldSectionController = oldSectionController;
+	[self.proxies removeAllObjects];
 	
 	// build sets for upcoming operations
 	NSSet *oldSectionControllerSet = [NSSet setWithArray:oldSectionController];
@@ -152,6 +335,9 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 	[addSectionControllerSet minusSet:oldSectionControllerSet];
 	
 	for (id<HRSTableViewSectionController> ctrl in removeSectionControllerSet) {
+		[self.rowHeights removeObjectForKey:ctrl];
+		[self.visibilityConditions removeObjectForKey:ctrl];
+		[self.visibilityEvaluationObjects removeObjectForKey:ctrl];
 		[ctrl setCoordinator:nil];
 		 // unlink the table view if we previously linked one
 		if (self.tableView && [ctrl respondsToSelector:@selector(tableViewDidChange:)]) {
@@ -176,13 +362,14 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
             // which will trigger the table view did end displaying callbacks,
             // so we need to delay this ones more!
             dispatch_async(dispatch_get_main_queue(), ^{
-                [self configureTransformer]; // delay this until here ensure a smooth transition
-                self.oldSectionController = nil;
+                if (transition == self->_transition) {
+                    [self _finishTransition];
+                }
             });
         }];
         
 		[self.tableView beginUpdates];
-		_sectionController = newSectionController;
+		[self _replaceSectionController:newSectionController];
         // if we are animating, we hold back the new transformer to guarantee a smooth animation
 		[self _animateFromSections:oldSectionController toSections:newSectionController];
 		[self.tableView endUpdates];
@@ -190,78 +377,237 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
         [CATransaction commit];
         
 	} else {
-		_sectionController = newSectionController;
+		[self _replaceSectionController:newSectionController];
+		[self.changedSectionController removeAllObjects]; // everything is reloaded anyway
+		[self.rowHeights removeAllObjects];
         [self configureTransformer];
 		[self.tableView reloadData];
         dispatch_async(dispatch_get_main_queue(), ^{ // wait for the table view to relayout
-            self.oldSectionController = nil;
+            if (transition == self->_transition) {
+                self.oldSectionController = nil;
+            }
         });
 	}
 }
 
+- (void)_scheduleSectionController:(NSArray *)sectionController {
+	NSArray *scheduledSectionController = [sectionController copy];
+	if (scheduledSectionController.count != [NSSet setWithArray:scheduledSectionController].count) {
+		[NSException raise:NSInternalInconsistencyException format:@"Using the same section controller instance twice is disallowed."];
+	}
+	
+	// intermediate lists are never shown, the scheduled transition goes from the
+	// section controllers on screen to the latest list
+	self.scheduledSectionController = scheduledSectionController;
+	_transitionScheduled = YES;
+}
+
+/// Ends the running transition and starts the scheduled one, if there is one.
+/// Otherwise applies the visibility changes made during the transition.
+- (void)_finishTransition {
+	[self configureTransformer]; // delay this until here ensure a smooth transition
+	self.oldSectionController = nil;
+	_transitioning = NO;
+	
+	if (_transitionScheduled) {
+		// the scheduled transition evaluates the visibility of all controllers
+		[self setSectionController:self.scheduledSectionController animated:YES];
+		return;
+	}
+	
+	NSArray *deferredSectionController = self.deferredVisibilitySectionController.allObjects;
+	[self.deferredVisibilitySectionController removeAllObjects];
+	for (id<HRSTableViewSectionController> controller in deferredSectionController) {
+		NSInteger index = [self.sections indexOfSectionController:controller];
+		if (index != NSNotFound) {
+			[self _updateVisibilityOfSectionControllerAtIndex:index];
+		}
+	}
+}
+
+- (void)_replaceSectionController:(NSArray *)sectionController {
+	NSArray *previousSectionController = _sectionController;
+	_sectionController = sectionController;
+	
+	[self _evaluateVisibilityOfSectionController:sectionController previousSectionController:previousSectionController];
+	self.sections = [self _sectionsForSectionController:sectionController];
+	self.responders = [[_HRSTableViewSectionCoordinatorResponders alloc] initWithSectionControllers:sectionController];
+}
+
+- (_HRSTableViewSectionCoordinatorSections *)_sectionsForSectionController:(NSArray *)sectionController {
+	return [[_HRSTableViewSectionCoordinatorSections alloc] initWithSectionControllers:sectionController numberOfSections:^NSInteger(id<HRSTableViewSectionController> controller) {
+		return [self _numberOfSectionsReportedBySectionController:controller];
+	}];
+}
+
+/// Asks a section controller for its number of sections, which is 1 unless it
+/// implements `numberOfSectionsInTableView:` and 0 if it is hidden.
+- (NSInteger)_numberOfSectionsReportedBySectionController:(id<HRSTableViewSectionController>)controller {
+	if ([self.hiddenSectionController containsObject:controller]) {
+		return 0;
+	}
+	if ([controller respondsToSelector:@selector(numberOfSectionsInTableView:)] == NO) {
+		return 1;
+	}
+	return [controller numberOfSectionsInTableView:[self tableViewForSectionController:controller]];
+}
+
+- (void)invalidateNumberOfSectionsForSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	NSInteger index = [self.sections indexOfSectionController:controller];
+	if (index == NSNotFound) {
+		return;
+	}
+	
+	// while updates are collected, the table view keeps the sections from
+	// before them, so the new sections are only used once they are applied
+	NSInteger numberOfSections = [self _numberOfSectionsReportedBySectionController:controller];
+	if (self.pendingUpdates) {
+		if (numberOfSections != [self.pendingSections numberOfSectionsOfSectionControllerAtIndex:index]) {
+			self.pendingSections = [self.pendingSections sectionsBySettingNumberOfSections:numberOfSections ofSectionControllerAtIndex:index];
+		}
+	} else if (numberOfSections != [self.sections numberOfSectionsOfSectionControllerAtIndex:index]) {
+		self.sections = [self.sections sectionsBySettingNumberOfSections:numberOfSections ofSectionControllerAtIndex:index];
+	}
+}
+
+/// Diffs the old and the new section controllers and sends the inserts,
+/// deletes, reloads and moves to the table view.
+/// Matching the controllers takes O(n), but finding the controllers that stay
+/// in place takes O(n log n) for reordered controllers instead of the O(n + d)
+/// of a Heckel or Myers diff. A linear pass would move every controller whose
+/// offset changed, so moving a single controller would also move all sections
+/// in between. The longest increasing run keeps the number of moves minimal,
+/// and changes without reordering still take O(n).
 - (void)_animateFromSections:(NSArray *)oldSections toSections:(NSArray *)newSections {
+	// the section tables of the old and the new section controllers are up to
+	// date at this point, so every controller is looked up in constant time.
+	// Every controller covers a run of sections, so all of its sections are
+	// inserted, deleted, reloaded or moved together.
+	_HRSTableViewSectionCoordinatorSections *oldTable = self.oldSections;
+	_HRSTableViewSectionCoordinatorSections *newTable = self.sections;
 	NSMutableIndexSet *insertIndex = [NSMutableIndexSet indexSet];
 	NSMutableIndexSet *deleteIndex = [NSMutableIndexSet indexSet];
+	NSMutableIndexSet *reloadIndex = [NSMutableIndexSet indexSet];
 	
-	NSInteger offset = 0;
-	
-	if (oldSections.count == 0) {
-		[insertIndex addIndexesInRange:NSMakeRange(0, newSections.count)];
+	for (NSUInteger oldIdx = 0; oldIdx < oldSections.count; oldIdx++) {
+		if ([newTable indexOfSectionController:oldSections[oldIdx]] == NSNotFound) {
+			[deleteIndex addIndexesInRange:NSMakeRange([oldTable firstSectionOfSectionControllerAtIndex:oldIdx], [oldTable numberOfSectionsOfSectionControllerAtIndex:oldIdx])];
+		}
 	}
 	
-	// iterate over old array
-	for (NSUInteger oldIdx = 0; oldIdx < oldSections.count; oldIdx++) {
-		id oldObj = oldSections[oldIdx];
-		BOOL match = NO;
-		
-		// iterate over new array and compare with old array
-		for (NSUInteger newIdx = oldIdx + offset; newIdx < newSections.count; newIdx++) {
-			id newObj = newSections[newIdx];
-			
-			if (oldObj == newObj) { // objects are the same!
-				// define the range that was in new array but not in old array
-				NSRange insertRange = NSMakeRange(oldIdx + offset, newIdx - (oldIdx + offset));
-				if (insertRange.length > 0) {
-					// if length was > 0, there are new insertions!
-					offset += insertRange.length; // shift the offset to make sure the next iteration starts with the new obj at the current position!
-					[insertIndex addIndexesInRange:insertRange];
-				}
-				// if we had a match, stop here!
-				match = YES;
-				break;
-			}
+	// collect the old and new indexes of every controller that is kept, in the
+	// order of the new controllers
+	NSUInteger *keptOldSections = malloc(MAX(newSections.count, 1u) * sizeof(NSUInteger));
+	NSUInteger *keptNewSections = malloc(MAX(newSections.count, 1u) * sizeof(NSUInteger));
+	NSUInteger keptCount = 0;
+	for (NSUInteger newIdx = 0; newIdx < newSections.count; newIdx++) {
+		NSInteger oldIdx = (oldTable ? [oldTable indexOfSectionController:newSections[newIdx]] : NSNotFound);
+		if (oldIdx == NSNotFound) {
+			[insertIndex addIndexesInRange:NSMakeRange([newTable firstSectionOfSectionControllerAtIndex:newIdx], [newTable numberOfSectionsOfSectionControllerAtIndex:newIdx])];
+		} else {
+			keptOldSections[keptCount] = oldIdx;
+			keptNewSections[keptCount] = newIdx;
+			keptCount++;
 		}
-		
-		if (match == NO) {
-			// if there was no match, the old object is not in the array anymore!
-			// => delete it
-			[deleteIndex addIndex:oldIdx];
-			offset--; // shift the offset to ignore the deleted object index in the new array
+	}
+	
+	// the controllers on the longest increasing run of old indexes keep their
+	// relative order and move along with the inserts and deletes, every other
+	// kept controller is moved explicitly.
+	BOOL *stationary = calloc(MAX(keptCount, 1u), sizeof(BOOL));
+	HRSTableViewSectionCoordinatorMarkIncreasingSections(keptOldSections, keptCount, stationary);
+	
+	NSUInteger moveCount = 0;
+	for (NSUInteger keptIdx = 0; keptIdx < keptCount; keptIdx++) {
+		id<HRSTableViewSectionController> controller = newSections[keptNewSections[keptIdx]];
+		NSRange oldRange = NSMakeRange([oldTable firstSectionOfSectionControllerAtIndex:keptOldSections[keptIdx]], [oldTable numberOfSectionsOfSectionControllerAtIndex:keptOldSections[keptIdx]]);
+		NSRange newRange = NSMakeRange([newTable firstSectionOfSectionControllerAtIndex:keptNewSections[keptIdx]], [newTable numberOfSectionsOfSectionControllerAtIndex:keptNewSections[keptIdx]]);
+		BOOL changed = [self.changedSectionController containsObject:controller];
+		if (changed) {
+			[self.rowHeights removeObjectForKey:controller];
 		}
-		
-		if (oldIdx == oldSections.count - 1) {
-			// last item! Add remaining new items if present!
-			NSUInteger newStart = oldIdx + offset + 1;
-			NSRange remainingNewRange = NSMakeRange(newStart, newSections.count - newStart);
-			if (remainingNewRange.length > 0) {
-				[insertIndex addIndexesInRange:remainingNewRange];
+		if (oldRange.length != newRange.length) {
+			// the sections of the controller cannot be matched one by one
+			[deleteIndex addIndexesInRange:oldRange];
+			[insertIndex addIndexesInRange:newRange];
+		} else if (stationary[keptIdx]) {
+			if (changed) {
+				[reloadIndex addIndexesInRange:oldRange];
 			}
+		} else if (changed) {
+			// a table view cannot move and reload the same section at once
+			[deleteIndex addIndexesInRange:oldRange];
+			[insertIndex addIndexesInRange:newRange];
+		} else {
+			keptOldSections[moveCount] = keptOldSections[keptIdx];
+			keptNewSections[moveCount] = keptNewSections[keptIdx];
+			moveCount++;
 		}
 	}
+	[self.changedSectionController removeAllObjects];
 	
-	[self.tableView insertSections:insertIndex withRowAnimation:self.rowAnimation];
-	[self.tableView deleteSections:deleteIndex withRowAnimation:self.rowAnimation];
+	if (insertIndex.count > 0) {
+		[self.tableView insertSections:insertIndex withRowAnimation:self.rowAnimation];
+	}
+	if (deleteIndex.count > 0) {
+		[self.tableView deleteSections:deleteIndex withRowAnimation:self.rowAnimation];
+	}
+	if (reloadIndex.count > 0) {
+		[self.tableView reloadSections:reloadIndex withRowAnimation:self.rowAnimation];
+	}
+	for (NSUInteger moveIdx = 0; moveIdx < moveCount; moveIdx++) {
+		NSInteger oldSection = [oldTable firstSectionOfSectionControllerAtIndex:keptOldSections[moveIdx]];
+		NSInteger newSection = [newTable firstSectionOfSectionControllerAtIndex:keptNewSections[moveIdx]];
+		NSInteger numberOfSections = [newTable numberOfSectionsOfSectionControllerAtIndex:keptNewSections[moveIdx]];
+		for (NSInteger section = 0; section < numberOfSections; section++) {
+			[self.tableView moveSection:oldSection + section toSection:newSection + section];
+		}
+	}
+	
+	free(stationary);
+	free(keptNewSections);
+	free(keptOldSections);
+}
+
+- (void)setSectionControllerNeedsReload:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	[self.changedSectionController addObject:controller];
 }
 
 
 
 #pragma mark - proxying
 
+- (void)setOldSectionController:(NSArray *)oldSectionController {
+	_oldSectionController = oldSectionController;
+	[self.transitionProxies removeAllObjects];
+	
+	// the old section controllers are the current ones when a transition
+	// starts, so their tables can simply be shared
+	if (oldSectionController && oldSectionController == _sectionController) {
+		self.oldSections = self.sections;
+		self.oldResponders = self.responders;
+	} else {
+		self.oldSections = (oldSectionController ? [self _sectionsForSectionController:oldSectionController] : nil);
+		self.oldResponders = (oldSectionController ? [[_HRSTableViewSectionCoordinatorResponders alloc] initWithSectionControllers:oldSectionController] : nil);
+	}
+}
+
 - (UITableView *)tableViewForSectionController:(id<HRSTableViewSectionController>)controller {
     if (controller == nil || self.tableView == nil) {
         return nil;
     }
-	_HRSTableViewSectionCoordinatorProxy *proxy = [_HRSTableViewSectionCoordinatorProxy proxyWithController:controller tableView:self.tableView];
+	// the proxy is reused until the section controllers or the table view change
+	_HRSTableViewSectionCoordinatorProxy *proxy = [self.proxies objectForKey:controller];
+	if (proxy == nil) {
+		proxy = [_HRSTableViewSectionCoordinatorProxy proxyWithController:controller tableView:self.tableView];
+		proxy.reverseProxy.instrumented = _instrumented;
+		[self.proxies setObject:proxy forKey:controller];
+	}
 	return (UITableView *)proxy;
 }
 
@@ -277,14 +623,39 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
     if (controller == nil) {
         return nil;
     }
-	_HRSTableViewSectionCoordinatorProxy *proxy = [_HRSTableViewSectionCoordinatorProxy reverseProxyWithController:controller tableView:self.tableView];
+    
     if (beforeTransition && self.oldSectionController) {
-        proxy.sectionControllers = self.oldSectionController;
+        _HRSTableViewSectionCoordinatorProxy *proxy = [self.transitionProxies objectForKey:controller];
+        if (proxy == nil) {
+            proxy = [_HRSTableViewSectionCoordinatorProxy reverseProxyWithController:controller tableView:self.tableView];
+            proxy.sectionControllers = self.oldSectionController;
+            proxy.instrumented = _instrumented;
+            [self.transitionProxies setObject:proxy forKey:controller];
+        }
+        return (id<HRSTableViewSectionController>)proxy;
     }
-	return (id<HRSTableViewSectionController>)proxy;
+    
+	// both directions share a single pair of proxies
+	_HRSTableViewSectionCoordinatorProxy *proxy = (_HRSTableViewSectionCoordinatorProxy *)[self tableViewForSectionController:controller];
+	return (id<HRSTableViewSectionController>)[proxy reverseProxy];
+}
+
+- (id<HRSTableViewSectionController>)sectionControllerForTableSection:(NSInteger)section respondingToSelector:(SEL)selector {
+	return [self sectionControllerForTableSection:section beforeTransition:NO respondingToSelector:selector];
+}
+
+- (id<HRSTableViewSectionController>)sectionControllerForTableSection:(NSInteger)section beforeTransition:(BOOL)beforeTransition respondingToSelector:(SEL)selector {
+	// answer from the responder table, so that controllers that do not
+	// implement the selector neither need to be asked nor proxied
+	BOOL useOldSections = (beforeTransition && self.oldSectionController);
+	_HRSTableViewSectionCoordinatorResponders *responders = (useOldSections ? self.oldResponders : self.responders);
+	NSInteger index = [(useOldSections ? self.oldSections : self.sections) indexOfSectionControllerForSection:section];
+	if ([responders sectionControllerAtIndex:index respondsToSelector:selector] == NO) {
+		return nil;
+	}
+	return [self sectionControllerForTableSection:section beforeTransition:beforeTransition];
 }
 
-// FIXME: The performance of this method should be improved as much as possible! - We could probably check all supported protocol methods when the sectionController array is re-set!
 // FIXME: There needs to be a way to add protocols for mapping to this method!
 - (BOOL)respondsToSelector:(SEL)aSelector {
 	if (aSelector == @selector(numberOfSectionsInTableView:)) {
@@ -295,22 +666,323 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 		return NO;
 	}
 	
-	// check if the selector belongs to the table view delegate or data source protocol
-	struct objc_method_description hasScrollViewMethod = protocol_getMethodDescription(@protocol(UIScrollViewDelegate), aSelector, NO, YES);
-	struct objc_method_description hasDelegateMethod = protocol_getMethodDescription(@protocol(UITableViewDelegate), aSelector, NO, YES);
-	struct objc_method_description hasDataSourceMethod = protocol_getMethodDescription(@protocol(UITableViewDataSource), aSelector, NO, YES);
+	// if the selector belongs to the table view delegate or data source protocol
+	// only respond to selectors that are implemented in at least one of the
+	// section controllers!
+	if ([_HRSTableViewSectionCoordinatorResponders isProtocolSelector:aSelector]) {
+		return [self.responders anySectionControllerRespondsToSelector:aSelector];
+	}
 	
-	if (hasScrollViewMethod.name || hasScrollViewMethod.types || hasDelegateMethod.name || hasDelegateMethod.types || hasDataSourceMethod.name || hasDataSourceMethod.types) {
-		// if so, only respond to selectors that are implemented in at least one of the section controllers!
-		for (id<HRSTableViewSectionController> controller in self.sectionController) {
-			if ([controller respondsToSelector:aSelector]) {
-				return YES;
-			}
+	return YES;
+}
+
+
+
+#pragma mark - row height cache
+
+- (void)setRowHeightCacheEnabled:(BOOL)rowHeightCacheEnabled {
+	_rowHeightCacheEnabled = rowHeightCacheEnabled;
+	[self.rowHeights removeAllObjects];
+}
+
+- (void)invalidateRowHeightsForSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	[self.rowHeights removeObjectForKey:controller];
+}
+
+- (void)invalidateRowHeightAtIndexPath:(NSIndexPath *)indexPath forSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(indexPath);
+	NSParameterAssert(controller);
+	if (indexPath == nil || controller == nil) {
+		return;
+	}
+	NSMutableDictionary *rowHeights = [self.rowHeights objectForKey:controller];
+	[rowHeights removeObjectForKey:indexPath];
+}
+
+- (NSNumber *)_cachedRowHeightForTableViewIndexPath:(NSIndexPath *)indexPath {
+	id<HRSTableViewSectionController> controller = [self _sectionControllerForTableSection:indexPath.section beforeTransition:NO];
+	if (controller == nil) {
+		return nil;
+	}
+	NSMutableDictionary *rowHeights = [self.rowHeights objectForKey:controller];
+	return rowHeights[[self controllerIndexPathForTableViewIndexPath:indexPath withController:controller]];
+}
+
+- (void)_cacheRowHeight:(NSNumber *)rowHeight forTableViewIndexPath:(NSIndexPath *)indexPath {
+	id<HRSTableViewSectionController> controller = [self _sectionControllerForTableSection:indexPath.section beforeTransition:NO];
+	if (controller == nil) {
+		return;
+	}
+	NSMutableDictionary *rowHeights = [self.rowHeights objectForKey:controller];
+	if (rowHeights == nil) {
+		rowHeights = [NSMutableDictionary dictionary];
+		[self.rowHeights setObject:rowHeights forKey:controller];
+	}
+	rowHeights[[self controllerIndexPathForTableViewIndexPath:indexPath withController:controller]] = rowHeight;
+}
+
+
+
+#pragma mark - update coalescing
+
+- (void)setUpdateCoalescingEnabled:(BOOL)updateCoalescingEnabled {
+	if (updateCoalescingEnabled == NO) {
+		[self applyPendingTableViewUpdates];
+	}
+	_updateCoalescingEnabled = updateCoalescingEnabled;
+}
+
+- (void)applyPendingTableViewUpdates {
+	_HRSTableViewSectionCoordinatorUpdates *updates = self.pendingUpdates;
+	if (updates == nil) {
+		return;
+	}
+	[self _discardPendingTableViewUpdates];
+	
+	UITableView *tableView = self.tableView;
+	if (tableView == nil || updates.empty) {
+		return;
+	}
+	[tableView beginUpdates];
+	[updates applyToTableView:tableView sections:self.sections];
+	[tableView endUpdates];
+}
+
+/// Returns the updates the table view proxies add their updates to, or nil if
+/// updates are not coalesced. Starts a new run loop turn if necessary.
+- (_HRSTableViewSectionCoordinatorUpdates *)_tableViewUpdatesToCollect {
+	if (self.updateCoalescingEnabled == NO || self.tableView == nil) {
+		return nil;
+	}
+	
+	if (self.pendingUpdates == nil) {
+		self.pendingUpdates = [[_HRSTableViewSectionCoordinatorUpdates alloc] initWithSections:self.sections];
+		self.pendingSections = self.sections;
+		
+		__weak typeof(self) weakSelf = self;
+		_updateObserver = CFRunLoopObserverCreateWithHandler(NULL, (kCFRunLoopBeforeWaiting | kCFRunLoopExit), false, HRSTableViewSectionCoordinatorUpdateObserverOrder, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+			[weakSelf applyPendingTableViewUpdates];
+		});
+		CFRunLoopAddObserver(CFRunLoopGetMain(), _updateObserver, kCFRunLoopCommonModes);
+	}
+	return self.pendingUpdates;
+}
+
+- (void)_discardPendingTableViewUpdates {
+	// the table view gets the sections after the updates either way, by
+	// applying or by reloading them
+	if (self.pendingSections) {
+		self.sections = self.pendingSections;
+		self.pendingSections = nil;
+	}
+	self.pendingUpdates = nil;
+	if (_updateObserver) {
+		CFRunLoopObserverInvalidate(_updateObserver);
+		CFRelease(_updateObserver);
+		_updateObserver = NULL;
+	}
+}
+
+/// Called by the table view proxies around every call from the table view to
+/// a section controller.
+- (void)_beginTableViewCallback {
+	_tableViewCallbackDepth++;
+}
+
+- (void)_endTableViewCallback {
+	if (_tableViewCallbackDepth > 0) {
+		_tableViewCallbackDepth--;
+	}
+}
+
+- (BOOL)_isHandlingTableViewCallback {
+	return (_tableViewCallbackDepth > 0);
+}
+
+
+
+#pragma mark - visibility
+
+- (void)setVisibilityConditionForSectionController:(id<HRSTableViewSectionController>)controller condition:(BOOL(^)(void))condition {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	[self _setVisibilityCondition:[condition copy] evaluationObject:nil forSectionController:controller];
+}
+
+- (void)setVisibilityConditionForSectionController:(id<HRSTableViewSectionController>)controller predicate:(NSPredicate *)predicate evaluationObject:(id)object {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	[self _setVisibilityCondition:predicate evaluationObject:object forSectionController:controller];
+}
+
+- (void)_setVisibilityCondition:(id)condition evaluationObject:(id)object forSectionController:(id<HRSTableViewSectionController>)controller {
+	if (condition) {
+		[self.visibilityConditions setObject:condition forKey:controller];
+	} else {
+		[self.visibilityConditions removeObjectForKey:controller];
+	}
+	if (object) {
+		[self.visibilityEvaluationObjects setObject:object forKey:controller];
+	} else {
+		[self.visibilityEvaluationObjects removeObjectForKey:controller];
+	}
+	
+	// controllers that are not shown yet are evaluated when they are added
+	NSInteger index = [self.sections indexOfSectionController:controller];
+	if (index == NSNotFound) {
+		return;
+	}
+	
+	if (self.visibilityMapper == nil) {
+		self.visibilityMapper = [self _visibilityMapper];
+	}
+	[self _setVisibilityCondition:condition evaluationObject:object forSection:index ofMapper:self.visibilityMapper];
+	[self _updateVisibilityOfSectionControllerAtIndex:index];
+}
+
+- (void)invalidateVisibilityOfSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	NSInteger index = [self.sections indexOfSectionController:controller];
+	if (index == NSNotFound || self.visibilityMapper == nil) {
+		return;
+	}
+	[self.visibilityMapper invalidateConditionForIndexPath:[NSIndexPath indexPathWithIndex:index]];
+	[self _updateVisibilityOfSectionControllerAtIndex:index];
+}
+
+- (BOOL)isSectionControllerVisible:(id<HRSTableViewSectionController>)controller {
+	return ([self.sections indexOfSectionController:controller] != NSNotFound && [self _isSectionControllerHidden:controller] == NO);
+}
+
+- (BOOL)_isSectionControllerHidden:(id<HRSTableViewSectionController>)controller {
+	// this is asked for every mapped call, most coordinators do not hide any
+	// controller
+	return (self.hiddenSectionController.count > 0 && controller && [self.hiddenSectionController containsObject:controller]);
+}
+
+- (HRSIndexPathMapper *)_visibilityMapper {
+	// every condition is evaluated once and flipped in logarithmic time
+	HRSIndexPathMapper *mapper = [HRSIndexPathMapper new];
+	mapper.snapshotEnabled = YES;
+	return mapper;
+}
+
+- (void)_setVisibilityCondition:(id)condition evaluationObject:(id)object forSection:(NSInteger)section ofMapper:(HRSIndexPathMapper *)mapper {
+	if ([condition isKindOfClass:[NSPredicate class]]) {
+		[mapper setConditionForSection:section predicate:condition evaluationObject:object];
+	} else {
+		[mapper setConditionForSection:section condition:condition]; // removes the condition if it is nil
+	}
+}
+
+/// Moves the conditions of the visibility mapper to the indexes of a new list
+/// of section controllers and collects the controllers that are hidden. Only
+/// the conditions of controllers that changed their index are set again, all
+/// others keep their evaluated result.
+- (void)_evaluateVisibilityOfSectionController:(NSArray *)sectionController previousSectionController:(NSArray *)previousSectionController {
+	[self.hiddenSectionController removeAllObjects];
+	[self.deferredVisibilitySectionController removeAllObjects];
+	if (self.visibilityConditions.count == 0) {
+		self.visibilityMapper = nil;
+		return;
+	}
+	
+	HRSIndexPathMapper *mapper = self.visibilityMapper;
+	if (mapper == nil) {
+		// a new mapper does not contain the conditions of the previous list
+		mapper = [self _visibilityMapper];
+		self.visibilityMapper = mapper;
+		previousSectionController = nil;
+	}
+	
+	// the static sections of the mapper are the indexes of the controllers
+	NSUInteger count = MAX(sectionController.count, previousSectionController.count);
+	for (NSUInteger idx = 0; idx < count; idx++) {
+		id<HRSTableViewSectionController> controller = (idx < sectionController.count ? sectionController[idx] : nil);
+		id<HRSTableViewSectionController> previousController = (idx < previousSectionController.count ? previousSectionController[idx] : nil);
+		id condition = (controller ? [self.visibilityConditions objectForKey:controller] : nil);
+		if (controller != previousController && (condition || previousController)) {
+			// removes the condition of the previous controller if there is none
+			[self _setVisibilityCondition:condition evaluationObject:[self.visibilityEvaluationObjects objectForKey:controller] forSection:idx ofMapper:mapper];
+		}
+		if (condition && [mapper dynamicSectionForStaticSection:idx] == NSNotFound) {
+			[self.hiddenSectionController addObject:controller];
 		}
-		return NO;
+	}
+}
+
+/// Evaluates the visibility of a controller of `sectionController` and inserts
+/// or deletes its sections if it changed.
+- (void)_updateVisibilityOfSectionControllerAtIndex:(NSUInteger)index {
+	id<HRSTableViewSectionController> controller = _sectionController[index];
+	BOOL hidden = ([self.visibilityMapper dynamicSectionForStaticSection:index] == NSNotFound);
+	if (hidden == [self.hiddenSectionController containsObject:controller]) {
+		return;
 	}
 	
-	return YES;
+	// the table view must not get updates while it animates a transition, the
+	// sections are inserted or deleted when the transition finished
+	if (_transitioning) {
+		[self.deferredVisibilitySectionController addObject:controller];
+		return;
+	}
+	
+	// the pending updates are based on the current sections
+	[self applyPendingTableViewUpdates];
+	
+	NSInteger firstSection = [self.sections firstSectionOfSectionControllerAtIndex:index];
+	NSInteger numberOfSections;
+	if (hidden) {
+		numberOfSections = [self.sections numberOfSectionsOfSectionControllerAtIndex:index];
+		[self.hiddenSectionController addObject:controller];
+		[self.rowHeights removeObjectForKey:controller];
+	} else {
+		[self.hiddenSectionController removeObject:controller];
+		numberOfSections = [self _numberOfSectionsReportedBySectionController:controller];
+	}
+	self.sections = [self.sections sectionsBySettingNumberOfSections:(hidden ? 0 : numberOfSections) ofSectionControllerAtIndex:index];
+	
+	if (numberOfSections <= 0) {
+		return;
+	}
+	NSIndexSet *sections = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(firstSection, numberOfSections)];
+	if (hidden) {
+		[self.tableView deleteSections:sections withRowAnimation:self.rowAnimation];
+	} else {
+		[self.tableView insertSections:sections withRowAnimation:self.rowAnimation];
+	}
+}
+
+
+
+#pragma mark - instrumentation
+
+- (void)setInstrumentation:(id<HRSTableViewSectionCoordinatorInstrumentation>)instrumentation {
+	_instrumentation = instrumentation;
+	_instrumented = (instrumentation != nil);
+	
+	// proxies learn whether they are instrumented when they are created
+	[self.proxies removeAllObjects];
+	[self.transitionProxies removeAllObjects];
+}
+
+/// Reports a call to a section controller that does not pass a proxy.
+- (void)_reportCallWithSelector:(SEL)selector onSectionController:(id<HRSTableViewSectionController>)controller duration:(uint64_t)duration {
+	static mach_timebase_info_data_t timebase;
+	if (timebase.denom == 0) {
+		mach_timebase_info(&timebase);
+	}
+	
+	NSTimeInterval seconds = (NSTimeInterval)duration * timebase.numer / timebase.denom / NSEC_PER_SEC;
+	[self.instrumentation sectionCoordinator:self didCallSelector:selector onSectionController:controller duration:seconds];
 }
 
 
@@ -322,6 +994,10 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 	[oldCoordinator setTableView:nil];
 	
 	_tableView = tableView;
+	[self _discardPendingTableViewUpdates]; // the table view is reloaded anyway
+	[self.rowHeights removeAllObjects];
+	[self.proxies removeAllObjects];
+	[self.transitionProxies removeAllObjects];
 	
 	if (tableView) {
 		objc_setAssociatedObject(tableView, CoordinatorTableViewLink, self, OBJC_ASSOCIATION_ASSIGN);
@@ -332,20 +1008,43 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 	
 	[self _tableViewDidChange];
 	
+	// the section controllers may report their number of sections based on
+	// the table view they were given
+	self.sections = [self _sectionsForSectionController:_sectionController];
+	
 	[tableView reloadData];
 }
 
 - (id<HRSTableViewSectionController>)_sectionControllerForTableSection:(NSInteger)section beforeTransition:(BOOL)beforeTransition {
-    NSArray *sectionController = (beforeTransition && self.oldSectionController ? self.oldSectionController : self.sectionController);
-    if (sectionController.count > section) {
-        return [sectionController objectAtIndex:section];
-    } else {
-        return nil;
-    }
+	_HRSTableViewSectionCoordinatorSections *sections = (beforeTransition && self.oldSectionController ? self.oldSections : self.sections);
+	NSInteger index = [sections indexOfSectionControllerForSection:section];
+	if (index == NSNotFound) {
+		return nil;
+	}
+	return sections.sectionControllers[index];
+}
+
+- (NSInteger)_sectionOffsetForController:(id<HRSTableViewSectionController>)controller beforeTransition:(BOOL)beforeTransition {
+	if (beforeTransition && self.oldSections) {
+		return [self.oldSections firstSectionOfSectionController:controller];
+	}
+	// hidden controllers do not have any section in the table view
+	if ([self _isSectionControllerHidden:controller]) {
+		return NSNotFound;
+	}
+	return [self.sections firstSectionOfSectionController:controller];
+}
+
+- (NSInteger)_numberOfSectionsForController:(id<HRSTableViewSectionController>)controller {
+	NSInteger index = [self.sections indexOfSectionController:controller];
+	if (index == NSNotFound) {
+		return 0;
+	}
+	return [self.sections numberOfSectionsOfSectionControllerAtIndex:index];
 }
 
 - (void)_tableViewDidChange {
-	for (id<HRSTableViewSectionController> controller in self.sectionController) {
+	for (id<HRSTableViewSectionController> controller in _sectionController) {
 		if ([controller respondsToSelector:@selector(tableViewDidChange:)]) {
 			[controller tableViewDidChange:[self tableViewForSectionController:controller]];
 		}
@@ -369,21 +1068,25 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+	os_signpost_id_t signpost = (_instrumented ? HRSTableViewSectionCoordinatorBeginSignpost(HRSTableViewSectionCoordinatorSignpostCellForRow, indexPath) : OS_SIGNPOST_ID_NULL);
 	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
 	UITableViewCell *cell = [sectionController tableView:tableView cellForRowAtIndexPath:indexPath];
+	if (_instrumented) {
+		HRSTableViewSectionCoordinatorEndSignpost(HRSTableViewSectionCoordinatorSignpostCellForRow, signpost);
+	}
 	return cell;
 }
 
 // - optionals:
 
 - (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
-	NSInteger numberOfSections = self.sectionController.count;
+	NSInteger numberOfSections = self.sections.numberOfSections;
 	return numberOfSections;
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView titleForHeaderInSection:section];
 	} else {
 		return nil;
@@ -391,8 +1094,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForFooterInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView titleForFooterInSection:section];
 	} else {
 		return nil;
@@ -400,8 +1103,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)tableView:(UITableView *)tableView canEditRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView canEditRowAtIndexPath:indexPath];
 	} else {
 		return YES;
@@ -409,29 +1112,29 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)tableView:(UITableView *)tableView canMoveRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView canMoveRowAtIndexPath:indexPath];
 	} else {
-		return [sectionController respondsToSelector:@selector(tableView:moveRowAtIndexPath:toIndexPath:)];
+		return [self.responders sectionControllerAtIndex:[self.sections indexOfSectionControllerForSection:indexPath.section] respondsToSelector:@selector(tableView:moveRowAtIndexPath:toIndexPath:)];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView commitEditingStyle:(UITableViewCellEditingStyle)editingStyle forRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView commitEditingStyle:editingStyle forRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView moveRowAtIndexPath:(NSIndexPath *)sourceIndexPath toIndexPath:(NSIndexPath *)destinationIndexPath {
-	id<HRSTableViewSectionController> sourceSectionController = [self sectionControllerForTableSection:sourceIndexPath.section];
-	if ([sourceSectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sourceSectionController = [self sectionControllerForTableSection:sourceIndexPath.section respondingToSelector:_cmd];
+	if (sourceSectionController) {
 		[sourceSectionController tableView:tableView moveRowAtIndexPath:sourceIndexPath toIndexPath:destinationIndexPath];
 	}
 	if (sourceIndexPath.section != destinationIndexPath.section) {
-		id<HRSTableViewSectionController> destinationSectionController = [self sectionControllerForTableSection:destinationIndexPath.section];
-		if ([destinationSectionController respondsToSelector:_cmd]) {
+		id<HRSTableViewSectionController> destinationSectionController = [self sectionControllerForTableSection:destinationIndexPath.section respondingToSelector:_cmd];
+		if (destinationSectionController) {
 			[destinationSectionController tableView:tableView moveRowAtIndexPath:sourceIndexPath toIndexPath:destinationIndexPath];
 		}
 	}
@@ -439,62 +1142,135 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 
 
 
+#pragma mark - table view data source prefetching
+
+- (void)tableView:(UITableView *)tableView prefetchRowsAtIndexPaths:(NSArray *)indexPaths {
+	[self _enumerateSectionControllersForIndexPaths:indexPaths respondingToSelector:_cmd usingBlock:^(id<HRSTableViewSectionController> controller, NSArray *controllerIndexPaths) {
+		[(id<UITableViewDataSourcePrefetching>)controller tableView:[self tableViewForSectionController:controller] prefetchRowsAtIndexPaths:controllerIndexPaths];
+	}];
+}
+
+- (void)tableView:(UITableView *)tableView cancelPrefetchingForRowsAtIndexPaths:(NSArray *)indexPaths {
+	[self _enumerateSectionControllersForIndexPaths:indexPaths respondingToSelector:_cmd usingBlock:^(id<HRSTableViewSectionController> controller, NSArray *controllerIndexPaths) {
+		[(id<UITableViewDataSourcePrefetching>)controller tableView:[self tableViewForSectionController:controller] cancelPrefetchingForRowsAtIndexPaths:controllerIndexPaths];
+	}];
+}
+
+/**
+ Splits a list of table view index paths by the section controllers they belong
+ to and maps them into the space of their section controller.
+ 
+ Section controllers are called directly with the mapped index paths instead of
+ mapping every index path through a proxy. Index paths of section controllers
+ that do not implement the selector are skipped. As no proxy is involved, the
+ calls are reported to the instrumentation from here.
+ 
+ @param indexPaths the index paths in the space of the table view
+ @param selector   the selector the section controllers must implement
+ @param block      called once per section controller, in the order the section
+                   controllers first appear in the list of index paths
+ */
+- (void)_enumerateSectionControllersForIndexPaths:(NSArray *)indexPaths respondingToSelector:(SEL)selector usingBlock:(void(^)(id<HRSTableViewSectionController> controller, NSArray *controllerIndexPaths))block {
+	if (self.tableView == nil) {
+		return;
+	}
+	
+	NSMutableArray *controllers = [NSMutableArray array];
+	NSMapTable *controllerIndexPaths = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+	for (NSIndexPath *indexPath in indexPaths) {
+		if ([self.responders sectionControllerAtIndex:[self.sections indexOfSectionControllerForSection:indexPath.section] respondsToSelector:selector] == NO) {
+			continue;
+		}
+		id<HRSTableViewSectionController> controller = [self _sectionControllerForTableSection:indexPath.section beforeTransition:NO];
+		NSMutableArray *mappedIndexPaths = [controllerIndexPaths objectForKey:controller];
+		if (mappedIndexPaths == nil) {
+			mappedIndexPaths = [NSMutableArray array];
+			[controllerIndexPaths setObject:mappedIndexPaths forKey:controller];
+			[controllers addObject:controller];
+		}
+		[mappedIndexPaths addObject:[self controllerIndexPathForTableViewIndexPath:indexPath withController:controller]];
+	}
+	
+	for (id<HRSTableViewSectionController> controller in controllers) {
+		uint64_t start = (_instrumented ? mach_absolute_time() : 0);
+		block(controller, [[controllerIndexPaths objectForKey:controller] copy]);
+		if (_instrumented) {
+			[self _reportCallWithSelector:selector onSectionController:controller duration:mach_absolute_time() - start];
+		}
+	}
+}
+
+
+
 #pragma mark - table view delegate
 
 - (void)tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView willDisplayCell:cell forRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView willDisplayHeaderView:(UIView *)view forSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView willDisplayHeaderView:view forSection:section];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView willDisplayFooterView:(UIView *)view forSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView willDisplayFooterView:view forSection:section];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView didEndDisplayingCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath*)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section beforeTransition:YES];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section beforeTransition:YES respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didEndDisplayingCell:cell forRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView didEndDisplayingHeaderView:(UIView *)view forSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section beforeTransition:YES];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section beforeTransition:YES respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didEndDisplayingHeaderView:view forSection:section];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView didEndDisplayingFooterView:(UIView *)view forSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section beforeTransition:YES];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section beforeTransition:YES respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didEndDisplayingFooterView:view forSection:section];
 	}
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
-		return [sectionController tableView:tableView heightForRowAtIndexPath:indexPath];
+	os_signpost_id_t signpost = (_instrumented ? HRSTableViewSectionCoordinatorBeginSignpost(HRSTableViewSectionCoordinatorSignpostHeightForRow, indexPath) : OS_SIGNPOST_ID_NULL);
+	CGFloat height;
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController == nil) {
+		height = tableView.rowHeight;
+	} else if (self.rowHeightCacheEnabled == NO) {
+		height = [sectionController tableView:tableView heightForRowAtIndexPath:indexPath];
 	} else {
-		return tableView.rowHeight;
+		NSNumber *rowHeight = [self _cachedRowHeightForTableViewIndexPath:indexPath];
+		if (rowHeight == nil) {
+			rowHeight = @([sectionController tableView:tableView heightForRowAtIndexPath:indexPath]);
+			[self _cacheRowHeight:rowHeight forTableViewIndexPath:indexPath];
+		}
+		height = (CGFloat)rowHeight.doubleValue;
+	}
+	if (_instrumented) {
+		HRSTableViewSectionCoordinatorEndSignpost(HRSTableViewSectionCoordinatorSignpostHeightForRow, signpost);
 	}
+	return height;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForHeaderInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView heightForHeaderInSection:section];
 	} else {
 		return UITableViewAutomaticDimension;
@@ -502,8 +1278,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForFooterInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView heightForFooterInSection:section];
 	} else {
 		return UITableViewAutomaticDimension;
@@ -511,8 +1287,13 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView estimatedHeightForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	NSNumber *rowHeight = (self.rowHeightCacheEnabled ? [self _cachedRowHeightForTableViewIndexPath:indexPath] : nil);
+	if (rowHeight) {
+		return (CGFloat)rowHeight.doubleValue;
+	}
+	
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView estimatedHeightForRowAtIndexPath:indexPath];
 	} else {
 		return [self tableView:tableView heightForRowAtIndexPath:indexPath];
@@ -520,8 +1301,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView estimatedHeightForHeaderInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView estimatedHeightForHeaderInSection:section];
 	} else {
 		return [self tableView:tableView heightForHeaderInSection:section];
@@ -529,8 +1310,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView estimatedHeightForFooterInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView estimatedHeightForFooterInSection:section];
 	} else {
 		return [self tableView:tableView heightForFooterInSection:section];
@@ -538,8 +1319,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (UIView *)tableView:(UITableView *)tableView viewForHeaderInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView viewForHeaderInSection:section];
 	} else {
 		return nil;
@@ -547,8 +1328,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (UIView *)tableView:(UITableView *)tableView viewForFooterInSection:(NSInteger)section {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView viewForFooterInSection:section];
 	} else {
 		return nil;
@@ -556,15 +1337,15 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)tableView:(UITableView *)tableView accessoryButtonTappedForRowWithIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView accessoryButtonTappedForRowWithIndexPath:indexPath];
 	}
 }
 
 - (BOOL)tableView:(UITableView *)tableView shouldHighlightRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView shouldHighlightRowAtIndexPath:indexPath];
 	} else {
 		return YES;
@@ -572,22 +1353,22 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)tableView:(UITableView *)tableView didHighlightRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didHighlightRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView didUnhighlightRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didUnhighlightRowAtIndexPath:indexPath];
 	}
 }
 
 - (NSIndexPath *)tableView:(UITableView *)tableView willSelectRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView willSelectRowAtIndexPath:indexPath];
 	} else {
 		return indexPath;
@@ -595,8 +1376,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (NSIndexPath *)tableView:(UITableView *)tableView willDeselectRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView willDeselectRowAtIndexPath:indexPath];
 	} else {
 		return indexPath;
@@ -604,22 +1385,22 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didSelectRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView *)tableView didDeselectRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didDeselectRowAtIndexPath:indexPath];
 	}
 }
 
 - (UITableViewCellEditingStyle)tableView:(UITableView *)tableView editingStyleForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView editingStyleForRowAtIndexPath:indexPath];
 	} else {
 		return UITableViewCellEditingStyleDelete;
@@ -627,8 +1408,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForDeleteConfirmationButtonForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView titleForDeleteConfirmationButtonForRowAtIndexPath:indexPath];
 	} else {
 		return nil;
@@ -636,8 +1417,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (NSArray *)tableView:(UITableView *)tableView editActionsForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView editActionsForRowAtIndexPath:indexPath];
 	} else {
 		return nil;
@@ -645,8 +1426,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)tableView:(UITableView *)tableView shouldIndentWhileEditingRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView shouldIndentWhileEditingRowAtIndexPath:indexPath];
 	} else {
 		return YES;
@@ -654,22 +1435,22 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)tableView:(UITableView*)tableView willBeginEditingRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView willBeginEditingRowAtIndexPath:indexPath];
 	}
 }
 
 - (void)tableView:(UITableView*)tableView didEndEditingRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView didEndEditingRowAtIndexPath:indexPath];
 	}
 }
 
 - (NSIndexPath *)tableView:(UITableView *)tableView targetIndexPathForMoveFromRowAtIndexPath:(NSIndexPath *)sourceIndexPath toProposedIndexPath:(NSIndexPath *)proposedDestinationIndexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:sourceIndexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:sourceIndexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView targetIndexPathForMoveFromRowAtIndexPath:sourceIndexPath toProposedIndexPath:proposedDestinationIndexPath];
 	} else {
 		return proposedDestinationIndexPath;
@@ -677,8 +1458,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (NSInteger)tableView:(UITableView *)tableView indentationLevelForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView indentationLevelForRowAtIndexPath:indexPath];
 	} else {
 		return 0;
@@ -686,8 +1467,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)tableView:(UITableView *)tableView shouldShowMenuForRowAtIndexPath:(NSIndexPath *)indexPath {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView shouldShowMenuForRowAtIndexPath:indexPath];
 	} else {
 		return NO;
@@ -695,8 +1476,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)tableView:(UITableView *)tableView canPerformAction:(SEL)action forRowAtIndexPath:(NSIndexPath *)indexPath withSender:(id)sender {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		return [sectionController tableView:tableView canPerformAction:action forRowAtIndexPath:indexPath withSender:sender];
 	} else {
 		return NO;
@@ -704,8 +1485,8 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)tableView:(UITableView *)tableView performAction:(SEL)action forRowAtIndexPath:(NSIndexPath *)indexPath withSender:(id)sender {
-	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section];
-	if ([sectionController respondsToSelector:_cmd]) {
+	id<HRSTableViewSectionController> sectionController = [self sectionControllerForTableSection:indexPath.section respondingToSelector:_cmd];
+	if (sectionController) {
 		[sectionController tableView:tableView performAction:action forRowAtIndexPath:indexPath withSender:sender];
 	}
 }
@@ -715,14 +1496,14 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 #pragma mark - scroll view delegate
 
 - (void)scrollViewDidScroll:(UIScrollView *)scrollView {
-    id<HRSTableViewSectionController> sectionController = [self.sectionController firstObject];
+    id<HRSTableViewSectionController> sectionController = [_sectionController firstObject];
     if ([sectionController respondsToSelector:_cmd]) {
         [sectionController scrollViewDidScroll:scrollView];
     }
 }
 
 - (void)scrollViewDidZoom:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidZoom:scrollView];
 		}
@@ -730,7 +1511,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewWillBeginDragging:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewWillBeginDragging:scrollView];
 		}
@@ -738,7 +1519,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewWillEndDragging:(UIScrollView *)scrollView withVelocity:(CGPoint)velocity targetContentOffset:(inout CGPoint *)targetContentOffset {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewWillEndDragging:scrollView withVelocity:velocity targetContentOffset:targetContentOffset];
 		}
@@ -746,7 +1527,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidEndDragging:scrollView willDecelerate:decelerate];
 		}
@@ -754,7 +1535,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewWillBeginDecelerating:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewWillBeginDecelerating:scrollView];
 		}
@@ -762,7 +1543,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidEndDecelerating:scrollView];
 		}
@@ -770,7 +1551,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewDidEndScrollingAnimation:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidEndScrollingAnimation:scrollView];
 		}
@@ -778,7 +1559,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (UIView *)viewForZoomingInScrollView:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			UIView *view = [sectionController viewForZoomingInScrollView:scrollView];
 			if (view) {
@@ -790,7 +1571,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewWillBeginZooming:(UIScrollView *)scrollView withView:(UIView *)view {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewWillBeginZooming:scrollView withView:view];
 		}
@@ -798,7 +1579,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewDidEndZooming:(UIScrollView *)scrollView withView:(UIView *)view atScale:(CGFloat)scale {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidEndZooming:scrollView withView:view atScale:scale];
 		}
@@ -806,7 +1587,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (BOOL)scrollViewShouldScrollToTop:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			BOOL shouldScrollToTop = [sectionController scrollViewShouldScrollToTop:scrollView];
 			if (shouldScrollToTop) {
@@ -818,7 +1599,7 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 }
 
 - (void)scrollViewDidScrollToTop:(UIScrollView *)scrollView {
-	for (id<HRSTableViewSectionController> sectionController in self.sectionController) {
+	for (id<HRSTableViewSectionController> sectionController in _sectionController) {
 		if ([sectionController respondsToSelector:_cmd]) {
 			return [sectionController scrollViewDidScrollToTop:scrollView];
 		}
@@ -850,25 +1631,37 @@ static void *const CoordinatorTableViewLink = (void *)&CoordinatorTableViewLink;
 @implementation HRSTableViewSectionCoordinator (IndexPathMapping)
 
 - (NSInteger)controllerSectionForTableViewSection:(NSInteger)tableViewSection withController:(id<HRSTableViewSectionController>)controller {
-	NSInteger sectionOffset = [self.sectionController indexOfObject:controller];
+	NSInteger sectionOffset = [self _sectionOffsetForController:controller beforeTransition:NO];
+	if (sectionOffset == NSNotFound) {
+		return NSNotFound; // the controller has no sections in the table view
+	}
 	NSInteger controllerSection = tableViewSection - sectionOffset;
 	return controllerSection;
 }
 
 - (NSIndexPath *)controllerIndexPathForTableViewIndexPath:(NSIndexPath *)tableViewIndexPath withController:(id<HRSTableViewSectionController>)controller {
 	NSInteger section = [self controllerSectionForTableViewSection:tableViewIndexPath.section withController:controller];
+	if (section == NSNotFound) {
+		return nil;
+	}
 	NSIndexPath *controllerIndexPath = [NSIndexPath indexPathForRow:tableViewIndexPath.row inSection:section];
 	return controllerIndexPath;
 }
 
 - (NSInteger)tableViewSectionForControllerSection:(NSInteger)controllerSection withController:(id<HRSTableViewSectionController>)controller {
-	NSInteger sectionOffset = [self.sectionController indexOfObject:controller];
+	NSInteger sectionOffset = [self _sectionOffsetForController:controller beforeTransition:NO];
+	if (sectionOffset == NSNotFound) {
+		return NSNotFound; // the controller has no sections in the table view
+	}
 	NSInteger tableViewSection = controllerSection + sectionOffset;
 	return tableViewSection;
 }
 
 - (NSIndexPath *)tableViewIndexPathForControllerIndexPath:(NSIndexPath *)controllerIndexPath withController:(id<HRSTableViewSectionController>)controller {
 	NSInteger section = [self tableViewSectionForControllerSection:controllerIndexPath.section withController:controller];
+	if (section == NSNotFound) {
+		return nil;
+	}
 	NSIndexPath *tableViewIndexPath = [NSIndexPath indexPathForRow:controllerIndexPath.row inSection:section];
 	return tableViewIndexPath;
 }
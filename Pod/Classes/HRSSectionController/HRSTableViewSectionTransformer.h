@@ -39,7 +39,7 @@
        in an upcoming release and is only implemented that way for backwards
        compatibility.
  */
-@interface HRSTableViewSectionTransformer : NSObject <UITableViewDelegate, UITableViewDataSource>
+@interface HRSTableViewSectionTransformer : NSObject <UITableViewDelegate, UITableViewDataSource, UITableViewDataSourcePrefetching>
 
 /**
  The coordinator that is linked with the transformer.
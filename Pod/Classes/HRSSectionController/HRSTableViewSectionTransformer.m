@@ -23,7 +23,8 @@
 
 /*
  Because of the dynamic forwarding, we get a warning here, that we did not
- implement necessary methods of UITableViewDelegate and UITableViewDataSource.
+ implement necessary methods of UITableViewDelegate, UITableViewDataSource and
+ UITableViewDataSourcePrefetching.
  This can be ignored as they are all forwarded to the section coordinator anyway.
  */
 #pragma clang diagnostic push
@@ -73,6 +74,10 @@
     HRSSectionControllerTransformer(tableView:commitEditingStyle:forRowAtIndexPath:, 1, 3);
     HRSSectionControllerTransformer(tableView:moveRowAtIndexPath:toIndexPath:, 1, 2, 3);
     
+    // DataSourcePrefetching
+    HRSSectionControllerTransformer(tableView:prefetchRowsAtIndexPaths:, 1, 2);
+    HRSSectionControllerTransformer(tableView:cancelPrefetchingForRowsAtIndexPaths:, 1, 2);
+    
     // Delegate
     HRSSectionControllerTransformer(tableView:willDisplayCell:forRowAtIndexPath:, 1, 3);
     HRSSectionControllerTransformer(tableView:willDisplayHeaderView:forSection:, 1, 3);
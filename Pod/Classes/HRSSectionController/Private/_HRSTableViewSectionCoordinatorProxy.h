@@ -59,6 +59,15 @@
  */
 @property (nonatomic, strong, readwrite) NSArray *sectionControllers;
 
+/**
+ Specifies if the proxy reports the calls it forwards to the instrumentation of
+ the section controller's coordinator.
+ 
+ Only set this on proxies that map from the table view to the section
+ controller. The value is not passed on to the reverse proxy.
+ */
+@property (nonatomic, assign, readwrite, getter=isInstrumented) BOOL instrumented;
+
 /**
  Register a new selector that participates in object mapping.
  
@@ -71,6 +80,15 @@
  `+[HRSTableViewSectionCoordinator registerTransformer:arguments:]` for more
  information about how mapping is configured.
  
+ If the signature of the selector is known, the proxy installs a trampoline for
+ it that maps the arguments and calls the forwarding target directly, without
+ creating an `NSInvocation`. This is possible for all methods whose arguments
+ are objects or integers and whose return value is `void`, an object, an
+ integer or a `CGFloat`. Signatures are looked up in `UITableView` and the
+ table view data source and delegate protocols. All other selectors are mapped
+ through `-forwardInvocation:`; their trampoline is installed the first time
+ they are forwarded.
+ 
  @see +[HRSTableViewSectionCoordinator registerTransformer:arguments:]
  
  @param selector The selector you want to register.
@@ -81,6 +99,10 @@
 /**
  Creates a new proxy that mediates between the controller and the table view.
  
+ The proxy does not retain the table view. The coordinator keeps its proxies
+ for reuse, but just like the coordinator they must not keep the table view
+ alive.
+ 
  @param controller the controller that should be used to map the index paths
  @param tableView  the table view that should be used to map the index paths
  
@@ -107,8 +129,8 @@
  the original behaviour when you call this method on a reversed proxy. It simply
  toggles between the two directions.
  
- @note currently this method creates a new instance of the proxy. Do not count
-	   on this behaviour as this is subject to change due to optimisations!
+ The reverse proxy is created once and reused. Calling this method on the
+ reverse proxy returns the receiver as long as it is alive.
  
  @return a proxy that has the reverse mapping direction than the receiver.
  */
@@ -18,28 +18,598 @@
 #import "HRSTableViewSectionCoordinator.h"
 #import "HRSTableViewSectionCoordinator+IndexPathMapping.h"
 
+#import "_HRSTableViewSectionCoordinatorUpdates.h"
+
+#import <mach/mach_time.h>
+#import <objc/message.h>
+#import <objc/runtime.h>
+
+
+/// the table view updates a coordinator can collect instead of forwarding them
+typedef NS_ENUM(NSUInteger, _HRSTableViewSectionCoordinatorProxyUpdate) {
+	_HRSTableViewSectionCoordinatorProxyUpdateNone,
+	_HRSTableViewSectionCoordinatorProxyUpdateInsertSections,
+	_HRSTableViewSectionCoordinatorProxyUpdateDeleteSections,
+	_HRSTableViewSectionCoordinatorProxyUpdateReloadSections,
+	_HRSTableViewSectionCoordinatorProxyUpdateMoveSection,
+	_HRSTableViewSectionCoordinatorProxyUpdateInsertRows,
+	_HRSTableViewSectionCoordinatorProxyUpdateDeleteRows,
+	_HRSTableViewSectionCoordinatorProxyUpdateReloadRows,
+	_HRSTableViewSectionCoordinatorProxyUpdateMoveRow
+};
+
+/**
+ The precompiled mapping information of a selector that is dispatched through a
+ trampoline. Arguments are numbered like in the transformer registration, so
+ bit 0 represents the return value and bit 1 the first argument.
+ */
+typedef struct {
+	NSUInteger argumentCount;
+	NSUInteger objectMapping;
+	NSUInteger sectionMapping;
+	NSUInteger rowHeightInvalidation;
+	BOOL changesNumberOfSections;
+	BOOL appliesPendingUpdates;
+	_HRSTableViewSectionCoordinatorProxyUpdate update;
+} _HRSTableViewSectionCoordinatorProxyTrampoline;
+
+/// the cached row heights a table view update invalidates
+typedef NS_ENUM(NSUInteger, _HRSTableViewSectionCoordinatorProxyRowHeightInvalidation) {
+	_HRSTableViewSectionCoordinatorProxyRowHeightInvalidationNone,
+	_HRSTableViewSectionCoordinatorProxyRowHeightInvalidationRows, // the index paths of the first argument
+	_HRSTableViewSectionCoordinatorProxyRowHeightInvalidationController // all rows of the section controller
+};
+
+/// the kind of return value a trampoline handles
+typedef NS_ENUM(NSUInteger, _HRSTableViewSectionCoordinatorProxyReturnKind) {
+	_HRSTableViewSectionCoordinatorProxyReturnKindUnsupported,
+	_HRSTableViewSectionCoordinatorProxyReturnKindVoid,
+	_HRSTableViewSectionCoordinatorProxyReturnKindWord,
+	_HRSTableViewSectionCoordinatorProxyReturnKindFloat
+};
+
+/// the maximum number of arguments a trampoline can handle
+static NSUInteger const _HRSTableViewSectionCoordinatorProxyMaximumArgumentCount = 4;
+
+// both dictionaries are keyed by selector, the transformer dictionary holds the
+// registered index sets, the trampoline dictionary the compiled mappings
+static CFMutableDictionaryRef transformer;
+static CFMutableDictionaryRef trampolines;
+
+
+@interface HRSTableViewSectionCoordinator (Private)
+
+- (NSArray *)oldSectionController;
+- (NSInteger)_sectionOffsetForController:(id<HRSTableViewSectionController>)controller beforeTransition:(BOOL)beforeTransition;
+- (NSInteger)_numberOfSectionsForController:(id<HRSTableViewSectionController>)controller;
+- (_HRSTableViewSectionCoordinatorUpdates *)pendingUpdates;
+- (_HRSTableViewSectionCoordinatorUpdates *)_tableViewUpdatesToCollect;
+- (void)_discardPendingTableViewUpdates;
+- (BOOL)_isSectionControllerHidden:(id<HRSTableViewSectionController>)controller;
+- (void)_beginTableViewCallback;
+- (void)_endTableViewCallback;
+- (BOOL)_isHandlingTableViewCallback;
+
+@end
+
 
 @interface _HRSTableViewSectionCoordinatorProxy () {
 	_HRSTableViewSectionCoordinatorProxy *_reverseProxy;
+	// the proxy that created the receiver as its reverse proxy; it is not
+	// retained to avoid a retain cycle between both proxies
+	__weak _HRSTableViewSectionCoordinatorProxy *_originProxy;
+	// the nesting of beginUpdates and endUpdates calls that were collected
+	// instead of being forwarded
+	NSUInteger _updateDepth;
+@public
+	// read by the trampolines, which are plain functions
+	BOOL _instrumented;
+	BOOL _reverseProxying;
 }
 
 @property (nonatomic, assign, readwrite) BOOL reverseProxying;
 @property (nonatomic, strong, readwrite) id<HRSTableViewSectionController> controller;
-@property (nonatomic, strong, readwrite) UITableView *tableView;
+@property (nonatomic, weak, readwrite) UITableView *tableView; /// not retained, because the coordinator keeps its proxies
+
+- (id)forwardingTarget;
+- (id)_mappedObject:(id)object isReturnValue:(BOOL)reverse;
+- (NSInteger)_controllerSection;
+- (NSInteger)_mappedSection:(NSInteger)section isReturnValue:(BOOL)reverse;
+- (void)_invalidateRowHeightsForObject:(id)object invalidation:(_HRSTableViewSectionCoordinatorProxyRowHeightInvalidation)invalidation;
+- (void)_invalidateNumberOfSections;
+- (BOOL)_collectsUpdates;
+- (BOOL)_collectUpdate:(_HRSTableViewSectionCoordinatorProxyUpdate)update arguments:(const uintptr_t *)arguments;
+- (void)_applyPendingUpdates;
+- (void)_beginCallback;
+- (void)_endCallback;
+- (void)_reportCallWithSelector:(SEL)selector duration:(uint64_t)duration;
 
 @end
 
 
+#pragma mark - trampolines
+
+static void _HRSTableViewSectionCoordinatorProxyReleaseTrampoline(CFAllocatorRef allocator, const void *value) {
+	free((void *)value);
+}
+
+/**
+ Looks up the signature of a selector in `UITableView` and the table view
+ related protocols without needing an instance of a forwarding target.
+ */
+static NSMethodSignature *_HRSTableViewSectionCoordinatorProxyKnownSignature(SEL selector) {
+	Method method = class_getInstanceMethod([UITableView class], selector);
+	if (method) {
+		return [NSMethodSignature signatureWithObjCTypes:method_getTypeEncoding(method)];
+	}
+	
+	Protocol *protocols[] = { @protocol(UITableViewDataSource), @protocol(UITableViewDataSourcePrefetching), @protocol(UITableViewDelegate), @protocol(UIScrollViewDelegate) };
+	for (NSUInteger index = 0; index < sizeof(protocols) / sizeof(protocols[0]); index++) {
+		for (NSUInteger required = 0; required < 2; required++) {
+			struct objc_method_description description = protocol_getMethodDescription(protocols[index], selector, (BOOL)required, YES);
+			if (description.types) {
+				return [NSMethodSignature signatureWithObjCTypes:description.types];
+			}
+		}
+	}
+	return nil;
+}
+
+static const char *_HRSTableViewSectionCoordinatorProxySkipQualifiers(const char *type) {
+	while (*type != '\0' && strchr("rnNoORV", *type) != NULL) {
+		type++;
+	}
+	return type;
+}
+
+/// Specifies if a value of the given type is passed in a general purpose register.
+static BOOL _HRSTableViewSectionCoordinatorProxyIsWordType(const char *type) {
+	type = _HRSTableViewSectionCoordinatorProxySkipQualifiers(type);
+	switch (*type) {
+		case '@': case '#': case ':': case '*': case '^':
+		case 'c': case 'C': case 's': case 'S': case 'i': case 'I': case 'l': case 'L': case 'B':
+			return YES;
+		case 'q': case 'Q':
+			return (sizeof(long long) <= sizeof(uintptr_t));
+		default:
+			return NO;
+	}
+}
+
+static _HRSTableViewSectionCoordinatorProxyReturnKind _HRSTableViewSectionCoordinatorProxyReturnKindForType(const char *type) {
+	if (*_HRSTableViewSectionCoordinatorProxySkipQualifiers(type) == 'v') {
+		return _HRSTableViewSectionCoordinatorProxyReturnKindVoid;
+	} else if (_HRSTableViewSectionCoordinatorProxyIsWordType(type)) {
+		return _HRSTableViewSectionCoordinatorProxyReturnKindWord;
+	} else if (strcmp(type, @encode(CGFloat)) == 0) {
+		return _HRSTableViewSectionCoordinatorProxyReturnKindFloat;
+	}
+	return _HRSTableViewSectionCoordinatorProxyReturnKindUnsupported;
+}
+
+/**
+ Maps the arguments of a trampoline call in place.
+ 
+ Table view updates the coordinator collects are not mapped. They are only
+ collected for `void` selectors, so only void trampolines need to check for it.
+ 
+ @param proxy         The proxy that received the call.
+ @param selector      The selector of the call.
+ @param arguments     The arguments of the call, starting at index 1.
+ @param mappedObjects A list that keeps the mapped objects alive during the call.
+ 
+ @return The compiled mapping of the selector or NULL if the call was collected
+         and must not be forwarded.
+ */
+static const _HRSTableViewSectionCoordinatorProxyTrampoline *_HRSTableViewSectionCoordinatorProxyMapArguments(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t *arguments, id __strong *mappedObjects) {
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = CFDictionaryGetValue(trampolines, selector);
+	// the update is collected before the number of sections is invalidated, so
+	// that the collected updates know the sections before the update
+	BOOL collected = NO;
+	if (trampoline->update != _HRSTableViewSectionCoordinatorProxyUpdateNone) {
+		collected = [proxy _collectUpdate:trampoline->update arguments:arguments];
+	} else if (trampoline->appliesPendingUpdates) {
+		[proxy _applyPendingUpdates];
+	}
+	if (trampoline->rowHeightInvalidation != _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationNone) {
+		[proxy _invalidateRowHeightsForObject:(__bridge id)(void *)arguments[1] invalidation:trampoline->rowHeightInvalidation];
+	}
+	if (trampoline->changesNumberOfSections) {
+		[proxy _invalidateNumberOfSections];
+	}
+	if (collected) {
+		return NULL;
+	}
+	for (NSUInteger index = 1; index <= trampoline->argumentCount; index++) {
+		if (trampoline->objectMapping & (1 << index)) {
+			mappedObjects[index] = [proxy _mappedObject:(__bridge id)(void *)arguments[index] isReturnValue:NO];
+			arguments[index] = (uintptr_t)(__bridge void *)mappedObjects[index];
+		} else if (trampoline->sectionMapping & (1 << index)) {
+			arguments[index] = (uintptr_t)[proxy _mappedSection:(NSInteger)arguments[index] isReturnValue:NO];
+		}
+	}
+	return trampoline;
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyMapReturnValue(_HRSTableViewSectionCoordinatorProxy *proxy, const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline, uintptr_t value) {
+	if (trampoline->objectMapping & 1) {
+		__autoreleasing id mappedObject = [proxy _mappedObject:(__bridge id)(void *)value isReturnValue:YES];
+		return (uintptr_t)(__bridge void *)mappedObject;
+	} else if (trampoline->sectionMapping & 1) {
+		return (uintptr_t)[proxy _mappedSection:(NSInteger)value isReturnValue:YES];
+	}
+	return value;
+}
+
+/// Returns the start time of a forwarded call if the proxy is instrumented.
+/// Calls of a reverse proxy are table view callbacks, which are reported to
+/// the coordinator.
+static inline uint64_t _HRSTableViewSectionCoordinatorProxyBeginCall(_HRSTableViewSectionCoordinatorProxy *proxy) {
+	if (proxy->_reverseProxying) {
+		[proxy _beginCallback];
+	}
+	return (proxy->_instrumented ? mach_absolute_time() : 0);
+}
+
+static inline void _HRSTableViewSectionCoordinatorProxyEndCall(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uint64_t start) {
+	if (proxy->_instrumented) {
+		[proxy _reportCallWithSelector:selector duration:mach_absolute_time() - start];
+	}
+	if (proxy->_reverseProxying) {
+		[proxy _endCallback];
+	}
+}
+
+#if defined(__i386__)
+	#define _HRSTableViewSectionCoordinatorProxySendFloat objc_msgSend_fpret
+#else
+	#define _HRSTableViewSectionCoordinatorProxySendFloat objc_msgSend
+#endif
+
+static void _HRSTableViewSectionCoordinatorProxyVoidTrampoline0(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector) {
+	uintptr_t arguments[] = { 0 };
+	__strong id mappedObjects[1];
+	if (_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects) == NULL) {
+		return;
+	}
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	((void (*)(id, SEL))objc_msgSend)([proxy forwardingTarget], selector);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+}
+
+static void _HRSTableViewSectionCoordinatorProxyVoidTrampoline1(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1) {
+	uintptr_t arguments[] = { 0, a1 };
+	__strong id mappedObjects[2];
+	if (_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects) == NULL) {
+		return;
+	}
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	((void (*)(id, SEL, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+}
+
+static void _HRSTableViewSectionCoordinatorProxyVoidTrampoline2(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2) {
+	uintptr_t arguments[] = { 0, a1, a2 };
+	__strong id mappedObjects[3];
+	if (_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects) == NULL) {
+		return;
+	}
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	((void (*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+}
+
+static void _HRSTableViewSectionCoordinatorProxyVoidTrampoline3(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3) {
+	uintptr_t arguments[] = { 0, a1, a2, a3 };
+	__strong id mappedObjects[4];
+	if (_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects) == NULL) {
+		return;
+	}
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	((void (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+}
+
+static void _HRSTableViewSectionCoordinatorProxyVoidTrampoline4(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4) {
+	uintptr_t arguments[] = { 0, a1, a2, a3, a4 };
+	__strong id mappedObjects[5];
+	if (_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects) == NULL) {
+		return;
+	}
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	((void (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3], arguments[4]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyWordTrampoline0(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector) {
+	uintptr_t arguments[] = { 0 };
+	__strong id mappedObjects[1];
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = _HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	uintptr_t value = ((uintptr_t (*)(id, SEL))objc_msgSend)([proxy forwardingTarget], selector);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return _HRSTableViewSectionCoordinatorProxyMapReturnValue(proxy, trampoline, value);
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyWordTrampoline1(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1) {
+	uintptr_t arguments[] = { 0, a1 };
+	__strong id mappedObjects[2];
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = _HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	uintptr_t value = ((uintptr_t (*)(id, SEL, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return _HRSTableViewSectionCoordinatorProxyMapReturnValue(proxy, trampoline, value);
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyWordTrampoline2(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2) {
+	uintptr_t arguments[] = { 0, a1, a2 };
+	__strong id mappedObjects[3];
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = _HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	uintptr_t value = ((uintptr_t (*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return _HRSTableViewSectionCoordinatorProxyMapReturnValue(proxy, trampoline, value);
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyWordTrampoline3(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3) {
+	uintptr_t arguments[] = { 0, a1, a2, a3 };
+	__strong id mappedObjects[4];
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = _HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	uintptr_t value = ((uintptr_t (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return _HRSTableViewSectionCoordinatorProxyMapReturnValue(proxy, trampoline, value);
+}
+
+static uintptr_t _HRSTableViewSectionCoordinatorProxyWordTrampoline4(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4) {
+	uintptr_t arguments[] = { 0, a1, a2, a3, a4 };
+	__strong id mappedObjects[5];
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = _HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	uintptr_t value = ((uintptr_t (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3], arguments[4]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return _HRSTableViewSectionCoordinatorProxyMapReturnValue(proxy, trampoline, value);
+}
+
+static CGFloat _HRSTableViewSectionCoordinatorProxyFloatTrampoline0(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector) {
+	uintptr_t arguments[] = { 0 };
+	__strong id mappedObjects[1];
+	_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	CGFloat value = ((CGFloat (*)(id, SEL))_HRSTableViewSectionCoordinatorProxySendFloat)([proxy forwardingTarget], selector);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return value;
+}
+
+static CGFloat _HRSTableViewSectionCoordinatorProxyFloatTrampoline1(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1) {
+	uintptr_t arguments[] = { 0, a1 };
+	__strong id mappedObjects[2];
+	_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	CGFloat value = ((CGFloat (*)(id, SEL, uintptr_t))_HRSTableViewSectionCoordinatorProxySendFloat)([proxy forwardingTarget], selector, arguments[1]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return value;
+}
+
+static CGFloat _HRSTableViewSectionCoordinatorProxyFloatTrampoline2(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2) {
+	uintptr_t arguments[] = { 0, a1, a2 };
+	__strong id mappedObjects[3];
+	_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	CGFloat value = ((CGFloat (*)(id, SEL, uintptr_t, uintptr_t))_HRSTableViewSectionCoordinatorProxySendFloat)([proxy forwardingTarget], selector, arguments[1], arguments[2]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return value;
+}
+
+static CGFloat _HRSTableViewSectionCoordinatorProxyFloatTrampoline3(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3) {
+	uintptr_t arguments[] = { 0, a1, a2, a3 };
+	__strong id mappedObjects[4];
+	_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	CGFloat value = ((CGFloat (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))_HRSTableViewSectionCoordinatorProxySendFloat)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return value;
+}
+
+static CGFloat _HRSTableViewSectionCoordinatorProxyFloatTrampoline4(_HRSTableViewSectionCoordinatorProxy *proxy, SEL selector, uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4) {
+	uintptr_t arguments[] = { 0, a1, a2, a3, a4 };
+	__strong id mappedObjects[5];
+	_HRSTableViewSectionCoordinatorProxyMapArguments(proxy, selector, arguments, mappedObjects);
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(proxy);
+	CGFloat value = ((CGFloat (*)(id, SEL, uintptr_t, uintptr_t, uintptr_t, uintptr_t))_HRSTableViewSectionCoordinatorProxySendFloat)([proxy forwardingTarget], selector, arguments[1], arguments[2], arguments[3], arguments[4]);
+	_HRSTableViewSectionCoordinatorProxyEndCall(proxy, selector, start);
+	return value;
+}
+
+static IMP _HRSTableViewSectionCoordinatorProxyTrampolineImplementation(_HRSTableViewSectionCoordinatorProxyReturnKind returnKind, NSUInteger argumentCount) {
+	static IMP const voidTrampolines[] = { (IMP)_HRSTableViewSectionCoordinatorProxyVoidTrampoline0, (IMP)_HRSTableViewSectionCoordinatorProxyVoidTrampoline1, (IMP)_HRSTableViewSectionCoordinatorProxyVoidTrampoline2, (IMP)_HRSTableViewSectionCoordinatorProxyVoidTrampoline3, (IMP)_HRSTableViewSectionCoordinatorProxyVoidTrampoline4 };
+	static IMP const wordTrampolines[] = { (IMP)_HRSTableViewSectionCoordinatorProxyWordTrampoline0, (IMP)_HRSTableViewSectionCoordinatorProxyWordTrampoline1, (IMP)_HRSTableViewSectionCoordinatorProxyWordTrampoline2, (IMP)_HRSTableViewSectionCoordinatorProxyWordTrampoline3, (IMP)_HRSTableViewSectionCoordinatorProxyWordTrampoline4 };
+	static IMP const floatTrampolines[] = { (IMP)_HRSTableViewSectionCoordinatorProxyFloatTrampoline0, (IMP)_HRSTableViewSectionCoordinatorProxyFloatTrampoline1, (IMP)_HRSTableViewSectionCoordinatorProxyFloatTrampoline2, (IMP)_HRSTableViewSectionCoordinatorProxyFloatTrampoline3, (IMP)_HRSTableViewSectionCoordinatorProxyFloatTrampoline4 };
+	
+	if (argumentCount > _HRSTableViewSectionCoordinatorProxyMaximumArgumentCount) {
+		return NULL;
+	}
+	switch (returnKind) {
+		case _HRSTableViewSectionCoordinatorProxyReturnKindVoid:
+			return voidTrampolines[argumentCount];
+		case _HRSTableViewSectionCoordinatorProxyReturnKindWord:
+			return wordTrampolines[argumentCount];
+		case _HRSTableViewSectionCoordinatorProxyReturnKindFloat:
+			return floatTrampolines[argumentCount];
+		case _HRSTableViewSectionCoordinatorProxyReturnKindUnsupported:
+			return NULL;
+	}
+}
+
+
+
 @implementation _HRSTableViewSectionCoordinatorProxy
 
-static NSMutableDictionary *transformer;
 + (void)registerSelector:(SEL)selector arguments:(NSIndexSet *)indexSet {
 	static dispatch_once_t onceToken;
 	dispatch_once(&onceToken, ^{
-		transformer = [NSMutableDictionary dictionary];
+		CFDictionaryValueCallBacks trampolineCallBacks = { 0, NULL, _HRSTableViewSectionCoordinatorProxyReleaseTrampoline, NULL, NULL };
+		transformer = CFDictionaryCreateMutable(NULL, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+		trampolines = CFDictionaryCreateMutable(NULL, 0, NULL, &trampolineCallBacks);
 	});
 	
-	transformer[NSStringFromSelector(selector)] = [indexSet copy];
+	CFDictionarySetValue(transformer, selector, (__bridge void *)[indexSet copy]);
+	
+	// a selector that is registered again keeps its trampoline, only the
+	// mapping is compiled again
+	Method method = class_getInstanceMethod(self, selector);
+	NSMethodSignature *signature;
+	if (method && CFDictionaryContainsKey(trampolines, selector)) {
+		signature = [NSMethodSignature signatureWithObjCTypes:method_getTypeEncoding(method)];
+	} else {
+		signature = _HRSTableViewSectionCoordinatorProxyKnownSignature(selector);
+	}
+	
+	if (signature) {
+		[self compileTrampolineForSelector:selector signature:signature];
+	} else {
+		CFDictionaryRemoveValue(trampolines, selector);
+	}
+}
+
+/**
+ Installs a trampoline for a registered selector on the proxy class, so that
+ calls to this selector no longer go through `-forwardInvocation:`.
+ 
+ A trampoline can be compiled if all arguments fit into a general purpose
+ register (objects, integers and pointers) and the return value is either
+ `void`, such a value or a `CGFloat`. All other selectors keep using
+ `-forwardInvocation:`. The result is remembered in both cases, so that every
+ selector is only compiled once.
+ 
+ @param selector  The registered selector.
+ @param signature The method signature of the selector.
+ */
++ (void)compileTrampolineForSelector:(SEL)selector signature:(NSMethodSignature *)signature {
+	NSIndexSet *indexSet = (__bridge NSIndexSet *)CFDictionaryGetValue(transformer, selector);
+	if (indexSet == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = malloc(sizeof(_HRSTableViewSectionCoordinatorProxyTrampoline));
+	IMP implementation = [self trampolineImplementationForSignature:signature arguments:indexSet trampoline:trampoline];
+	if (implementation == NULL) {
+		trampoline->argumentCount = NSNotFound;
+	}
+	trampoline->rowHeightInvalidation = [self rowHeightInvalidationForSelector:selector];
+	trampoline->changesNumberOfSections = (selector == @selector(insertSections:withRowAnimation:) || selector == @selector(deleteSections:withRowAnimation:));
+	trampoline->appliesPendingUpdates = [self appliesPendingUpdatesForSelector:selector];
+	trampoline->update = (signature.methodReturnType[0] == 'v' ? [self updateForSelector:selector] : _HRSTableViewSectionCoordinatorProxyUpdateNone);
+	CFDictionarySetValue(trampolines, selector, trampoline);
+	
+	if (implementation) {
+		NSMutableString *types = [NSMutableString stringWithUTF8String:signature.methodReturnType];
+		for (NSUInteger argument = 0; argument < signature.numberOfArguments; argument++) {
+			[types appendFormat:@"%s", [signature getArgumentTypeAtIndex:argument]];
+		}
+		class_replaceMethod(self, selector, implementation, types.UTF8String);
+	}
+}
+
+/**
+ Returns which cached row heights a call to the given selector invalidates.
+ 
+ Reloading rows only invalidates these rows, all other updates may shift the
+ rows of the section controller and invalidate all of its rows.
+ 
+ @param selector The registered selector.
+ 
+ @return The kind of invalidation.
+ */
++ (_HRSTableViewSectionCoordinatorProxyRowHeightInvalidation)rowHeightInvalidationForSelector:(SEL)selector {
+	if (selector == @selector(reloadRowsAtIndexPaths:withRowAnimation:)) {
+		return _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationRows;
+	}
+	
+	SEL invalidatingSelectors[] = {
+		@selector(reloadSections:withRowAnimation:), @selector(insertSections:withRowAnimation:), @selector(deleteSections:withRowAnimation:), @selector(moveSection:toSection:),
+		@selector(insertRowsAtIndexPaths:withRowAnimation:), @selector(deleteRowsAtIndexPaths:withRowAnimation:), @selector(moveRowAtIndexPath:toIndexPath:)
+	};
+	for (NSUInteger index = 0; index < sizeof(invalidatingSelectors) / sizeof(invalidatingSelectors[0]); index++) {
+		if (selector == invalidatingSelectors[index]) {
+			return _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationController;
+		}
+	}
+	return _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationNone;
+}
+
+/**
+ Returns which table view update a call to the given selector is.
+ 
+ @param selector The registered selector.
+ 
+ @return The kind of update.
+ */
++ (_HRSTableViewSectionCoordinatorProxyUpdate)updateForSelector:(SEL)selector {
+	// in the order of _HRSTableViewSectionCoordinatorProxyUpdate
+	SEL updateSelectors[] = {
+		@selector(insertSections:withRowAnimation:), @selector(deleteSections:withRowAnimation:), @selector(reloadSections:withRowAnimation:), @selector(moveSection:toSection:),
+		@selector(insertRowsAtIndexPaths:withRowAnimation:), @selector(deleteRowsAtIndexPaths:withRowAnimation:), @selector(reloadRowsAtIndexPaths:withRowAnimation:), @selector(moveRowAtIndexPath:toIndexPath:)
+	};
+	for (NSUInteger index = 0; index < sizeof(updateSelectors) / sizeof(updateSelectors[0]); index++) {
+		if (selector == updateSelectors[index]) {
+			return (_HRSTableViewSectionCoordinatorProxyUpdate)(index + 1);
+		}
+	}
+	return _HRSTableViewSectionCoordinatorProxyUpdateNone;
+}
+
+/**
+ Returns if a call to the given selector applies the pending table view
+ updates before it is forwarded.
+ 
+ Dequeuing a cell or header footer view does not depend on the rows of the
+ table view, and it is usually called while the table view asks for a cell,
+ where applying updates is not allowed.
+ 
+ @param selector The registered selector.
+ 
+ @return YES if the pending updates are applied, otherwise NO.
+ */
++ (BOOL)appliesPendingUpdatesForSelector:(SEL)selector {
+	return (selector != @selector(dequeueReusableCellWithIdentifier:forIndexPath:) && selector != @selector(dequeueReusableCellWithIdentifier:) && selector != @selector(dequeueReusableHeaderFooterViewWithIdentifier:));
+}
+
++ (IMP)trampolineImplementationForSignature:(NSMethodSignature *)signature arguments:(NSIndexSet *)indexSet trampoline:(_HRSTableViewSectionCoordinatorProxyTrampoline *)trampoline {
+	NSUInteger argumentCount = signature.numberOfArguments - 2;
+	if (argumentCount > _HRSTableViewSectionCoordinatorProxyMaximumArgumentCount) {
+		return NULL;
+	}
+	
+	trampoline->argumentCount = argumentCount;
+	trampoline->objectMapping = 0;
+	trampoline->sectionMapping = 0;
+	
+	for (NSUInteger index = 1; index <= argumentCount; index++) {
+		const char *argumentType = [signature getArgumentTypeAtIndex:index + 1];
+		if (_HRSTableViewSectionCoordinatorProxyIsWordType(argumentType) == NO) {
+			return NULL;
+		}
+		if ([indexSet containsIndex:index] == NO) {
+			continue;
+		}
+		if (strcmp(argumentType, @encode(id)) == 0) {
+			trampoline->objectMapping |= (1 << index);
+		} else if (strcmp(argumentType, @encode(NSInteger)) == 0) {
+			trampoline->sectionMapping |= (1 << index);
+		}
+	}
+	
+	const char *returnType = signature.methodReturnType;
+	if ([indexSet containsIndex:0]) {
+		if (strcmp(returnType, @encode(id)) == 0) {
+			trampoline->objectMapping |= 1;
+		} else if (strcmp(returnType, @encode(NSInteger)) == 0) {
+			trampoline->sectionMapping |= 1;
+		}
+	}
+	
+	return _HRSTableViewSectionCoordinatorProxyTrampolineImplementation(_HRSTableViewSectionCoordinatorProxyReturnKindForType(returnType), argumentCount);
 }
 
 + (instancetype)proxyWithController:(id<HRSTableViewSectionController>)controller tableView:(UITableView *)tableView {
@@ -52,13 +622,14 @@ static NSMutableDictionary *transformer;
 }
 
 - (instancetype)reverseProxy {
-	// TODO: There should be some sort of hierarchy so that calling reverseProxy twice returns the initial object!
-	if (_reverseProxy == nil) {
-		_HRSTableViewSectionCoordinatorProxy *copy = [[_HRSTableViewSectionCoordinatorProxy alloc] initWithController:self.controller tableView:self.tableView];
-		copy.reverseProxying = !self.reverseProxying;
-		_reverseProxy = copy;
+	_HRSTableViewSectionCoordinatorProxy *reverseProxy = (_reverseProxy ?: _originProxy);
+	if (reverseProxy == nil) {
+		reverseProxy = [[_HRSTableViewSectionCoordinatorProxy alloc] initWithController:self.controller tableView:self.tableView];
+		reverseProxy.reverseProxying = !self.reverseProxying;
+		reverseProxy->_originProxy = self;
+		_reverseProxy = reverseProxy;
 	}
-	return _reverseProxy;
+	return reverseProxy;
 }
 
 - (instancetype)initWithController:(id<HRSTableViewSectionController>)controller tableView:(UITableView *)tableView {
@@ -84,6 +655,44 @@ static NSMutableDictionary *transformer;
 
 #pragma mark - forwarding
 
+- (NSInteger)numberOfSections {
+	// a table view proxy only contains the sections of its section controller
+	if (self.reverseProxying) {
+		return [(UITableView *)[self forwardingTarget] numberOfSections];
+	}
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	return (coordinator ? [coordinator _numberOfSectionsForController:self.controller] : [self.tableView numberOfSections]);
+}
+
+- (void)beginUpdates {
+	// collected updates are applied in a single batch by the coordinator, the
+	// updates inside the block are marked when they are collected
+	if ([self _collectsUpdates]) {
+		_updateDepth++;
+		return;
+	}
+	[(UITableView *)[self forwardingTarget] beginUpdates];
+}
+
+- (void)endUpdates {
+	if (_updateDepth > 0) {
+		_updateDepth--;
+		if (_updateDepth == 0) {
+			[self.controller.coordinator.pendingUpdates endUpdatesOfSectionController:self.controller];
+		}
+		return;
+	}
+	[(UITableView *)[self forwardingTarget] endUpdates];
+}
+
+- (void)reloadData {
+	// reloading the table view includes all collected updates
+	if (self.reverseProxying == NO) {
+		[self.controller.coordinator _discardPendingTableViewUpdates];
+	}
+	[(UITableView *)[self forwardingTarget] reloadData];
+}
+
 - (BOOL)respondsToSelector:(SEL)aSelector {
 	return [[self forwardingTarget] respondsToSelector:aSelector];
 }
@@ -93,7 +702,7 @@ static NSMutableDictionary *transformer;
 }
 
 - (id)forwardingTargetForSelector:(SEL)selector {
-	if (transformer[NSStringFromSelector(selector)] == nil) {
+	if (transformer == NULL || CFDictionaryContainsKey(transformer, selector) == NO) {
 		return [self forwardingTarget];
 	} else {
 		return self;
@@ -110,14 +719,10 @@ static NSMutableDictionary *transformer;
 	if ([object isKindOfClass:[NSIndexPath class]]) {
         NSIndexPath *indexPath = object;
 		NSIndexPath *mappedIndexPath;
-		if (reverseLogic) {
-            mappedIndexPath = [NSIndexPath indexPathForRow:indexPath.row inSection:0];
-			
-		} else {
-            NSInteger section = [self.sectionControllers indexOfObject:self.controller];
-            if (section != NSNotFound) {
-                mappedIndexPath = [NSIndexPath indexPathForRow:indexPath.row inSection:section];
-            }
+		NSInteger sectionOffset = [self _controllerSection];
+		if (sectionOffset != NSNotFound) {
+			NSInteger section = (reverseLogic ? indexPath.section - sectionOffset : indexPath.section + sectionOffset);
+			mappedIndexPath = [NSIndexPath indexPathForRow:indexPath.row inSection:section];
 		}
 		return mappedIndexPath;
 		
@@ -137,9 +742,20 @@ static NSMutableDictionary *transformer;
 		}
 		
 	} else if ([object isKindOfClass:[NSArray class]]) {
+		// index paths are the most common elements (e.g. visible rows), so the
+		// section offset is looked up once for the complete array
+		NSInteger sectionOffset = [self _controllerSection];
+		
 		NSMutableArray *array = [NSMutableArray arrayWithCapacity:[object count]];
 		for (id element in object) {
-			[array addObject:[self _mappedObject:element isReturnValue:reverse]];
+			if ([element isKindOfClass:[NSIndexPath class]]) {
+				if (sectionOffset != NSNotFound) {
+					NSInteger section = (reverseLogic ? [element section] - sectionOffset : [element section] + sectionOffset);
+					[array addObject:[NSIndexPath indexPathForRow:[element row] inSection:section]];
+				}
+			} else {
+				[array addObject:[self _mappedObject:element isReturnValue:reverse]];
+			}
 		}
 		
 		return [array copy];
@@ -151,21 +767,150 @@ static NSMutableDictionary *transformer;
 	return nil;
 }
 
+- (NSInteger)_controllerSection {
+	// the coordinator keeps a table of all section offsets, so the list of
+	// section controllers only needs to be searched if it is foreign to the
+	// coordinator
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	if (_sectionControllers == nil) {
+		return (coordinator ? [coordinator _sectionOffsetForController:self.controller beforeTransition:NO] : NSNotFound);
+	} else if (coordinator && _sectionControllers == coordinator.oldSectionController) {
+		return [coordinator _sectionOffsetForController:self.controller beforeTransition:YES];
+	} else {
+		return [_sectionControllers indexOfObjectIdenticalTo:self.controller];
+	}
+}
+
 - (NSInteger)_mappedSection:(NSInteger)section isReturnValue:(BOOL)reverse {
 	BOOL reverseLogic = reverse ^ self.reverseProxying;
 	
-	NSInteger mappedSection = 0;
-	if (reverseLogic) {
-		mappedSection = [self.controller.coordinator controllerSectionForTableViewSection:section withController:self.controller];
+	// a section controller may cover several sections, so sections are shifted
+	// by the first section of the controller in both directions
+	NSInteger sectionOffset = [self _controllerSection];
+	if (sectionOffset == NSNotFound) {
+		return NSNotFound;
+	}
+	return (reverseLogic ? section - sectionOffset : section + sectionOffset);
+}
+
+- (void)_invalidateRowHeightsForObject:(id)object invalidation:(_HRSTableViewSectionCoordinatorProxyRowHeightInvalidation)invalidation {
+	// only updates from the section controller to the table view change rows
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	if (self.reverseProxying || coordinator.rowHeightCacheEnabled == NO) {
+		return;
+	}
+	
+	if (invalidation == _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationRows && [object isKindOfClass:[NSArray class]]) {
+		for (NSIndexPath *indexPath in object) {
+			[coordinator invalidateRowHeightAtIndexPath:indexPath forSectionController:self.controller];
+		}
 	} else {
-		mappedSection = [self.controller.coordinator tableViewSectionForControllerSection:section withController:self.controller];
+		[coordinator invalidateRowHeightsForSectionController:self.controller];
+	}
+}
+
+- (void)_invalidateNumberOfSections {
+	// only updates from the section controller to the table view change sections
+	if (self.reverseProxying) {
+		return;
 	}
-	return mappedSection;
+	[self.controller.coordinator invalidateNumberOfSectionsForSectionController:self.controller];
+}
+
+- (BOOL)_collectsUpdates {
+	return (self.reverseProxying == NO && self.controller.coordinator.updateCoalescingEnabled);
+}
+
+- (BOOL)_collectUpdate:(_HRSTableViewSectionCoordinatorProxyUpdate)update arguments:(const uintptr_t *)arguments {
+	// only updates from the section controller to the table view are collected
+	if (self.reverseProxying) {
+		return NO;
+	}
+	// the sections of a hidden section controller are not part of the table
+	// view, so its updates are dropped as if they were collected
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	if ([coordinator _isSectionControllerHidden:self.controller]) {
+		return YES;
+	}
+	_HRSTableViewSectionCoordinatorUpdates *updates = [coordinator _tableViewUpdatesToCollect];
+	if (updates == nil) {
+		return NO;
+	}
+	
+	id<HRSTableViewSectionController> controller = self.controller;
+	if (_updateDepth > 0) {
+		// the updates might have been applied since the block began
+		[updates beginUpdatesOfSectionController:controller];
+	}
+	switch (update) {
+		case _HRSTableViewSectionCoordinatorProxyUpdateInsertSections:
+			[updates insertSections:(__bridge NSIndexSet *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateDeleteSections:
+			[updates deleteSections:(__bridge NSIndexSet *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateReloadSections:
+			[updates reloadSections:(__bridge NSIndexSet *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateMoveSection:
+			[updates moveSection:(NSInteger)arguments[1] toSection:(NSInteger)arguments[2] ofSectionController:controller];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateInsertRows:
+			[updates insertRowsAtIndexPaths:(__bridge NSArray *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateDeleteRows:
+			[updates deleteRowsAtIndexPaths:(__bridge NSArray *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateReloadRows:
+			[updates reloadRowsAtIndexPaths:(__bridge NSArray *)(void *)arguments[1] ofSectionController:controller withRowAnimation:(UITableViewRowAnimation)arguments[2]];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateMoveRow:
+			[updates moveRowAtIndexPath:(__bridge NSIndexPath *)(void *)arguments[1] toIndexPath:(__bridge NSIndexPath *)(void *)arguments[2] ofSectionController:controller];
+			break;
+		case _HRSTableViewSectionCoordinatorProxyUpdateNone:
+			return NO;
+	}
+	return YES;
+}
+
+- (void)_applyPendingUpdates {
+	// every other call of a section controller to its table view has to see
+	// the updates it made before, except inside of an update block, where the
+	// table view does not apply any update before the block ends either
+	if (self.reverseProxying || _updateDepth > 0) {
+		return;
+	}
+	// the table view must not be updated while it asks for its content, the
+	// updates are applied at the end of the run loop turn instead
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	if ([coordinator _isHandlingTableViewCallback]) {
+		return;
+	}
+	[coordinator applyPendingTableViewUpdates];
+}
+
+- (void)_beginCallback {
+	[self.controller.coordinator _beginTableViewCallback];
+}
+
+- (void)_endCallback {
+	[self.controller.coordinator _endTableViewCallback];
+}
+
+- (void)_reportCallWithSelector:(SEL)selector duration:(uint64_t)duration {
+	static mach_timebase_info_data_t timebase;
+	if (timebase.denom == 0) {
+		mach_timebase_info(&timebase);
+	}
+	
+	HRSTableViewSectionCoordinator *coordinator = self.controller.coordinator;
+	NSTimeInterval seconds = (NSTimeInterval)duration * timebase.numer / timebase.denom / NSEC_PER_SEC;
+	[coordinator.instrumentation sectionCoordinator:coordinator didCallSelector:selector onSectionController:self.controller duration:seconds];
 }
 
 - (void)forwardInvocation:(NSInvocation *)invocation {
-	NSString *selectorKey = NSStringFromSelector(invocation.selector);
-	if (transformer[selectorKey] == nil) {
+	NSIndexSet *mappingList = (transformer ? (__bridge NSIndexSet *)CFDictionaryGetValue(transformer, invocation.selector) : nil);
+	if (mappingList == nil) {
 		[invocation setTarget:[self forwardingTarget]];
 		[invocation invoke];
 		return;
@@ -176,7 +921,34 @@ static NSMutableDictionary *transformer;
 	// check for mapping arguments
 	NSMethodSignature *signature = [invocation methodSignature];
 	NSUInteger argc = [signature numberOfArguments];
-	NSIndexSet *mappingList = transformer[selectorKey];
+	
+	// selectors that are unknown at registration time, e.g. methods of a table
+	// view subclass, are compiled the first time they are used
+	if (CFDictionaryContainsKey(trampolines, invocation.selector) == NO) {
+		[[self class] compileTrampolineForSelector:invocation.selector signature:signature];
+	}
+	const _HRSTableViewSectionCoordinatorProxyTrampoline *trampoline = CFDictionaryGetValue(trampolines, invocation.selector);
+	BOOL collected = NO;
+	if (trampoline && trampoline->update != _HRSTableViewSectionCoordinatorProxyUpdateNone) {
+		// all updates take two arguments that fit into a register
+		uintptr_t arguments[3] = { 0 };
+		[invocation getArgument:&arguments[1] atIndex:2];
+		[invocation getArgument:&arguments[2] atIndex:3];
+		collected = [self _collectUpdate:trampoline->update arguments:arguments];
+	} else if (trampoline == NULL || trampoline->appliesPendingUpdates) {
+		[self _applyPendingUpdates];
+	}
+	if (trampoline && trampoline->rowHeightInvalidation != _HRSTableViewSectionCoordinatorProxyRowHeightInvalidationNone && argc > 2) {
+		__unsafe_unretained id argument;
+		[invocation getArgument:&argument atIndex:2];
+		[self _invalidateRowHeightsForObject:argument invalidation:trampoline->rowHeightInvalidation];
+	}
+	if (trampoline && trampoline->changesNumberOfSections) {
+		[self _invalidateNumberOfSections];
+	}
+	if (collected) {
+		return;
+	}
 	[mappingList enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
 		NSAssert(idx < argc, @"Given index out of range. This is most likely a configuration issue of the transformer!");
 		if (idx >= argc) {
@@ -209,7 +981,9 @@ static NSMutableDictionary *transformer;
 	}];
 	
 	[invocation setTarget:[self forwardingTarget]];
+	uint64_t start = _HRSTableViewSectionCoordinatorProxyBeginCall(self);
 	[invocation invoke];
+	_HRSTableViewSectionCoordinatorProxyEndCall(self, invocation.selector, start);
 	
 	if ([mappingList containsIndex:0]) {
 		// map return value
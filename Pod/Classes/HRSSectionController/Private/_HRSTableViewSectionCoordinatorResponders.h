@@ -0,0 +1,83 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+/**
+ A responder table answers which section controllers of a list implement the
+ methods of the table view data source, the table view prefetching data source,
+ the table view delegate and the scroll view delegate protocols.
+ 
+ The table is computed once for a list of section controllers, so that the
+ coordinator does not have to ask every section controller for every callback.
+ The answers for the protocol methods are cached per class as long as the class
+ does not override `respondsToSelector:`. Section controllers that override it
+ are asked once per table instead.
+ 
+ Selectors that do not belong to one of the protocols are not cached and are
+ answered by asking the section controllers directly.
+ */
+@interface _HRSTableViewSectionCoordinatorResponders : NSObject
+
+/**
+ Creates a responder table for the given section controllers.
+ 
+ @param sectionControllers the list of section controllers, the position of a
+                           controller in the list is its index
+ 
+ @return an initialized responder table
+ */
+- (instancetype)initWithSectionControllers:(NSArray *)sectionControllers NS_DESIGNATED_INITIALIZER;
+
+// unavailable:
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns whether the selector belongs to one of the protocols that are cached by
+ a responder table.
+ 
+ @param selector the selector to check
+ 
+ @return YES if the answers for the selector are cached, NO otherwise
+ */
++ (BOOL)isProtocolSelector:(SEL)selector;
+
+/**
+ Returns whether at least one of the section controllers implements the given
+ selector.
+ 
+ @param selector the selector to check
+ 
+ @return YES if any section controller responds to the selector, NO otherwise
+ */
+- (BOOL)anySectionControllerRespondsToSelector:(SEL)selector;
+
+/**
+ Returns whether the section controller at the given index implements the
+ given selector.
+ 
+ @note A section controller may cover more than one section of the table view,
+       so map a section to the index of its controller first.
+ 
+ @param index    the index of the section controller
+ @param selector the selector to check
+ 
+ @return YES if the section controller responds to the selector, NO if it does
+         not or if there is no section controller at the index
+ */
+- (BOOL)sectionControllerAtIndex:(NSInteger)index respondsToSelector:(SEL)selector;
+
+@end
@@ -0,0 +1,180 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+
+#import "_HRSTableViewSectionCoordinatorResponders.h"
+
+#import <UIKit/UIKit.h>
+#import <objc/runtime.h>
+
+
+// selector -> index of the selector in the bit vectors
+static CFMutableDictionaryRef selectorIndexes;
+static NSUInteger selectorCount;
+
+// class -> bit vector of the protocol selectors its instances respond to
+static CFMutableDictionaryRef classResponders;
+
+
+@interface _HRSTableViewSectionCoordinatorResponders () {
+	// bit (selector index * number of controllers + controller index) is set
+	// if the controller at this index responds to the selector
+	CFMutableBitVectorRef _responders;
+	// bit (selector index) is set if any controller responds to the selector
+	CFMutableBitVectorRef _anyResponders;
+}
+
+@property (nonatomic, copy, readwrite) NSArray *sectionControllers;
+
+@end
+
+
+
+@implementation _HRSTableViewSectionCoordinatorResponders
+
++ (void)initialize {
+	if (self != [_HRSTableViewSectionCoordinatorResponders class]) {
+		return;
+	}
+	
+	selectorIndexes = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+	classResponders = CFDictionaryCreateMutable(NULL, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+	
+	Protocol *protocols[] = { @protocol(UITableViewDataSource), @protocol(UITableViewDataSourcePrefetching), @protocol(UITableViewDelegate), @protocol(UIScrollViewDelegate) };
+	for (NSUInteger index = 0; index < sizeof(protocols) / sizeof(protocols[0]); index++) {
+		for (NSUInteger required = 0; required < 2; required++) {
+			unsigned int count = 0;
+			struct objc_method_description *descriptions = protocol_copyMethodDescriptionList(protocols[index], (BOOL)required, YES, &count);
+			for (unsigned int description = 0; description < count; description++) {
+				SEL selector = descriptions[description].name;
+				if (CFDictionaryContainsKey(selectorIndexes, selector) == NO) {
+					CFDictionarySetValue(selectorIndexes, selector, (const void *)selectorCount);
+					selectorCount++;
+				}
+			}
+			free(descriptions);
+		}
+	}
+}
+
++ (NSUInteger)indexOfSelector:(SEL)selector {
+	const void *index = NULL;
+	if (selector == NULL || CFDictionaryGetValueIfPresent(selectorIndexes, selector, &index) == NO) {
+		return NSNotFound;
+	}
+	return (NSUInteger)index;
+}
+
++ (BOOL)isProtocolSelector:(SEL)selector {
+	return ([self indexOfSelector:selector] != NSNotFound);
+}
+
+/// Returns the protocol selectors the given section controller responds to.
++ (CFBitVectorRef)respondersForSectionController:(id)controller {
+	// the answer only depends on the class as long as the class does not decide
+	// dynamically, which is true for everything that uses the default
+	// implementation of respondsToSelector:
+	Class controllerClass = object_getClass(controller);
+	BOOL cacheable = (class_getMethodImplementation(controllerClass, @selector(respondsToSelector:)) == class_getMethodImplementation([NSObject class], @selector(respondsToSelector:)));
+	if (cacheable) {
+		CFBitVectorRef responders = CFDictionaryGetValue(classResponders, (__bridge const void *)controllerClass);
+		if (responders) {
+			return responders;
+		}
+	}
+	
+	CFMutableBitVectorRef responders = CFBitVectorCreateMutable(NULL, selectorCount);
+	CFBitVectorSetCount(responders, selectorCount);
+	CFIndex count = CFDictionaryGetCount(selectorIndexes);
+	const void **selectors = malloc(MAX(count, 1) * sizeof(void *));
+	const void **indexes = malloc(MAX(count, 1) * sizeof(void *));
+	CFDictionaryGetKeysAndValues(selectorIndexes, selectors, indexes);
+	for (CFIndex index = 0; index < count; index++) {
+		if ([controller respondsToSelector:(SEL)selectors[index]]) {
+			CFBitVectorSetBitAtIndex(responders, (CFIndex)indexes[index], 1);
+		}
+	}
+	free(indexes);
+	free(selectors);
+	
+	if (cacheable) {
+		CFDictionarySetValue(classResponders, (__bridge const void *)controllerClass, responders);
+	}
+	return (CFBitVectorRef)CFAutorelease(responders);
+}
+
+- (instancetype)initWithSectionControllers:(NSArray *)sectionControllers {
+	self = [super init];
+	if (self) {
+		_sectionControllers = [sectionControllers copy];
+		
+		NSUInteger controllerCount = _sectionControllers.count;
+		_responders = CFBitVectorCreateMutable(NULL, selectorCount * controllerCount);
+		CFBitVectorSetCount(_responders, selectorCount * controllerCount);
+		_anyResponders = CFBitVectorCreateMutable(NULL, selectorCount);
+		CFBitVectorSetCount(_anyResponders, selectorCount);
+		
+		for (NSUInteger index = 0; index < controllerCount; index++) {
+			CFBitVectorRef responders = [[self class] respondersForSectionController:_sectionControllers[index]];
+			for (NSUInteger selector = 0; selector < selectorCount; selector++) {
+				if (CFBitVectorGetBitAtIndex(responders, selector)) {
+					CFBitVectorSetBitAtIndex(_responders, selector * controllerCount + index, 1);
+					CFBitVectorSetBitAtIndex(_anyResponders, selector, 1);
+				}
+			}
+		}
+	}
+	return self;
+}
+
+- (instancetype)init {
+	return [self initWithSectionControllers:nil];
+}
+
+- (void)dealloc {
+	CFRelease(_anyResponders);
+	CFRelease(_responders);
+}
+
+
+
+#pragma mark - lookup
+
+- (BOOL)anySectionControllerRespondsToSelector:(SEL)selector {
+	NSUInteger selectorIndex = [[self class] indexOfSelector:selector];
+	if (selectorIndex == NSNotFound) {
+		for (id controller in self.sectionControllers) {
+			if ([controller respondsToSelector:selector]) {
+				return YES;
+			}
+		}
+		return NO;
+	}
+	return (CFBitVectorGetBitAtIndex(_anyResponders, selectorIndex) != 0);
+}
+
+- (BOOL)sectionControllerAtIndex:(NSInteger)index respondsToSelector:(SEL)selector {
+	NSUInteger controllerCount = self.sectionControllers.count;
+	if (index < 0 || (NSUInteger)index >= controllerCount) {
+		return NO;
+	}
+	
+	NSUInteger selectorIndex = [[self class] indexOfSelector:selector];
+	if (selectorIndex == NSNotFound) {
+		return [self.sectionControllers[index] respondsToSelector:selector];
+	}
+	return (CFBitVectorGetBitAtIndex(_responders, selectorIndex * controllerCount + index) != 0);
+}
+
+@end
@@ -0,0 +1,117 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+
+@protocol HRSTableViewSectionController;
+
+
+/**
+ A section table maps the sections of a table view to the section controllers
+ of a list and back.
+ 
+ Every section controller covers a run of consecutive sections. The table keeps
+ the first section of every controller as a prefix sum of the section counts,
+ so that the controller of a table view section is found by binary search and
+ the first section of a controller is found in constant time by identity.
+ 
+ A section table is immutable. Changing the number of sections of a controller
+ creates a new table, so that a table can be shared between the current and the
+ old section controllers of a transition.
+ */
+@interface _HRSTableViewSectionCoordinatorSections : NSObject
+
+/**
+ Creates a section table for the given section controllers.
+ 
+ @param sectionControllers the list of section controllers
+ @param numberOfSections   a block that returns the number of sections of a
+                           section controller, negative values are treated
+                           as 0
+ 
+ @return an initialized section table
+ */
+- (instancetype)initWithSectionControllers:(NSArray *)sectionControllers numberOfSections:(NSInteger(^)(id<HRSTableViewSectionController> controller))numberOfSections NS_DESIGNATED_INITIALIZER;
+
+// unavailable:
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Returns a copy of the receiver in which the section controller at the given
+ index covers the given number of sections. The sections of all following
+ controllers are shifted accordingly.
+ 
+ @param numberOfSections the new number of sections of the controller
+ @param index            the index of the controller in `sectionControllers`
+ 
+ @return a new section table
+ */
+- (instancetype)sectionsBySettingNumberOfSections:(NSInteger)numberOfSections ofSectionControllerAtIndex:(NSUInteger)index;
+
+/// The list of section controllers.
+@property (nonatomic, copy, readonly) NSArray *sectionControllers;
+
+/// The number of sections of all section controllers together.
+@property (nonatomic, assign, readonly) NSInteger numberOfSections;
+
+/**
+ Returns the index of the given section controller in `sectionControllers`.
+ 
+ @param controller the section controller to look up, compared by identity
+ 
+ @return the index of the controller or NSNotFound if it is not in the table
+ */
+- (NSInteger)indexOfSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Returns the index of the section controller that covers the given section.
+ 
+ @param section a section of the table view
+ 
+ @return the index of the controller in `sectionControllers` or NSNotFound if
+         the section is out of bounds
+ */
+- (NSInteger)indexOfSectionControllerForSection:(NSInteger)section;
+
+/**
+ Returns the first table view section of the section controller at the given
+ index.
+ 
+ @param index the index of the controller in `sectionControllers`
+ 
+ @return the first section of the controller
+ */
+- (NSInteger)firstSectionOfSectionControllerAtIndex:(NSUInteger)index;
+
+/**
+ Returns the number of sections of the section controller at the given index.
+ 
+ @param index the index of the controller in `sectionControllers`
+ 
+ @return the number of sections of the controller
+ */
+- (NSInteger)numberOfSectionsOfSectionControllerAtIndex:(NSUInteger)index;
+
+/**
+ Returns the first table view section of the given section controller.
+ 
+ @param controller the section controller to look up, compared by identity
+ 
+ @return the first section of the controller or NSNotFound if it is not in the
+         table
+ */
+- (NSInteger)firstSectionOfSectionController:(id<HRSTableViewSectionController>)controller;
+
+@end
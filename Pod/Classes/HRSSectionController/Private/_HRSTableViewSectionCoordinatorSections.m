@@ -0,0 +1,134 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import "_HRSTableViewSectionCoordinatorSections.h"
+
+#import "HRSTableViewSectionController.h"
+
+
+@interface _HRSTableViewSectionCoordinatorSections () {
+	// _firstSections[index] is the first section of the controller at index,
+	// the list has one additional element that holds the number of sections
+	NSInteger *_firstSections;
+	// controller -> index of the controller in `sectionControllers`; the table
+	// compares by identity and does not retain the controllers
+	CFMutableDictionaryRef _indexes;
+}
+
+@property (nonatomic, copy, readwrite) NSArray *sectionControllers;
+
+@end
+
+
+
+@implementation _HRSTableViewSectionCoordinatorSections
+
+- (instancetype)initWithSectionControllers:(NSArray *)sectionControllers numberOfSections:(NSInteger(^)(id<HRSTableViewSectionController> controller))numberOfSections {
+	self = [super init];
+	if (self) {
+		_sectionControllers = [sectionControllers copy];
+		
+		NSUInteger controllerCount = _sectionControllers.count;
+		_firstSections = malloc((controllerCount + 1) * sizeof(NSInteger));
+		_indexes = CFDictionaryCreateMutable(NULL, controllerCount, NULL, NULL);
+		
+		NSInteger section = 0;
+		for (NSUInteger index = 0; index < controllerCount; index++) {
+			id<HRSTableViewSectionController> controller = _sectionControllers[index];
+			CFDictionarySetValue(_indexes, (__bridge const void *)controller, (const void *)index);
+			_firstSections[index] = section;
+			section += (numberOfSections ? MAX(numberOfSections(controller), 0) : 1);
+		}
+		_firstSections[controllerCount] = section;
+	}
+	return self;
+}
+
+- (instancetype)init {
+	return [self initWithSectionControllers:nil numberOfSections:nil];
+}
+
+- (void)dealloc {
+	free(_firstSections);
+	CFRelease(_indexes);
+}
+
+- (instancetype)sectionsBySettingNumberOfSections:(NSInteger)numberOfSections ofSectionControllerAtIndex:(NSUInteger)index {
+	NSParameterAssert(index < self.sectionControllers.count);
+	if (index >= self.sectionControllers.count) {
+		return self;
+	}
+	
+	return [[[self class] alloc] initWithSectionControllers:self.sectionControllers numberOfSections:^NSInteger(id<HRSTableViewSectionController> controller) {
+		NSUInteger controllerIndex = (NSUInteger)[self indexOfSectionController:controller];
+		return (controllerIndex == index ? numberOfSections : [self numberOfSectionsOfSectionControllerAtIndex:controllerIndex]);
+	}];
+}
+
+
+
+#pragma mark - lookup
+
+- (NSInteger)numberOfSections {
+	return _firstSections[self.sectionControllers.count];
+}
+
+- (NSInteger)indexOfSectionController:(id<HRSTableViewSectionController>)controller {
+	const void *index = NULL;
+	if (controller == nil || CFDictionaryGetValueIfPresent(_indexes, (__bridge const void *)controller, &index) == NO) {
+		return NSNotFound;
+	}
+	return (NSInteger)index;
+}
+
+- (NSInteger)indexOfSectionControllerForSection:(NSInteger)section {
+	NSUInteger controllerCount = self.sectionControllers.count;
+	if (section < 0 || section >= _firstSections[controllerCount]) {
+		return NSNotFound;
+	}
+	
+	// find the last controller that starts at or before the section, this skips
+	// controllers without sections
+	NSUInteger low = 0;
+	NSUInteger high = controllerCount;
+	while (low < high) {
+		NSUInteger middle = low + (high - low) / 2;
+		if (_firstSections[middle + 1] <= section) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return (NSInteger)low;
+}
+
+- (NSInteger)firstSectionOfSectionControllerAtIndex:(NSUInteger)index {
+	NSParameterAssert(index < self.sectionControllers.count);
+	return _firstSections[index];
+}
+
+- (NSInteger)numberOfSectionsOfSectionControllerAtIndex:(NSUInteger)index {
+	NSParameterAssert(index < self.sectionControllers.count);
+	return _firstSections[index + 1] - _firstSections[index];
+}
+
+- (NSInteger)firstSectionOfSectionController:(id<HRSTableViewSectionController>)controller {
+	NSInteger index = [self indexOfSectionController:controller];
+	if (index == NSNotFound) {
+		return NSNotFound;
+	}
+	return _firstSections[index];
+}
+
+@end
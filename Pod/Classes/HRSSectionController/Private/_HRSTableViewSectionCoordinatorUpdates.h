@@ -0,0 +1,170 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+
+
+@class _HRSTableViewSectionCoordinatorSections;
+
+@protocol HRSTableViewSectionController;
+
+
+/**
+ An update list collects the table view updates section controllers send to
+ their table view proxies, so that they can be applied to the table view in a
+ single batch.
+ 
+ Section controllers send their updates one after another, so every update is
+ based on the rows after the previous one. In a batch, deleted and reloaded
+ rows are based on the rows before the batch and inserted rows on the rows
+ after it. The list rebases the updates of every section controller in its own
+ space when they are added. Updates that cannot be rebased, e.g. deleting a
+ row that was inserted before or moving a row together with other updates,
+ make the list reload all sections of the section controller instead.
+ 
+ Updates a section controller sends between `beginUpdates` and `endUpdates`
+ already form a batch, so they are not rebased on each other, only on the
+ updates the section controller sent before the block.
+ 
+ Sections of different section controllers do not interfere with each other,
+ so they are only mapped to the table view when the list is applied: updates
+ based on the rows before the batch use the section table of the first update,
+ all others the current section table.
+ */
+@interface _HRSTableViewSectionCoordinatorUpdates : NSObject
+
+/**
+ Creates an empty update list.
+ 
+ @param sections the section table before the first update
+ 
+ @return an initialized update list
+ */
+- (instancetype)initWithSections:(_HRSTableViewSectionCoordinatorSections *)sections NS_DESIGNATED_INITIALIZER;
+
+// unavailable:
+- (instancetype)init NS_UNAVAILABLE;
+
+/// The section table before the first update.
+@property (nonatomic, strong, readonly) _HRSTableViewSectionCoordinatorSections *sections;
+
+/// Specifies if no update was added to the list.
+@property (nonatomic, assign, readonly, getter=isEmpty) BOOL empty;
+
+/**
+ Marks the following updates of a section controller as a single batch, like
+ the updates between `beginUpdates` and `endUpdates` of a table view.
+ 
+ Calling this method again before the updates ended has no effect.
+ 
+ @param controller the section controller that began its updates
+ */
+- (void)beginUpdatesOfSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Ends the batch of a section controller that was started by
+ `beginUpdatesOfSectionController:`. Following updates are based on the
+ previous update again.
+ 
+ @param controller the section controller that ended its updates
+ */
+- (void)endUpdatesOfSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Adds inserted sections of a section controller.
+ 
+ All updates of a section controller are applied with the animation of its
+ last update.
+ 
+ @param sections   the inserted sections in the space of the controller
+ @param controller the section controller that inserted the sections
+ @param animation  the animation of the update
+ */
+- (void)insertSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds deleted sections of a section controller.
+ 
+ @param sections   the deleted sections in the space of the controller
+ @param controller the section controller that deleted the sections
+ @param animation  the animation of the update
+ */
+- (void)deleteSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds reloaded sections of a section controller.
+ 
+ @param sections   the reloaded sections in the space of the controller
+ @param controller the section controller that reloaded the sections
+ @param animation  the animation of the update
+ */
+- (void)reloadSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds a moved section of a section controller.
+ 
+ @param section    the section before the move in the space of the controller
+ @param newSection the section after the move in the space of the controller
+ @param controller the section controller that moved the section
+ */
+- (void)moveSection:(NSInteger)section toSection:(NSInteger)newSection ofSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Adds inserted rows of a section controller.
+ 
+ @param indexPaths the inserted rows in the space of the controller
+ @param controller the section controller that inserted the rows
+ @param animation  the animation of the update
+ */
+- (void)insertRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds deleted rows of a section controller.
+ 
+ @param indexPaths the deleted rows in the space of the controller
+ @param controller the section controller that deleted the rows
+ @param animation  the animation of the update
+ */
+- (void)deleteRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds reloaded rows of a section controller.
+ 
+ @param indexPaths the reloaded rows in the space of the controller
+ @param controller the section controller that reloaded the rows
+ @param animation  the animation of the update
+ */
+- (void)reloadRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation;
+
+/**
+ Adds a moved row of a section controller.
+ 
+ @param indexPath    the row before the move in the space of the controller
+ @param newIndexPath the row after the move in the space of the controller
+ @param controller   the section controller that moved the row
+ */
+- (void)moveRowAtIndexPath:(NSIndexPath *)indexPath toIndexPath:(NSIndexPath *)newIndexPath ofSectionController:(id<HRSTableViewSectionController>)controller;
+
+/**
+ Sends all updates to the given table view.
+ 
+ This does not begin or end the updates of the table view. Updates of section
+ controllers that are not part of both section tables are dropped.
+ 
+ @param tableView the table view to update
+ @param sections  the section table after the last update
+ */
+- (void)applyToTableView:(UITableView *)tableView sections:(_HRSTableViewSectionCoordinatorSections *)sections;
+
+@end
@@ -0,0 +1,533 @@
+//
+//	Licensed under the Apache License, Version 2.0 (the "License");
+//	you may not use this file except in compliance with the License.
+//	You may obtain a copy of the License at
+//
+//	http://www.apache.org/licenses/LICENSE-2.0
+//
+//	Unless required by applicable law or agreed to in writing, software
+//	distributed under the License is distributed on an "AS IS" BASIS,
+//	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//	See the License for the specific language governing permissions and
+//	limitations under the License.
+//
+
+#import "_HRSTableViewSectionCoordinatorUpdates.h"
+
+#import "HRSTableViewSectionController.h"
+
+#import "_HRSTableViewSectionCoordinatorSections.h"
+
+
+/// The collected updates of a single section controller, in its own space.
+@interface _HRSTableViewSectionCoordinatorControllerUpdates : NSObject
+
+@property (nonatomic, assign, readwrite) BOOL needsReload; /// the updates could not be rebased, all sections are reloaded instead
+@property (nonatomic, assign, readwrite) UITableViewRowAnimation animation;
+
+@property (nonatomic, strong, readonly) NSMutableIndexSet *deletedSections; /// based on the sections before the batch
+@property (nonatomic, strong, readonly) NSMutableIndexSet *reloadedSections; /// based on the sections before the batch
+@property (nonatomic, strong, readonly) NSMutableIndexSet *insertedSections; /// based on the sections after the batch
+@property (nonatomic, strong, readonly) NSMutableDictionary *deletedRows; /// section -> rows before the batch
+@property (nonatomic, strong, readonly) NSMutableDictionary *reloadedRows; /// section -> rows before the batch
+@property (nonatomic, strong, readonly) NSMutableDictionary *insertedRows; /// section -> rows after the batch
+
+@property (nonatomic, strong, readwrite) NSIndexPath *movedRow; /// a move is only kept if it is the only update
+@property (nonatomic, strong, readwrite) NSIndexPath *movedRowDestination;
+@property (nonatomic, assign, readwrite) BOOL movesSection; /// the move is a moved section, stored in the sections of the index paths
+@property (nonatomic, assign, readonly, getter=isInBlock) BOOL inBlock; /// the updates are added between beginUpdates and endUpdates of the controller
+
+// the deleted and inserted indexes when the current update block began, nil
+// outside of a block; updates inside a block are based on these indexes
+@property (nonatomic, copy, readwrite) NSIndexSet *deletedSectionsBeforeBlock;
+@property (nonatomic, copy, readwrite) NSIndexSet *insertedSectionsBeforeBlock;
+@property (nonatomic, copy, readwrite) NSDictionary *deletedRowsBeforeBlock;
+@property (nonatomic, copy, readwrite) NSDictionary *insertedRowsBeforeBlock;
+
+@end
+
+
+@implementation _HRSTableViewSectionCoordinatorControllerUpdates
+
+- (instancetype)init {
+	self = [super init];
+	if (self) {
+		_deletedSections = [NSMutableIndexSet indexSet];
+		_reloadedSections = [NSMutableIndexSet indexSet];
+		_insertedSections = [NSMutableIndexSet indexSet];
+		_deletedRows = [NSMutableDictionary dictionary];
+		_reloadedRows = [NSMutableDictionary dictionary];
+		_insertedRows = [NSMutableDictionary dictionary];
+		_animation = UITableViewRowAnimationAutomatic;
+	}
+	return self;
+}
+
+- (BOOL)hasMove {
+	return (self.movedRow != nil);
+}
+
+- (BOOL)hasSectionStructureUpdates {
+	return (self.deletedSections.count > 0 || self.insertedSections.count > 0);
+}
+
+- (BOOL)hasRowUpdates {
+	return (self.deletedRows.count > 0 || self.reloadedRows.count > 0 || self.insertedRows.count > 0);
+}
+
+- (BOOL)hasUpdates {
+	return (self.needsReload || self.hasMove || self.hasSectionStructureUpdates || self.hasRowUpdates || self.reloadedSections.count > 0);
+}
+
+- (void)reload {
+	self.needsReload = YES;
+	self.movesSection = NO;
+	self.movedRow = nil;
+	self.movedRowDestination = nil;
+	[self.deletedSections removeAllIndexes];
+	[self.reloadedSections removeAllIndexes];
+	[self.insertedSections removeAllIndexes];
+	[self.deletedRows removeAllObjects];
+	[self.reloadedRows removeAllObjects];
+	[self.insertedRows removeAllObjects];
+}
+
+- (BOOL)isInBlock {
+	return (self.deletedSectionsBeforeBlock != nil);
+}
+
+- (void)beginBlock {
+	if (self.inBlock) {
+		return;
+	}
+	self.deletedSectionsBeforeBlock = self.deletedSections;
+	self.insertedSectionsBeforeBlock = self.insertedSections;
+	self.deletedRowsBeforeBlock = [[NSDictionary alloc] initWithDictionary:self.deletedRows copyItems:YES];
+	self.insertedRowsBeforeBlock = [[NSDictionary alloc] initWithDictionary:self.insertedRows copyItems:YES];
+}
+
+- (void)endBlock {
+	self.deletedSectionsBeforeBlock = nil;
+	self.insertedSectionsBeforeBlock = nil;
+	self.deletedRowsBeforeBlock = nil;
+	self.insertedRowsBeforeBlock = nil;
+}
+
+/// The deleted sections the next update is based on.
+- (NSIndexSet *)baseDeletedSections {
+	return (self.inBlock ? self.deletedSectionsBeforeBlock : self.deletedSections);
+}
+
+- (NSIndexSet *)baseInsertedSections {
+	return (self.inBlock ? self.insertedSectionsBeforeBlock : self.insertedSections);
+}
+
+- (NSIndexSet *)baseDeletedRowsInSection:(NSNumber *)section {
+	return (self.inBlock ? self.deletedRowsBeforeBlock[section] : self.deletedRows[section]);
+}
+
+- (NSIndexSet *)baseInsertedRowsInSection:(NSNumber *)section {
+	return (self.inBlock ? self.insertedRowsBeforeBlock[section] : self.insertedRows[section]);
+}
+
+- (void)dropRowsInSections:(NSIndexSet *)sections {
+	[sections enumerateIndexesUsingBlock:^(NSUInteger section, BOOL *stop) {
+		[self.deletedRows removeObjectForKey:@(section)];
+		[self.reloadedRows removeObjectForKey:@(section)];
+		[self.insertedRows removeObjectForKey:@(section)];
+	}];
+}
+
+@end
+
+
+
+/**
+ Returns the index before the batch of an index that is based on the previous
+ updates, as long as only indexes were deleted so far.
+ 
+ @param index   the index after the previous updates
+ @param deleted the indexes deleted so far, based on the indexes before the batch
+ 
+ @return the index before the batch
+ */
+static NSUInteger _HRSTableViewSectionCoordinatorUpdatesIndexBeforeDeletes(NSUInteger index, NSIndexSet *deleted) {
+	__block NSUInteger oldIndex = index;
+	[deleted enumerateIndexesUsingBlock:^(NSUInteger deletedIndex, BOOL *stop) {
+		if (deletedIndex <= oldIndex) {
+			oldIndex++;
+		} else {
+			*stop = YES;
+		}
+	}];
+	return oldIndex;
+}
+
+static NSIndexSet *_HRSTableViewSectionCoordinatorUpdatesIndexesBeforeDeletes(NSIndexSet *indexes, NSIndexSet *deleted) {
+	NSMutableIndexSet *oldIndexes = [NSMutableIndexSet indexSet];
+	[indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+		[oldIndexes addIndex:_HRSTableViewSectionCoordinatorUpdatesIndexBeforeDeletes(index, deleted)];
+	}];
+	return oldIndexes;
+}
+
+/// Adds inserted indexes that are based on the previous updates and moves the
+/// indexes inserted so far behind them.
+static void _HRSTableViewSectionCoordinatorUpdatesInsertIndexes(NSMutableIndexSet *inserted, NSIndexSet *indexes) {
+	[indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+		[inserted shiftIndexesStartingAtIndex:index by:1];
+		[inserted addIndex:index];
+	}];
+}
+
+/// Groups index paths by section, the rows of every section are an index set.
+static NSDictionary *_HRSTableViewSectionCoordinatorUpdatesRowsBySection(NSArray *indexPaths) {
+	NSMutableDictionary *rowsBySection = [NSMutableDictionary dictionary];
+	for (NSIndexPath *indexPath in indexPaths) {
+		NSMutableIndexSet *rows = rowsBySection[@(indexPath.section)];
+		if (rows == nil) {
+			rows = [NSMutableIndexSet indexSet];
+			rowsBySection[@(indexPath.section)] = rows;
+		}
+		[rows addIndex:indexPath.row];
+	}
+	return rowsBySection;
+}
+
+static NSArray *_HRSTableViewSectionCoordinatorUpdatesIndexPaths(NSDictionary *rowsBySection, NSInteger sectionOffset) {
+	NSMutableArray *indexPaths = [NSMutableArray array];
+	for (NSNumber *section in [rowsBySection.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+		[rowsBySection[section] enumerateIndexesUsingBlock:^(NSUInteger row, BOOL *stop) {
+			[indexPaths addObject:[NSIndexPath indexPathForRow:row inSection:section.integerValue + sectionOffset]];
+		}];
+	}
+	return indexPaths;
+}
+
+static NSIndexSet *_HRSTableViewSectionCoordinatorUpdatesShiftedIndexes(NSIndexSet *indexes, NSInteger offset) {
+	NSMutableIndexSet *shiftedIndexes = [indexes mutableCopy];
+	[shiftedIndexes shiftIndexesStartingAtIndex:0 by:offset];
+	return shiftedIndexes;
+}
+
+
+
+@interface _HRSTableViewSectionCoordinatorUpdates ()
+
+@property (nonatomic, strong, readwrite) _HRSTableViewSectionCoordinatorSections *sections;
+@property (nonatomic, strong, readwrite) NSMapTable *controllerUpdates; /// controller -> _HRSTableViewSectionCoordinatorControllerUpdates
+
+@end
+
+
+
+@implementation _HRSTableViewSectionCoordinatorUpdates
+
+- (instancetype)initWithSections:(_HRSTableViewSectionCoordinatorSections *)sections {
+	self = [super init];
+	if (self) {
+		_sections = sections;
+		_controllerUpdates = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+	}
+	return self;
+}
+
+- (instancetype)init {
+	return [self initWithSections:nil];
+}
+
+- (BOOL)isEmpty {
+	return (self.controllerUpdates.count == 0);
+}
+
+- (_HRSTableViewSectionCoordinatorControllerUpdates *)_updatesOfSectionController:(id<HRSTableViewSectionController>)controller animation:(UITableViewRowAnimation)animation {
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self.controllerUpdates objectForKey:controller];
+	if (updates == nil) {
+		updates = [_HRSTableViewSectionCoordinatorControllerUpdates new];
+		[self.controllerUpdates setObject:updates forKey:controller];
+	}
+	updates.animation = animation;
+	return updates;
+}
+
+- (void)beginUpdatesOfSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self.controllerUpdates objectForKey:controller];
+	if (updates == nil) {
+		updates = [_HRSTableViewSectionCoordinatorControllerUpdates new];
+		[self.controllerUpdates setObject:updates forKey:controller];
+	}
+	[updates beginBlock];
+}
+
+- (void)endUpdatesOfSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	
+	[[self.controllerUpdates objectForKey:controller] endBlock];
+}
+
+
+
+#pragma mark - sections
+
+- (void)insertSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	NSParameterAssert(controller);
+	if (sections == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self _updatesOfSectionController:controller animation:animation];
+	if (updates.needsReload) {
+		return;
+	} else if (updates.hasMove || updates.hasRowUpdates) {
+		[updates reload];
+		return;
+	}
+	if (updates.inBlock == NO) {
+		_HRSTableViewSectionCoordinatorUpdatesInsertIndexes(updates.insertedSections, sections);
+	} else if (updates.baseInsertedSections.count > 0) {
+		// the sections inserted before the block would have to be moved behind
+		// all sections inserted by the block
+		[updates reload];
+	} else {
+		// inside a block, all inserted sections are based on the sections after it
+		[updates.insertedSections addIndexes:sections];
+	}
+}
+
+- (void)deleteSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	NSParameterAssert(controller);
+	if (sections == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self _updatesOfSectionController:controller animation:animation];
+	if (updates.needsReload) {
+		return;
+	} else if (updates.hasMove || updates.hasRowUpdates || updates.baseInsertedSections.count > 0) {
+		// the deleted sections might have been inserted before
+		[updates reload];
+		return;
+	}
+	NSIndexSet *oldSections = _HRSTableViewSectionCoordinatorUpdatesIndexesBeforeDeletes(sections, updates.baseDeletedSections);
+	[updates.reloadedSections removeIndexes:oldSections];
+	[updates.deletedSections addIndexes:oldSections];
+}
+
+- (void)reloadSections:(NSIndexSet *)sections ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	NSParameterAssert(controller);
+	if (sections == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self _updatesOfSectionController:controller animation:animation];
+	if (updates.needsReload) {
+		return;
+	} else if (updates.hasMove || updates.baseInsertedSections.count > 0) {
+		[updates reload];
+		return;
+	}
+	// rows are only updated as long as no section was deleted, so the rows of
+	// the reloaded sections can simply be dropped
+	NSIndexSet *oldSections = _HRSTableViewSectionCoordinatorUpdatesIndexesBeforeDeletes(sections, updates.baseDeletedSections);
+	[updates dropRowsInSections:oldSections];
+	[updates.reloadedSections addIndexes:oldSections];
+}
+
+- (void)moveSection:(NSInteger)section toSection:(NSInteger)newSection ofSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self.controllerUpdates objectForKey:controller];
+	UITableViewRowAnimation animation = (updates ? updates.animation : UITableViewRowAnimationAutomatic);
+	BOOL hadUpdates = updates.hasUpdates;
+	updates = [self _updatesOfSectionController:controller animation:animation];
+	if (hadUpdates) {
+		[updates reload];
+		return;
+	}
+	updates.movesSection = YES;
+	updates.movedRow = [NSIndexPath indexPathForRow:0 inSection:section];
+	updates.movedRowDestination = [NSIndexPath indexPathForRow:0 inSection:newSection];
+}
+
+
+
+#pragma mark - rows
+
+- (void)insertRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	NSParameterAssert(controller);
+	if (indexPaths == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self _updatesOfSectionController:controller animation:animation];
+	if (updates.needsReload) {
+		return;
+	} else if (updates.hasMove || updates.hasSectionStructureUpdates) {
+		[updates reload];
+		return;
+	}
+	NSDictionary *rowsBySection = _HRSTableViewSectionCoordinatorUpdatesRowsBySection(indexPaths);
+	for (NSNumber *section in rowsBySection) {
+		if ([updates.reloadedSections containsIndex:section.unsignedIntegerValue]) {
+			continue;
+		}
+		NSMutableIndexSet *insertedRows = updates.insertedRows[section];
+		if (insertedRows == nil) {
+			insertedRows = [NSMutableIndexSet indexSet];
+			updates.insertedRows[section] = insertedRows;
+		}
+		if (updates.inBlock == NO) {
+			_HRSTableViewSectionCoordinatorUpdatesInsertIndexes(insertedRows, rowsBySection[section]);
+		} else if ([updates baseInsertedRowsInSection:section].count > 0) {
+			[updates reload];
+			return;
+		} else {
+			[insertedRows addIndexes:rowsBySection[section]];
+		}
+	}
+}
+
+- (void)deleteRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	[self _addRowsAtIndexPaths:indexPaths ofSectionController:controller withRowAnimation:animation deleting:YES];
+}
+
+- (void)reloadRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation {
+	[self _addRowsAtIndexPaths:indexPaths ofSectionController:controller withRowAnimation:animation deleting:NO];
+}
+
+/// Adds deleted or reloaded rows, both are based on the rows before the batch.
+- (void)_addRowsAtIndexPaths:(NSArray *)indexPaths ofSectionController:(id<HRSTableViewSectionController>)controller withRowAnimation:(UITableViewRowAnimation)animation deleting:(BOOL)deleting {
+	NSParameterAssert(controller);
+	if (indexPaths == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self _updatesOfSectionController:controller animation:animation];
+	if (updates.needsReload) {
+		return;
+	} else if (updates.hasMove || updates.hasSectionStructureUpdates) {
+		[updates reload];
+		return;
+	}
+	NSDictionary *rowsBySection = _HRSTableViewSectionCoordinatorUpdatesRowsBySection(indexPaths);
+	for (NSNumber *section in rowsBySection) {
+		if ([updates baseInsertedRowsInSection:section].count > 0) {
+			// the rows might have been inserted before
+			[updates reload];
+			return;
+		}
+	}
+	
+	for (NSNumber *section in rowsBySection) {
+		if ([updates.reloadedSections containsIndex:section.unsignedIntegerValue]) {
+			continue;
+		}
+		NSIndexSet *oldRows = _HRSTableViewSectionCoordinatorUpdatesIndexesBeforeDeletes(rowsBySection[section], [updates baseDeletedRowsInSection:section]);
+		NSMutableDictionary *rows = (deleting ? updates.deletedRows : updates.reloadedRows);
+		NSMutableIndexSet *sectionRows = rows[section];
+		if (sectionRows == nil) {
+			sectionRows = [NSMutableIndexSet indexSet];
+			rows[section] = sectionRows;
+		}
+		[sectionRows addIndexes:oldRows];
+		if (deleting) {
+			[updates.reloadedRows[section] removeIndexes:oldRows];
+		}
+	}
+}
+
+- (void)moveRowAtIndexPath:(NSIndexPath *)indexPath toIndexPath:(NSIndexPath *)newIndexPath ofSectionController:(id<HRSTableViewSectionController>)controller {
+	NSParameterAssert(controller);
+	if (indexPath == nil || newIndexPath == nil || controller == nil) {
+		return;
+	}
+	
+	_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self.controllerUpdates objectForKey:controller];
+	UITableViewRowAnimation animation = (updates ? updates.animation : UITableViewRowAnimationAutomatic);
+	BOOL hadUpdates = updates.hasUpdates;
+	updates = [self _updatesOfSectionController:controller animation:animation];
+	if (hadUpdates) {
+		[updates reload];
+		return;
+	}
+	updates.movesSection = NO;
+	updates.movedRow = indexPath;
+	updates.movedRowDestination = newIndexPath;
+}
+
+
+
+#pragma mark - applying
+
+- (void)applyToTableView:(UITableView *)tableView sections:(_HRSTableViewSectionCoordinatorSections *)sections {
+	// walk the controllers in the order of the table view, so that the calls do
+	// not depend on the order of the map table
+	for (id<HRSTableViewSectionController> controller in sections.sectionControllers) {
+		_HRSTableViewSectionCoordinatorControllerUpdates *updates = [self.controllerUpdates objectForKey:controller];
+		NSInteger oldIndex = [self.sections indexOfSectionController:controller];
+		NSInteger newIndex = [sections indexOfSectionController:controller];
+		if (updates == nil || oldIndex == NSNotFound) {
+			continue;
+		}
+		
+		NSInteger oldFirstSection = [self.sections firstSectionOfSectionControllerAtIndex:oldIndex];
+		NSInteger newFirstSection = [sections firstSectionOfSectionControllerAtIndex:newIndex];
+		UITableViewRowAnimation animation = updates.animation;
+		
+		if (updates.needsReload) {
+			NSRange oldRange = NSMakeRange(oldFirstSection, [self.sections numberOfSectionsOfSectionControllerAtIndex:oldIndex]);
+			NSRange newRange = NSMakeRange(newFirstSection, [sections numberOfSectionsOfSectionControllerAtIndex:newIndex]);
+			if (oldRange.length == newRange.length) {
+				[tableView reloadSections:[NSIndexSet indexSetWithIndexesInRange:oldRange] withRowAnimation:animation];
+			} else {
+				[tableView deleteSections:[NSIndexSet indexSetWithIndexesInRange:oldRange] withRowAnimation:animation];
+				[tableView insertSections:[NSIndexSet indexSetWithIndexesInRange:newRange] withRowAnimation:animation];
+			}
+			continue;
+		}
+		
+		if (updates.deletedSections.count > 0) {
+			[tableView deleteSections:_HRSTableViewSectionCoordinatorUpdatesShiftedIndexes(updates.deletedSections, oldFirstSection) withRowAnimation:animation];
+		}
+		if (updates.reloadedSections.count > 0) {
+			[tableView reloadSections:_HRSTableViewSectionCoordinatorUpdatesShiftedIndexes(updates.reloadedSections, oldFirstSection) withRowAnimation:animation];
+		}
+		if (updates.insertedSections.count > 0) {
+			[tableView insertSections:_HRSTableViewSectionCoordinatorUpdatesShiftedIndexes(updates.insertedSections, newFirstSection) withRowAnimation:animation];
+		}
+		
+		NSArray *deletedRows = _HRSTableViewSectionCoordinatorUpdatesIndexPaths(updates.deletedRows, oldFirstSection);
+		if (deletedRows.count > 0) {
+			[tableView deleteRowsAtIndexPaths:deletedRows withRowAnimation:animation];
+		}
+		NSArray *reloadedRows = _HRSTableViewSectionCoordinatorUpdatesIndexPaths(updates.reloadedRows, oldFirstSection);
+		if (reloadedRows.count > 0) {
+			[tableView reloadRowsAtIndexPaths:reloadedRows withRowAnimation:animation];
+		}
+		NSArray *insertedRows = _HRSTableViewSectionCoordinatorUpdatesIndexPaths(updates.insertedRows, newFirstSection);
+		if (insertedRows.count > 0) {
+			[tableView insertRowsAtIndexPaths:insertedRows withRowAnimation:animation];
+		}
+		
+		if (updates.movesSection) {
+			[tableView moveSection:updates.movedRow.section + oldFirstSection toSection:updates.movedRowDestination.section + newFirstSection];
+		} else if (updates.hasMove) {
+			NSIndexPath *indexPath = [NSIndexPath indexPathForRow:updates.movedRow.row inSection:updates.movedRow.section + oldFirstSection];
+			NSIndexPath *newIndexPath = [NSIndexPath indexPathForRow:updates.movedRowDestination.row inSection:updates.movedRowDestination.section + newFirstSection];
+			[tableView moveRowAtIndexPath:indexPath toIndexPath:newIndexPath];
+		}
+	}
+}
+
+@end